@@ -182,10 +182,17 @@ def _check_mutex_args(parser, args, required=False):
             ", ".join(name for name, _ in args))
 
 
+# Start of translator output files in the text and in the binary format
+# (see BINARY_SAS_MAGIC in translate/sas_tasks.py).
+SEARCH_INPUT_TEXT_START = b"begin_version"
+SEARCH_INPUT_BINARY_START = b"\0SAS"
+
+
 def _looks_like_search_input(filename):
-    with open(filename) as input_file:
-        first_line = next(input_file, "").rstrip()
-    return first_line == "begin_version"
+    with open(filename, "rb") as input_file:
+        start = input_file.read(len(SEARCH_INPUT_TEXT_START))
+    return (start == SEARCH_INPUT_TEXT_START or
+            start.startswith(SEARCH_INPUT_BINARY_START))
 
 
 def _set_components_automatically(parser, args):
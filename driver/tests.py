@@ -17,10 +17,12 @@ from . import returncodes
 from .util import REPO_ROOT_DIR, find_domain_filename
 
 
-def translate():
+def translate(translate_options=None):
     """Create translated task."""
     cmd = [sys.executable, "fast-downward.py", "--translate",
            "misc/tests/benchmarks/gripper/prob01.pddl"]
+    if translate_options:
+        cmd += ["--translate-options"] + translate_options
     subprocess.check_call(cmd, cwd=REPO_ROOT_DIR)
 
 
@@ -29,9 +31,9 @@ def cleanup():
                           cwd=REPO_ROOT_DIR)
 
 
-def run_driver(parameters):
+def run_driver(parameters, translate_options=None):
     cleanup()
-    translate()
+    translate(translate_options)
     cmd = [sys.executable, "fast-downward.py"] + parameters
     return subprocess.check_call(cmd, cwd=REPO_ROOT_DIR)
 
@@ -48,6 +50,13 @@ def test_aliases():
         run_driver(parameters)
 
 
+def test_binary_search_input():
+    run_driver(["output.sas", "--search", "astar(blind())"],
+               translate_options=["--binary-sas"])
+    with open(os.path.join(REPO_ROOT_DIR, "output.sas"), "rb") as output_file:
+        assert output_file.read(4) == b"\0SAS"
+
+
 def test_show_aliases():
     run_driver(["--show-aliases"])
 
@@ -138,6 +138,9 @@ def configs_optimal_extended():
         "astar_cegar": [
             "--search",
             "astar(cegar())"],
+        "astar_cegar_single_state": [
+            "--search",
+            "astar(cegar(max_states=1))"],
         "pdb": [
             "--search",
             "astar(pdb())"],
@@ -252,6 +255,14 @@ def configs_satisficing_extended():
             "--search",
             "iterated([lazy_wastar([h],w=10), lazy_wastar([h],w=5), lazy_wastar([h],w=3),"
             "lazy_wastar([h],w=2), lazy_wastar([h],w=1)])"],
+        "iterated_lmcount": [
+            "--evaluator",
+            "hlm=lmcount(lm_reasonable_orders_hps(lm_rhw()),pref=true)",
+            "--evaluator",
+            "hff=ff()",
+            "--search",
+            "iterated([lazy_greedy([hff,hlm],preferred=[hff,hlm]),"
+            "lazy_wastar([hff,hlm],preferred=[hff,hlm],w=5)])"],
         # pareto open list
         "pareto_ff": [
             "--evaluator",
@@ -1,4 +1,5 @@
 #include "helper_functions.h"
+#include "sas_io.h"
 #include "axiom.h"
 #include "variable.h"
 
@@ -7,21 +8,19 @@
 #include <cassert>
 using namespace std;
 
-Axiom::Axiom(istream &in, const vector<Variable *> &variables) {
-    check_magic(in, "begin_rule");
-    int count; // number of conditions
-    in >> count;
+Axiom::Axiom(SASInput &in, const vector<Variable *> &variables) {
+    in.check_magic("begin_rule");
+    int count = in.read_int(); // number of conditions
+    conditions.reserve(count);
     for (int i = 0; i < count; i++) {
-        int varNo, val;
-        in >> varNo >> val;
+        int varNo = in.read_int();
+        int val = in.read_int();
         conditions.push_back(Condition(variables[varNo], val));
     }
-    int varNo, oldVal, newVal;
-    in >> varNo >> oldVal >> newVal;
-    effect_var = variables[varNo];
-    old_val = oldVal;
-    effect_val = newVal;
-    check_magic(in, "end_rule");
+    effect_var = variables[in.read_int()];
+    old_val = in.read_int();
+    effect_val = in.read_int();
+    in.check_magic("end_rule");
 }
 
 bool Axiom::is_redundant() const {
@@ -53,14 +52,17 @@ int Axiom::get_encoding_size() const {
     return 1 + conditions.size();
 }
 
-void Axiom::generate_cpp_input(ofstream &outfile) const {
+void Axiom::generate_cpp_input(SASOutput &outfile) const {
     assert(effect_var->get_level() != -1);
-    outfile << "begin_rule" << endl;
-    outfile << conditions.size() << endl;
+    outfile.write_magic("begin_rule");
+    outfile.write_int(conditions.size());
     for (const Condition &condition : conditions) {
         assert(condition.var->get_level() != -1);
-        outfile << condition.var->get_level() << " " << condition.cond << endl;
+        outfile.write_int(condition.var->get_level(), ' ');
+        outfile.write_int(condition.cond);
     }
-    outfile << effect_var->get_level() << " " << old_val << " " << effect_val << endl;
-    outfile << "end_rule" << endl;
+    outfile.write_int(effect_var->get_level(), ' ');
+    outfile.write_int(old_val, ' ');
+    outfile.write_int(effect_val);
+    outfile.write_magic("end_rule");
 }
@@ -5,7 +5,10 @@
 //#include "utilities.h"
 
 #include <algorithm>
+#include <atomic>
+#include <bitset>
 #include <iterator>
+#include <thread>
 #include <vector>
 #include <set>
 
@@ -45,8 +48,9 @@ bool compute_h2_mutexes(const vector <Variable *> &variables,
                         vector<MutexGroup> &mutexes,
                         State &initial_state,
                         const vector<pair<Variable *, int>> &goals,
-                        int limit_seconds, bool disable_bw_h2) {
-    H2Mutexes h2(limit_seconds);
+                        int limit_seconds, bool disable_bw_h2,
+                        int num_threads) {
+    H2Mutexes h2(limit_seconds, num_threads);
 
     if (!h2.initialize(variables, mutexes)) {
         return true;
@@ -236,7 +240,7 @@ bool H2Mutexes::initialize(const vector <Variable *> &variables,
         //  cout << i << "-" << num_vals[i] << endl;
     }
     //Initialize everything to NOT_REACHED (mutexes will be set to spurious)
-    m_values.resize(number_props * number_props, NOT_REACHED);
+    m_values.resize(number_props);
 
     //Set to spurious variables with themselves
     for (int var = 0; var < num_vars; ++var) {
@@ -244,10 +248,8 @@ bool H2Mutexes::initialize(const vector <Variable *> &variables,
             int p_index_1 = p_index[var][val1];
             for (int val2 = val1 + 1; val2 < num_vals[var]; ++val2) {
                 int p_index_2 = p_index[var][val2];
-                int pos1 = position(p_index_1, p_index_2);
-                int pos2 = position(p_index_2, p_index_1);
-                m_values[pos1] = SPURIOUS;
-                m_values[pos2] = SPURIOUS;
+                m_values.set(p_index_1, p_index_2, SPURIOUS);
+                m_values.set(p_index_2, p_index_1, SPURIOUS);
             }
         }
     }
@@ -287,8 +289,8 @@ bool H2Mutexes::initialize(const vector <Variable *> &variables,
 		    //cout << "Initialize mutex: " << var1 <<"-" << val1 << " "  << variables[var1]->get_fact_name(val1) << " - " << var2<< "-" << val2 << " "  << variables[var2]->get_fact_name(val2) << endl;
 
                     // set the pairs that are mutex as spurious
-                    m_values[position(p_index[var1][val1], p_index[var2][val2])] = SPURIOUS;
-                    m_values[position(p_index[var2][val2], p_index[var1][val1])] = SPURIOUS;
+                    m_values.set(p_index[var1][val1], p_index[var2][val2], SPURIOUS);
+                    m_values.set(p_index[var2][val2], p_index[var1][val1], SPURIOUS);
                 }
             }
         }
@@ -310,14 +312,8 @@ bool H2Mutexes::init_values_progression(const vector <Variable *> &variables,
                                         const State &initial_state) {
     int countSpurious = 0, countReached = 0, countNotReached = 0;
 
-    for (unsigned i = 0; i < m_values.size(); i++) {
-        if (m_values[i] == SPURIOUS) {
-            countSpurious++;
-            continue;
-        }
-        m_values[i] = NOT_REACHED;
-        countNotReached++;
-    }
+    m_values.clear_reached();
+    m_values.count(countSpurious, countReached, countNotReached);
 
     for (unsigned i = 0; i < variables.size(); i++) {
         int var1 = variables[i]->get_level();
@@ -325,12 +321,12 @@ bool H2Mutexes::init_values_progression(const vector <Variable *> &variables,
         for (unsigned j = 0; j < variables.size(); j++) {
             int var2 = variables[j]->get_level();
             unsigned fluent2 = p_index[var2][initial_state[variables[j]]];
-            unsigned pos = position(fluent1, fluent2);
-	    if(m_values[pos] == SPURIOUS) return false;
+            Reachability value = m_values.get(fluent1, fluent2);
+	    if(value == SPURIOUS) return false;
             //This check probably is unnecessary, because the initial state should not contain anything spurious
             // (I left it just in case of unsolvable problems)
-            if (m_values[pos] == NOT_REACHED) {
-                m_values[pos] = REACHED;
+            if (value == NOT_REACHED) {
+                m_values.set(fluent1, fluent2, REACHED);
                 countReached++;
                 countNotReached--;
             }
@@ -351,8 +347,7 @@ bool H2Mutexes::check_initial_state_is_dead_end(const vector <Variable *> &varia
         for (unsigned j = 0; j < variables.size(); j++) {
             int var2 = variables[j]->get_level();
             unsigned fluent2 = p_index[var2][initial_state[variables[j]]];
-            unsigned pos = position(fluent1, fluent2);
-            if (m_values[pos] == SPURIOUS) {
+            if (m_values.get(fluent1, fluent2) == SPURIOUS) {
 		return true;
             }
         }
@@ -369,8 +364,7 @@ bool H2Mutexes::check_goal_state_is_unreachable(const vector<pair<Variable *, in
 	    int var2 = goal[g2].first->get_level();
 	    unsigned fluent2 = p_index[var2][goal[g2].second];
 
-            unsigned pos = position(fluent1, fluent2);
-            if (m_values[pos] == SPURIOUS) {
+            if (m_values.get(fluent1, fluent2) == SPURIOUS) {
 		return true;
             }
         }
@@ -385,11 +379,7 @@ bool H2Mutexes::init_values_regression(const vector<pair<Variable *, int>> &goal
 
     if(check_goal_state_is_unreachable(goal)) return false;
 
-    for (unsigned i = 0; i < m_values.size(); i++) {
-        if (m_values[i] != SPURIOUS) {
-            m_values[i] = REACHED;
-        }
-    }
+    m_values.set_non_spurious_reached();
 
     // the things that are mutex with the goal are not reached
     for (unsigned g = 0; g < goal.size(); g++) {
@@ -409,15 +399,7 @@ bool H2Mutexes::init_values_regression(const vector<pair<Variable *, int>> &goal
     }
 
     int countSpurious = 0, countReached = 0, countNotReached = 0;
-    for (unsigned i = 0; i < m_values.size(); i++) {
-        if (m_values[i] == REACHED) {
-            countReached++;
-        } else if (m_values[i] == NOT_REACHED) {
-            countNotReached++;
-        } else {
-            countSpurious++;
-        }
-    }
+    m_values.count(countSpurious, countReached, countNotReached);
 
     cout << "Initialized mvalues backward: reached=" << countReached <<
         ", notReached=" << countNotReached << ", spurious=" << countSpurious << endl;
@@ -426,19 +408,7 @@ bool H2Mutexes::init_values_regression(const vector<pair<Variable *, int>> &goal
 }
 
 void H2Mutexes::setPropositionNotReached(int prop_index) {
-    for (int var2 = 0; var2 < num_vars; var2++) {
-        for (int val2 = 0; val2 < num_vals[var2]; val2++) {
-            int p_index_2 = p_index[var2][val2];
-            int pos1 = position(prop_index, p_index_2);
-            if (m_values[pos1] == REACHED) {
-                m_values[pos1] = NOT_REACHED;
-            }
-            int pos2 = position(p_index_2, prop_index);
-            if (m_values[pos2] == REACHED) {
-                m_values[pos2] = NOT_REACHED;
-            }
-        }
-    }
+    m_values.clear_reached_pairs_with(prop_index);
 }
 
 void H2Mutexes::init_h2_operators(const vector<Operator> &operators, const vector<Axiom> &axioms, bool regression) {
@@ -474,79 +444,11 @@ int H2Mutexes::compute(const vector <Variable *> &variables,
 
     cout << "Computing mutexes..." << endl;
 
-    bool updated;
-    do {
-        // if (time_exceeded())
-        //     return TIMEOUT;
-
-        updated = false;
-        for (unsigned op_i = 0; op_i < m_ops.size(); op_i++) {
-	    if (op_i % 10000 == 0 && time_exceeded()) return TIMEOUT;
-
-            // disregard spurious operators
-            if (m_ops[op_i].triggered == SPURIOUS)
-                continue;
-
-            // if the preconditions haven't been met, continue
-            if ((m_ops[op_i].triggered != REACHED) &&
-                ((m_ops[op_i].triggered =
-                      eval_propositions(m_ops[op_i].pre)) != REACHED))
-                continue;
-
-
-            for (unsigned add_i = 0; add_i < m_ops[op_i].add.size(); add_i++) {
-                unsigned p = m_ops[op_i].add[add_i];
-                for (unsigned add_j = 0; add_j < m_ops[op_i].add.size(); add_j++) {
-                    unsigned q = m_ops[op_i].add[add_j];
-                    if (m_values[position(p, q)] == NOT_REACHED) {
-                        m_values[position(p, q)] = m_values[position(q, p)] = REACHED;
-                        updated = true;
-                    }
-                }
-
-
-                for (unsigned prop_i = 0; prop_i < number_props; prop_i++) {
-                    if (m_values[position(prop_i, prop_i)] != REACHED ||
-                        m_values[position(p, prop_i)] != NOT_REACHED)
-                        continue;
-
-                    if (binary_search(m_ops[op_i].add.begin(),
-                                      m_ops[op_i].add.end(),
-                                      prop_i) ||
-                        binary_search(m_ops[op_i].del.begin(),
-                                      m_ops[op_i].del.end(),
-                                      prop_i)) {
-                        continue;
-                    }
-
-                    bool satisfied = true;
-                    for (unsigned pre_i = 0; satisfied && pre_i < m_ops[op_i].pre.size(); pre_i++) {
-                        satisfied = (m_values[position(prop_i, m_ops[op_i].pre[pre_i])] == REACHED);
-                    }
-
-                    if (satisfied) {
-                        // pair<unsigned, unsigned> a = p_index_reverse[prop_i];
-                        // pair<unsigned, unsigned> b = p_index_reverse[p];
-                        // cout << "Action: " << g_operators[op_i].get_name() << " -> ";
-                        // cout << print_fluent(a.first,a.second) << " - " << print_fluent(b.first,b.second) << endl;
-                        m_values[position(p, prop_i)] = m_values[position(prop_i, p)] = REACHED;
-                        updated = true;
-                    }
-                }
-            }
-        }
-    } while (updated);
+    if (compute_fixpoint() == TIMEOUT)
+        return TIMEOUT;
 
     int countReached = 0, countNotReached = 0, countSpurious = 0;
-    for (unsigned i = 0; i < m_values.size(); i++) {
-        if (m_values[i] == REACHED) {
-            countReached++;
-        } else if (m_values[i] == NOT_REACHED) {
-            countNotReached++;
-        } else {
-            countSpurious++;
-        }
-    }
+    m_values.count(countSpurious, countReached, countNotReached);
     cout << "Mutex computation finished with reached=" << countReached <<
         ", notReached=" << countNotReached << ", spurious=" << countSpurious << endl;
 
@@ -563,11 +465,12 @@ int H2Mutexes::compute(const vector <Variable *> &variables,
     //Add mutexes
     unsigned count = 0;
   int countUnreachable = 0;
-    for (unsigned i = 0; i < m_values.size(); i++) {
-        if (m_values[i] == NOT_REACHED) {
-            m_values[i] = SPURIOUS;
-            pair<unsigned, unsigned> a = p_index_reverse[i / number_props];
-            pair<unsigned, unsigned> b = p_index_reverse[i % number_props];
+    for (unsigned p = 0; p < number_props; p++) {
+      for (unsigned q = 0; q < number_props; q++) {
+        if (m_values.get(p, q) == NOT_REACHED) {
+            m_values.set(p, q, SPURIOUS);
+            pair<unsigned, unsigned> a = p_index_reverse[p];
+            pair<unsigned, unsigned> b = p_index_reverse[q];
             if (a == b) {
 		if(!is_unreachable(a.first, a.second)) {
 	      countUnreachable ++;
@@ -576,8 +479,7 @@ int H2Mutexes::compute(const vector <Variable *> &variables,
 		    }
 		}
             } else {
-                if (m_values[position(p_index[a.first][a.second], p_index[a.first][a.second])] == REACHED &&
-                    m_values[position(p_index[b.first][b.second], p_index[b.first][b.second])] == REACHED) {
+                if (m_values.get(p, p) == REACHED && m_values.get(q, q) == REACHED) {
                     // cout << "Mutex: " << variables[a.first]->get_fact_name(a.second) << " and "
                     //      << variables[b.first]->get_fact_name(b.second) << endl;
                     //Only increase the mutex count when both fluents are reachable
@@ -595,6 +497,7 @@ int H2Mutexes::compute(const vector <Variable *> &variables,
                 }
             }
         }
+      }
     }
 
   //   This is not neeed anymore because we handle this in set_unreachable
@@ -614,25 +517,155 @@ int H2Mutexes::compute(const vector <Variable *> &variables,
     return count + countUnreachable;
 }
 
+void H2Mutexes::collect_new_pairs(unsigned op_i, const vector<uint64_t> &reached_diagonal,
+                                  vector<pair<unsigned, unsigned>> &new_pairs) {
+    Op_h2 &op = m_ops[op_i];
+
+    // disregard spurious operators
+    if (op.triggered == SPURIOUS)
+        return;
+
+    // if the preconditions haven't been met, continue
+    if ((op.triggered != REACHED) &&
+        ((op.triggered = eval_propositions(op.pre)) != REACHED))
+        return;
+
+    unsigned num_words = m_values.get_words_per_row();
+    for (unsigned add_i = 0; add_i < op.add.size(); add_i++) {
+        unsigned p = op.add[add_i];
+        for (unsigned add_j = 0; add_j < op.add.size(); add_j++) {
+            unsigned q = op.add[add_j];
+            if (m_values.get(p, q) == NOT_REACHED) {
+                new_pairs.push_back(make_pair(p, q));
+            }
+        }
+
+        /*
+          A proposition prop_i becomes reachable together with p if (prop_i,
+          prop_i) is reached, (p, prop_i) is not reached yet and prop_i is
+          reached together with all preconditions. Since the reached pairs
+          are symmetric, the last test is a conjunction of precondition rows.
+        */
+        const uint64_t *spurious_p = m_values.get_spurious_row(p);
+        const uint64_t *reached_p = m_values.get_reached_row(p);
+        for (unsigned word = 0; word < num_words; word++) {
+            uint64_t candidates = reached_diagonal[word] & ~spurious_p[word] & ~reached_p[word];
+            for (unsigned pre_i = 0; candidates && pre_i < op.pre.size(); pre_i++) {
+                candidates &= m_values.get_reached_row(op.pre[pre_i])[word];
+            }
+            for (unsigned prop_i = word * 64; candidates; candidates >>= 1, prop_i++) {
+                if (!(candidates & 1))
+                    continue;
+                if (binary_search(op.add.begin(), op.add.end(), prop_i) ||
+                    binary_search(op.del.begin(), op.del.end(), prop_i)) {
+                    continue;
+                }
+                new_pairs.push_back(make_pair(p, prop_i));
+            }
+        }
+    }
+}
+
+bool H2Mutexes::apply_new_pairs(const vector<pair<unsigned, unsigned>> &new_pairs,
+                                vector<uint64_t> &reached_diagonal) {
+    bool updated = false;
+    for (const pair<unsigned, unsigned> &new_pair : new_pairs) {
+        unsigned p = new_pair.first;
+        unsigned q = new_pair.second;
+        if (m_values.get(p, q) == NOT_REACHED) {
+            m_values.set(p, q, REACHED);
+            m_values.set(q, p, REACHED);
+            if (p == q) {
+                reached_diagonal[p / 64] |= uint64_t(1) << (p % 64);
+            }
+            updated = true;
+        }
+    }
+    return updated;
+}
+
+int H2Mutexes::compute_fixpoint() {
+    /*
+      Operators are processed in rounds. In each round, every thread
+      collects the pairs reached by a contiguous slice of operators based on
+      the values at the start of the round, and we apply all new pairs after
+      the threads finished. Since the fixpoint is monotone, this yields the
+      same result as updating the values after each operator, which is what
+      we do with a single thread (one operator per round).
+    */
+    const unsigned ops_per_thread = num_threads == 1 ? 1 : 1000;
+    const unsigned ops_per_round = ops_per_thread * num_threads;
+    const unsigned num_ops = m_ops.size();
+
+    vector<uint64_t> reached_diagonal;
+    m_values.get_reached_diagonal(reached_diagonal);
+    vector<vector<pair<unsigned, unsigned>>> new_pairs(num_threads);
+
+    bool updated;
+    do {
+        updated = false;
+        for (unsigned round_begin = 0; round_begin < num_ops; round_begin += ops_per_round) {
+            if (round_begin % 10000 < ops_per_round && time_exceeded())
+                return TIMEOUT;
+
+            unsigned round_end = min(num_ops, round_begin + ops_per_round);
+            auto process_slice = [&](int thread_id) {
+                    vector<pair<unsigned, unsigned>> &pairs = new_pairs[thread_id];
+                    pairs.clear();
+                    unsigned begin = round_begin + thread_id * ops_per_thread;
+                    unsigned end = min(round_end, begin + ops_per_thread);
+                    for (unsigned op_i = begin; op_i < end; op_i++) {
+                        collect_new_pairs(op_i, reached_diagonal, pairs);
+                    }
+                };
+            vector<thread> workers;
+            for (int thread_id = 1; thread_id < num_threads &&
+                 round_begin + thread_id * ops_per_thread < round_end; thread_id++) {
+                workers.push_back(thread(process_slice, thread_id));
+            }
+            process_slice(0);
+            for (thread &worker : workers) {
+                worker.join();
+            }
+            for (size_t thread_id = 0; thread_id <= workers.size(); thread_id++) {
+                updated |= apply_new_pairs(new_pairs[thread_id], reached_diagonal);
+            }
+        }
+    } while (updated);
+    return 0;
+}
+
+void H2PairTable::count(int &num_spurious, int &num_reached, int &num_not_reached) const {
+    num_spurious = 0;
+    num_reached = 0;
+    for (size_t i = 0; i < spurious.size(); i++) {
+        num_spurious += bitset<64>(spurious[i]).count();
+        num_reached += bitset<64>(reached[i]).count();
+    }
+    num_not_reached = size() - num_spurious - num_reached;
+}
+
 Reachability H2Mutexes::eval_propositions(const vector<unsigned> & props) {
     if (props.empty())
         return REACHED;
     for (unsigned i = 0; i < props.size(); i++)
         for (unsigned j = i; j < props.size(); j++)
-            if (m_values[position(props[i], props[j])] == NOT_REACHED)
+            if (m_values.get(props[i], props[j]) == NOT_REACHED)
                 return NOT_REACHED;
     return REACHED;
 }
 
 void H2Mutexes::print_mutexes(const vector <Variable *> &variables) {
     unsigned count = 0;
-    for (unsigned i = 0; i < m_values.size(); i++) {
-        if (m_values[i] == SPURIOUS) {
-            pair<unsigned, unsigned> a = p_index_reverse[i / number_props];
-            pair<unsigned, unsigned> b = p_index_reverse[i % number_props];
-            if (!are_mutex(a.first, a.second, b.first, b.second)) {
-                count++;
-                cout << variables[a.first]->get_fact_name(a.second) << " - " << variables[b.first]->get_fact_name(b.second) << endl;
+    for (unsigned p = 0; p < number_props; p++) {
+        for (unsigned q = 0; q < number_props; q++) {
+            if (m_values.get(p, q) == SPURIOUS) {
+                pair<unsigned, unsigned> a = p_index_reverse[p];
+                pair<unsigned, unsigned> b = p_index_reverse[q];
+                if (!are_mutex(a.first, a.second, b.first, b.second)) {
+                    count++;
+                    cout << variables[a.first]->get_fact_name(a.second) << " - " << variables[b.first]->get_fact_name(b.second) << endl;
+                }
             }
         }
     }
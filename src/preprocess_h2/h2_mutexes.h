@@ -4,6 +4,7 @@
 #define H2_MUTEXES_H
 
 #include <ctime>
+#include <cstdint>
 #include <iostream>
 #include <algorithm>
 #include <string>
@@ -23,6 +24,120 @@ enum Reachability {SPURIOUS, REACHED, NOT_REACHED};
 static const int UNSOLVABLE = -2;
 static const int  TIMEOUT = -1;
 
+/*
+  Reachability values of all ordered pairs of propositions. Instead of one
+  Reachability entry per pair we store two bit matrices, "spurious" and
+  "reached" (pairs with neither bit set are NOT_REACHED). Each matrix row is
+  a contiguous sequence of 64-bit words, which lets the h^2 fixpoint handle
+  64 candidate partners of a proposition at once.
+
+  We keep the full square matrix rather than a triangular one since all
+  updates are symmetric anyway and full rows keep the word-wise operations
+  simple. Compared to one unsigned per pair this needs 16 times less memory.
+*/
+class H2PairTable {
+    unsigned num_props;
+    unsigned words_per_row;
+    vector<uint64_t> spurious;
+    vector<uint64_t> reached;
+
+    static inline uint64_t bit(unsigned q) {
+        return uint64_t(1) << (q % 64);
+    }
+
+    inline size_t word_index(unsigned p, unsigned q) const {
+        return static_cast<size_t>(p) * words_per_row + q / 64;
+    }
+
+public:
+    H2PairTable() : num_props(0), words_per_row(0) {}
+
+    // Resize to num_props x num_props pairs, all NOT_REACHED.
+    void resize(unsigned num_props_) {
+        num_props = num_props_;
+        words_per_row = (num_props + 63) / 64;
+        size_t num_words = static_cast<size_t>(num_props) * words_per_row;
+        spurious.assign(num_words, 0);
+        reached.assign(num_words, 0);
+    }
+
+    inline Reachability get(unsigned p, unsigned q) const {
+        size_t index = word_index(p, q);
+        if (spurious[index] & bit(q))
+            return SPURIOUS;
+        if (reached[index] & bit(q))
+            return REACHED;
+        return NOT_REACHED;
+    }
+
+    inline void set(unsigned p, unsigned q, Reachability value) {
+        size_t index = word_index(p, q);
+        spurious[index] &= ~bit(q);
+        reached[index] &= ~bit(q);
+        if (value == SPURIOUS)
+            spurious[index] |= bit(q);
+        else if (value == REACHED)
+            reached[index] |= bit(q);
+    }
+
+    inline unsigned get_words_per_row() const {
+        return words_per_row;
+    }
+
+    inline const uint64_t *get_spurious_row(unsigned p) const {
+        return &spurious[static_cast<size_t>(p) * words_per_row];
+    }
+
+    inline const uint64_t *get_reached_row(unsigned p) const {
+        return &reached[static_cast<size_t>(p) * words_per_row];
+    }
+
+    // Mask of the bits in the given word of a row that belong to propositions.
+    inline uint64_t get_valid_mask(unsigned word) const {
+        unsigned num_bits = num_props - word * 64;
+        return num_bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << num_bits) - 1;
+    }
+
+    // Set all REACHED pairs to NOT_REACHED.
+    void clear_reached() {
+        fill(reached.begin(), reached.end(), 0);
+    }
+
+    // Set all non-SPURIOUS pairs to REACHED.
+    void set_non_spurious_reached() {
+        for (unsigned p = 0; p < num_props; ++p) {
+            size_t row = static_cast<size_t>(p) * words_per_row;
+            for (unsigned w = 0; w < words_per_row; ++w) {
+                reached[row + w] = ~spurious[row + w] & get_valid_mask(w);
+            }
+        }
+    }
+
+    // Set all REACHED pairs involving p to NOT_REACHED.
+    void clear_reached_pairs_with(unsigned p) {
+        fill(reached.begin() + static_cast<size_t>(p) * words_per_row,
+             reached.begin() + static_cast<size_t>(p + 1) * words_per_row, 0);
+        for (unsigned q = 0; q < num_props; ++q) {
+            reached[word_index(q, p)] &= ~bit(p);
+        }
+    }
+
+    // Bitset of all propositions p whose pair (p, p) is REACHED.
+    void get_reached_diagonal(vector<uint64_t> &diagonal) const {
+        diagonal.assign(words_per_row, 0);
+        for (unsigned p = 0; p < num_props; ++p) {
+            if (reached[word_index(p, p)] & bit(p))
+                diagonal[p / 64] |= bit(p);
+        }
+    }
+
+    void count(int &num_spurious, int &num_reached, int &num_not_reached) const;
+
+    size_t size() const {
+        return static_cast<size_t>(num_props) * num_props;
+    }
+};
+
 class Op_h2 {
 public:
     Op_h2(const Operator &op,
@@ -61,7 +176,8 @@ class H2Mutexes {
 
     bool check_goal_state_is_unreachable(const vector<pair<Variable *, int>> &goal) const;
 public:
-    H2Mutexes(int t = -1) : limit_seconds(t) {
+    H2Mutexes(int t = -1, int threads = 1)
+        : num_threads(max(1, threads)), limit_seconds(t) {
         if (limit_seconds != -1)
             time(&start);
     }
@@ -85,7 +201,32 @@ public:
             return val1 != val2;  //TODO: || unreachable[var1][val1];
         unsigned p1 = p_index[var1][val1];
         unsigned p2 = p_index[var2][val2];
-        return m_values[position(p1, p2)] == SPURIOUS;
+        return m_values.get(p1, p2) == SPURIOUS;
+    }
+
+    /*
+      Fact masks contain one bit per proposition. They let callers test a
+      fact against many others at once: after calling add_mutexes_to_mask
+      for a set of facts, test_mask(var, val, mask) is true iff (var, val)
+      is mutex with one of them (like are_mutex, assuming that var is not
+      the variable of any fact in the set).
+    */
+    inline vector<uint64_t> create_fact_mask() const {
+        return vector<uint64_t>(m_values.get_words_per_row(), 0);
+    }
+
+    inline void add_mutexes_to_mask(int var, int val, vector<uint64_t> &mask) const {
+        if (val == -1)
+            return;
+        const uint64_t *row = m_values.get_spurious_row(p_index[var][val]);
+        for (size_t word = 0; word < mask.size(); ++word) {
+            mask[word] |= row[word];
+        }
+    }
+
+    inline bool test_mask(int var, int val, const vector<uint64_t> &mask) const {
+        unsigned p = p_index[var][val];
+        return (mask[p / 64] >> (p % 64)) & 1;
     }
 
     inline int num_variables() const {
@@ -112,6 +253,7 @@ public:
                     const vector<MutexGroup> &mutexes);
 
 protected:
+    int num_threads;
     int num_vars;
     std::vector<int> num_vals;
 
@@ -120,7 +262,7 @@ protected:
     std::vector<std::vector<std::set<std::pair<int, int>>>> inconsistent_facts;
 
     unsigned number_props;
-    vector<unsigned> m_values;
+    H2PairTable m_values;
     vector<Op_h2> m_ops;
 
     vector< vector<unsigned>> p_index;
@@ -128,10 +270,6 @@ protected:
 
     Reachability eval_propositions(const vector<unsigned> & props);
 
-    inline unsigned position(unsigned a, unsigned b) const {
-        return (a * number_props) + b;
-    }
-
     bool set_unreachable(int var, int val, const vector <Variable *> &variables, 
 			 const State &initial_state, 
 			 const vector<pair<Variable *, int>> &goal); 
@@ -149,6 +287,19 @@ protected:
                            const vector<Axiom> &axioms, bool regression);
 
     void setPropositionNotReached(int prop_index);
+
+    /*
+      Collect the pairs (p, q) that operator op_i newly reaches, given the
+      bitset of propositions q for which (q, q) is reached. The operator's
+      "triggered" status is updated as a side effect.
+    */
+    void collect_new_pairs(unsigned op_i, const vector<uint64_t> &reached_diagonal,
+                           vector<pair<unsigned, unsigned>> &new_pairs);
+    // Mark the given pairs as reached. Return true iff any of them was new.
+    bool apply_new_pairs(const vector<pair<unsigned, unsigned>> &new_pairs,
+                         vector<uint64_t> &reached_diagonal);
+    // Returns TIMEOUT if the time limit was exceeded and 0 otherwise.
+    int compute_fixpoint();
 };
 
 //Computes h2 mutexes, and removes every unnecessary variables, operators, axioms, initial state and goal.
@@ -158,7 +309,8 @@ extern bool compute_h2_mutexes(const vector <Variable *> &variables,
                                vector<MutexGroup> &mutexes,
                                State &initial_state,
                                const vector<pair<Variable *, int>> &goal,
-                               int limit_seconds, bool disable_bw_h2);
+                               int limit_seconds, bool disable_bw_h2,
+                               int num_threads = 1);
 
 
 
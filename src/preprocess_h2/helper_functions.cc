@@ -7,6 +7,7 @@
 #include <fstream>
 
 #include "helper_functions.h"
+#include "sas_io.h"
 #include "state.h"
 #include "mutex_group.h"
 #include "operator.h"
@@ -19,26 +20,10 @@ static const int SAS_FILE_VERSION = 3;
 static const int PRE_FILE_VERSION = SAS_FILE_VERSION;
 
 
-void check_magic(istream &in, string magic) {
-    string word;
-    in >> word;
-    if (word != magic) {
-        cerr << "Failed to match magic word '" << magic << "'." << endl;
-        cerr << "Got '" << word << "'." << endl;
-        if (magic == "begin_version") {
-            cerr << "Possible cause: you are running the preprocessor "
-                 << "on a translator file from an " << endl
-                 << "older version." << endl;
-        }
-        exit(1);
-    }
-}
-
-void read_and_verify_version(istream &in) {
-    int version;
-    check_magic(in, "begin_version");
-    in >> version;
-    check_magic(in, "end_version");
+void read_and_verify_version(SASInput &in) {
+    in.check_magic("begin_version");
+    int version = in.read_int();
+    in.check_magic("end_version");
     if (version != SAS_FILE_VERSION) {
         cerr << "Expected translator file version " << SAS_FILE_VERSION
              << ", got " << version << "." << endl;
@@ -47,16 +32,15 @@ void read_and_verify_version(istream &in) {
     }
 }
 
-void read_metric(istream &in, bool &metric) {
-    check_magic(in, "begin_metric");
-    in >> metric;
-    check_magic(in, "end_metric");
+void read_metric(SASInput &in, bool &metric) {
+    in.check_magic("begin_metric");
+    metric = in.read_int();
+    in.check_magic("end_metric");
 }
 
-void read_variables(istream &in, vector<Variable> &internal_variables,
+void read_variables(SASInput &in, vector<Variable> &internal_variables,
                     vector<Variable *> &variables) {
-    int count;
-    in >> count;
+    int count = in.read_int();
     internal_variables.reserve(count);
     // Important so that the iterators stored in variables are valid.
     for (int i = 0; i < count; i++) {
@@ -65,25 +49,24 @@ void read_variables(istream &in, vector<Variable> &internal_variables,
     }
 }
 
-void read_mutexes(istream &in, vector<MutexGroup> &mutexes,
+void read_mutexes(SASInput &in, vector<MutexGroup> &mutexes,
                   const vector<Variable *> &variables) {
-    size_t count;
-    in >> count;
-    for (size_t i = 0; i < count; ++i)
+    int count = in.read_int();
+    mutexes.reserve(count);
+    for (int i = 0; i < count; ++i)
         mutexes.push_back(MutexGroup(in, variables));
 }
 
-void read_goal(istream &in, const vector<Variable *> &variables,
+void read_goal(SASInput &in, const vector<Variable *> &variables,
                vector<pair<Variable *, int>> &goals) {
-    check_magic(in, "begin_goal");
-    int count;
-    in >> count;
+    in.check_magic("begin_goal");
+    int count = in.read_int();
     for (int i = 0; i < count; i++) {
-        int varNo, val;
-        in >> varNo >> val;
+        int varNo = in.read_int();
+        int val = in.read_int();
         goals.push_back(make_pair(variables[varNo], val));
     }
-    check_magic(in, "end_goal");
+    in.check_magic("end_goal");
 }
 
 void dump_goal(const vector<pair<Variable *, int>> &goals) {
@@ -93,23 +76,24 @@ void dump_goal(const vector<pair<Variable *, int>> &goals) {
              << goal.second << endl;
 }
 
-void read_operators(istream &in, const vector<Variable *> &variables,
+void read_operators(SASInput &in, const vector<Variable *> &variables,
                     vector<Operator> &operators) {
-    int count;
-    in >> count;
+    int count = in.read_int();
+    // Reserve memory up front to avoid copying all operators when growing.
+    operators.reserve(count);
     for (int i = 0; i < count; i++)
         operators.push_back(Operator(in, variables));
 }
 
-void read_axioms(istream &in, const vector<Variable *> &variables,
+void read_axioms(SASInput &in, const vector<Variable *> &variables,
                  vector<Axiom> &axioms) {
-    int count;
-    in >> count;
+    int count = in.read_int();
+    axioms.reserve(count);
     for (int i = 0; i < count; i++)
         axioms.push_back(Axiom(in, variables));
 }
 
-void read_preprocessed_problem_description(istream &in,
+void read_preprocessed_problem_description(SASInput &in,
                                            bool &metric,
                                            vector<Variable> &internal_variables,
                                            vector<Variable *> &variables,
@@ -153,31 +137,33 @@ void generate_cpp_input(const vector<Variable *> &ordered_vars,
                         const State &initial_state,
                         const vector<pair<Variable *, int>> &goals,
                         const vector<Operator> &operators,
-                        const vector<Axiom> &axioms) {
-    ofstream outfile;
-    outfile.open("output.sas", ios::out);
+                        const vector<Axiom> &axioms,
+                        bool binary) {
+    ofstream stream;
+    stream.open("output.sas", binary ? ios::out | ios::binary : ios::out);
+    SASOutput outfile(stream, binary);
 
-    outfile << "begin_version" << endl;
-    outfile << PRE_FILE_VERSION << endl;
-    outfile << "end_version" << endl;
+    outfile.write_magic("begin_version");
+    outfile.write_int(PRE_FILE_VERSION);
+    outfile.write_magic("end_version");
 
-    outfile << "begin_metric" << endl;
-    outfile << metric << endl;
-    outfile << "end_metric" << endl;
+    outfile.write_magic("begin_metric");
+    outfile.write_int(metric);
+    outfile.write_magic("end_metric");
 
     int num_vars = ordered_vars.size();
-    outfile << num_vars << endl;
+    outfile.write_int(num_vars);
     for (Variable *var : ordered_vars)
         var->generate_cpp_input(outfile);
 
-    outfile << mutexes.size() << endl;
+    outfile.write_int(mutexes.size());
     for (const MutexGroup &mutex : mutexes)
         mutex.generate_cpp_input(outfile);
 
-    outfile << "begin_state" << endl;
+    outfile.write_magic("begin_state");
     for (Variable *var : ordered_vars)
-        outfile << initial_state[var] << endl;  // for axioms default value
-    outfile << "end_state" << endl;
+        outfile.write_int(initial_state[var]);  // for axioms default value
+    outfile.write_magic("end_state");
 
     vector<int> ordered_goal_values;
     ordered_goal_values.resize(num_vars, -1);
@@ -185,53 +171,67 @@ void generate_cpp_input(const vector<Variable *> &ordered_vars,
         int var_index = goal.first->get_level();
         ordered_goal_values[var_index] = goal.second;
     }
-    outfile << "begin_goal" << endl;
-    outfile << goals.size() << endl;
-    for (int i = 0; i < num_vars; i++)
-        if (ordered_goal_values[i] != -1)
-            outfile << i << " " << ordered_goal_values[i] << endl;
-    outfile << "end_goal" << endl;
-
-    outfile << operators.size() << endl;
+    outfile.write_magic("begin_goal");
+    outfile.write_int(goals.size());
+    for (int i = 0; i < num_vars; i++) {
+        if (ordered_goal_values[i] != -1) {
+            outfile.write_int(i, ' ');
+            outfile.write_int(ordered_goal_values[i]);
+        }
+    }
+    outfile.write_magic("end_goal");
+
+    outfile.write_int(operators.size());
     for (const Operator &op : operators)
         op.generate_cpp_input(outfile);
 
-    outfile << axioms.size() << endl;
+    outfile.write_int(axioms.size());
     for (const Axiom &axiom : axioms)
         axiom.generate_cpp_input(outfile);
 
-    outfile.close();
+    stream.close();
 }
-void generate_unsolvable_cpp_input() {
-    ofstream outfile;
-    outfile.open("output.sas", ios::out);
-    outfile << "begin_version" << endl;
-    outfile << PRE_FILE_VERSION << endl;
-    outfile << "end_version" << endl;
 
-    outfile << "begin_metric" << endl << "1" << endl << "end_metric" << endl;
+void generate_unsolvable_cpp_input(bool binary) {
+    ofstream stream;
+    stream.open("output.sas", binary ? ios::out | ios::binary : ios::out);
+    SASOutput outfile(stream, binary);
+    outfile.write_magic("begin_version");
+    outfile.write_int(PRE_FILE_VERSION);
+    outfile.write_magic("end_version");
+
+    outfile.write_magic("begin_metric");
+    outfile.write_int(1);
+    outfile.write_magic("end_metric");
 
     //variables
-    outfile << "1" << endl << "begin_variable" << endl
-            << "var0" << endl
-            << "-1" << endl
-            << "2" << endl
-            << "Atom dummy(val1)" << endl
-            << "Atom dummy(val2)" << endl
-            << "end_variable" << endl;
+    outfile.write_int(1);
+    outfile.write_magic("begin_variable");
+    outfile.write_line("var0");
+    outfile.write_int(-1);
+    outfile.write_int(2);
+    outfile.write_line("Atom dummy(val1)");
+    outfile.write_line("Atom dummy(val2)");
+    outfile.write_magic("end_variable");
 
     //Mutexes
-    outfile << "0" << endl;
+    outfile.write_int(0);
 
     //Initial state and goal
-    outfile << "begin_state" << endl << "0" << endl << "end_state" << endl;
-    outfile << "begin_goal" << endl << "1" << endl << "0 1" << endl << "end_goal" << endl;
+    outfile.write_magic("begin_state");
+    outfile.write_int(0);
+    outfile.write_magic("end_state");
+    outfile.write_magic("begin_goal");
+    outfile.write_int(1);
+    outfile.write_int(0, ' ');
+    outfile.write_int(1);
+    outfile.write_magic("end_goal");
 
     //Operators
-    outfile << "0" << endl;
+    outfile.write_int(0);
 
     //Axioms
-    outfile << "0" << endl;
+    outfile.write_int(0);
 
-    outfile.close();
+    stream.close();
 }
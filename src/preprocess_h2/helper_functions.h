@@ -10,13 +10,14 @@
 
 using namespace std;
 
+class SASInput;
 class State;
 class MutexGroup;
 class Operator;
 class Axiom;
 
 //void read_everything
-void read_preprocessed_problem_description(istream & in,
+void read_preprocessed_problem_description(SASInput &in,
                                            bool &metric,
                                            vector<Variable> &internal_variables,
                                            vector<Variable *> &variables,
@@ -33,14 +34,15 @@ void dump_preprocessed_problem_description(const vector<Variable *> &variables,
                                            const vector<Operator> &operators,
                                            const vector<Axiom> &axioms);
 
-void generate_unsolvable_cpp_input();
+// Write output.sas in the binary format (see sas_io.h) or the textual format.
+void generate_unsolvable_cpp_input(bool binary);
 void generate_cpp_input(const vector<Variable *> &ordered_var,
                         const bool &metric,
                         const vector<MutexGroup> &mutexes,
                         const State &initial_state,
                         const vector<pair<Variable *, int>> &goals,
                         const vector<Operator> &operators,
-                        const vector<Axiom> &axioms);
-void check_magic(istream & in, string magic);
+                        const vector<Axiom> &axioms,
+                        bool binary);
 
 #endif
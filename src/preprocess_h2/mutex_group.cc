@@ -1,22 +1,23 @@
 #include "mutex_group.h"
 
 #include "helper_functions.h"
+#include "sas_io.h"
 #include "variable.h"
 
 #include <fstream>
 #include <iostream>
 
-MutexGroup::MutexGroup(istream &in, const vector<Variable *> &variables) : dir(FW) {
+MutexGroup::MutexGroup(SASInput &in, const vector<Variable *> &variables) : dir(FW) {
     //Mutex groups detected in the translator are "fw" mutexes
-    int size;
-    check_magic(in, "begin_mutex_group");
-    in >> size;
+    in.check_magic("begin_mutex_group");
+    int size = in.read_int();
+    facts.reserve(size);
     for (int i = 0; i < size; ++i) {
-        int var_no, value;
-        in >> var_no >> value;
+        int var_no = in.read_int();
+        int value = in.read_int();
         facts.push_back(make_pair(variables[var_no], value));
     }
-    check_magic(in, "end_mutex_group");
+    in.check_magic("end_mutex_group");
 }
 MutexGroup::MutexGroup(const vector<pair<int, int>> &f,
                        const vector<Variable *> &variables,
@@ -53,14 +54,14 @@ void MutexGroup::dump() const {
     }
 }
 
-void MutexGroup::generate_cpp_input(ofstream &outfile) const {
-    outfile << "begin_mutex_group" << endl
-            << facts.size() << endl;
+void MutexGroup::generate_cpp_input(SASOutput &outfile) const {
+    outfile.write_magic("begin_mutex_group");
+    outfile.write_int(facts.size());
     for (const auto &fact : facts) {
-        outfile << fact.first->get_level()
-                << " " << fact.second << endl;
+        outfile.write_int(fact.first->get_level(), ' ');
+        outfile.write_int(fact.second);
     }
-    outfile << "end_mutex_group" << endl;
+    outfile.write_magic("end_mutex_group");
 }
 
 void MutexGroup::strip_unimportant_facts() {
@@ -7,6 +7,8 @@
 #include "state.h"
 using namespace std;
 
+class SASInput;
+class SASOutput;
 class Variable;
 
 enum Dir {FW, BW};
@@ -18,7 +20,7 @@ class MutexGroup {
     Dir dir;
     vector<pair<const Variable *, int>> facts;
 public:
-    MutexGroup(istream &in, const vector<Variable *> &variables);
+    MutexGroup(SASInput &in, const vector<Variable *> &variables);
 
     MutexGroup(const vector<pair<int, int>> &f,
                const vector<Variable *> &variables,
@@ -35,7 +37,7 @@ public:
     int num_facts() const {
         return facts.size();
     }
-    void generate_cpp_input(ofstream &outfile) const;
+    void generate_cpp_input(SASOutput &outfile) const;
     void dump() const;
     void get_mutex_group(vector<pair<int, int>> &invariant_group) const;
 
@@ -1,4 +1,5 @@
 #include "helper_functions.h"
+#include "sas_io.h"
 #include "operator.h"
 #include "variable.h"
 
@@ -8,36 +9,36 @@
 #include <fstream>
 using namespace std;
 
-Operator::Operator(istream &in, const vector<Variable *> &variables) : spurious(false) {
-    check_magic(in, "begin_operator");
-    in >> ws;
-    getline(in, name);
-    int count; // number of prevail conditions
-    in >> count;
+Operator::Operator(SASInput &in, const vector<Variable *> &variables) : spurious(false) {
+    in.check_magic("begin_operator");
+    name = in.read_line();
+    int count = in.read_int(); // number of prevail conditions
+    prevail.reserve(count);
     for (int i = 0; i < count; i++) {
-        int varNo, val;
-        in >> varNo >> val;
+        int varNo = in.read_int();
+        int val = in.read_int();
         prevail.push_back(Prevail(variables[varNo], val));
     }
-    in >> count; // number of pre_post conditions
+    count = in.read_int(); // number of pre_post conditions
+    pre_post.reserve(count);
     for (int i = 0; i < count; i++) {
-        int eff_conds;
+        int eff_conds = in.read_int();
         vector<EffCond> ecs;
-        in >> eff_conds;
         for (int j = 0; j < eff_conds; j++) {
-            int var, value;
-            in >> var >> value;
+            int var = in.read_int();
+            int value = in.read_int();
             ecs.push_back(EffCond(variables[var], value));
         }
-        int varNo, val, newVal;
-        in >> varNo >> val >> newVal;
+        int varNo = in.read_int();
+        int val = in.read_int();
+        int newVal = in.read_int();
         if (eff_conds)
             pre_post.push_back(PrePost(variables[varNo], ecs, val, newVal));
         else
             pre_post.push_back(PrePost(variables[varNo], val, newVal));
     }
-    in >> cost;
-    check_magic(in, "end_operator");
+    cost = in.read_int();
+    in.check_magic("end_operator");
     // TODO: Evtl. effektiver: conditions schon sortiert einlesen?
 }
 
@@ -96,31 +97,34 @@ void strip_operators(vector<Operator> &operators) {
     cout << operators.size() << " of " << old_count << " operators necessary." << endl;
 }
 
-void Operator::generate_cpp_input(ofstream &outfile) const {
+void Operator::generate_cpp_input(SASOutput &outfile) const {
     //TODO: beim Einlesen in search feststellen, ob leerer Operator
-    outfile << "begin_operator" << endl;
-    outfile << name << endl;
+    outfile.write_magic("begin_operator");
+    outfile.write_line(name);
 
-    outfile << prevail.size() << endl;
+    outfile.write_int(prevail.size());
     for (const auto &prev : prevail) {
         assert(prev.var->get_level() != -1);
-        if (prev.var->get_level() != -1)
-            outfile << prev.var->get_level() << " " << prev.prev << endl;
+        if (prev.var->get_level() != -1) {
+            outfile.write_int(prev.var->get_level(), ' ');
+            outfile.write_int(prev.prev);
+        }
     }
 
-    outfile << pre_post.size() << endl;
+    outfile.write_int(pre_post.size());
     for (const auto &eff : pre_post) {
         assert(eff.var->get_level() != -1);
-        outfile << eff.effect_conds.size();
-        for (const auto &cond : eff.effect_conds)
-            outfile << " " << cond.var->get_level()
-                    << " " << cond.cond;
-        outfile << " " << eff.var->get_level()
-                << " " << eff.pre
-                << " " << eff.post << endl;
+        outfile.write_int(eff.effect_conds.size(), ' ');
+        for (const auto &cond : eff.effect_conds) {
+            outfile.write_int(cond.var->get_level(), ' ');
+            outfile.write_int(cond.cond, ' ');
+        }
+        outfile.write_int(eff.var->get_level(), ' ');
+        outfile.write_int(eff.pre, ' ');
+        outfile.write_int(eff.post);
     }
-    outfile << cost << endl;
-    outfile << "end_operator" << endl;
+    outfile.write_int(cost);
+    outfile.write_magic("end_operator");
 }
 
 // Removes ambiguity in the preconditions,
@@ -163,77 +167,81 @@ void Operator::remove_ambiguity(const H2Mutexes &h2) {
     }
 
     // check that no precondition is unreachable or mutex with some other precondition
+    vector<int> precondition_vars;
     for (size_t i = 0; i < preconditions.size(); i++) {
         if (preconditions[i] != -1) {
-            if (h2.is_unreachable(i, preconditions[i])) {
+            precondition_vars.push_back(i);
+        }
+    }
+    for (size_t i = 0; i < precondition_vars.size(); i++) {
+        int var1 = precondition_vars[i];
+        if (h2.is_unreachable(var1, preconditions[var1])) {
+            spurious = true;
+            return;
+        }
+        for (size_t j = i + 1; j < precondition_vars.size(); j++) {
+            int var2 = precondition_vars[j];
+            if (h2.are_mutex(var1, preconditions[var1], var2, preconditions[var2])) {
                 spurious = true;
                 return;
             }
-            for (size_t j = i + 1; j < preconditions.size(); j++) {
-                if (h2.are_mutex(i, preconditions[i], j, preconditions[j])) {
-                    spurious = true;
-                    return;
-                }
-            }
         }
     }
 
-    std::list<std::pair<unsigned, std::list<unsigned>>> candidates;
+    // facts mutex with some effect
+    vector<uint64_t> effects_mutexes = h2.create_fact_mask();
+    for (const pair<int, int> &effect : effects) {
+        h2.add_mutexes_to_mask(effect.first, effect.second, effects_mutexes);
+    }
+
+    /*
+      Variables with unknown preconditions. In each round, all values of
+      these variables are tested against the newly known values, so we only
+      need to store the variables, not the remaining candidate values.
+    */
+    vector<int> candidate_vars;
     for (int i = 0; i < h2.num_variables(); i++) {
         // consider unknown preconditions only
-        if (preconditions[i] != -1)
-            continue;
-
-        pair<unsigned, list<unsigned>> candidate_var = make_pair(i, list<unsigned>());
-        // add every reachable fluent
-        for (int j = 0; j < h2.num_values(i); j++)
-            candidate_var.second.push_back(j);
-
-        candidates.push_back(candidate_var);
+        if (preconditions[i] == -1)
+            candidate_vars.push_back(i);
     }
 
     // actual disambiguation process
     while (!known_values.empty()) {
         vector<pair<int, int>> aux_values;
+        // facts mutex with some known value (the variables of known values are no candidates)
+        vector<uint64_t> known_mutexes = h2.create_fact_mask();
+        for (const pair<int, int> &known_value : known_values) {
+            h2.add_mutexes_to_mask(known_value.first, known_value.second, known_mutexes);
+        }
         // for each unknown variable
-        for (list<pair<unsigned, list<unsigned>>>::iterator it = candidates.begin(); it != candidates.end();) {
-            unsigned var = it->first;
-            list<unsigned> candidate_var = it->second;
-            // cout << var << " -> " << candidate_var.size() << endl;
-
-            // we eliminate candidates mutex with other things
-            for (list<unsigned>::iterator it2 = candidate_var.begin(); it2 != candidate_var.end();) {
-                bool mutex = h2.is_unreachable(var, *it2);
-                for (size_t k = 0; !mutex && k < known_values.size(); k++)
-                    mutex = h2.are_mutex(known_values[k].first, known_values[k].second, var, *it2);
-
-                if (!effect_var[var]) {
-                    for (size_t k = 0; !mutex && k < effects.size(); k++)
-                        mutex = h2.are_mutex(effects[k].first, effects[k].second, var, *it2);
-                }
-
-
-
-                if (mutex) {
-                    it2 = candidate_var.erase(it2);
-                } else {
-                    ++it2;
+        vector<int> remaining_candidate_vars;
+        for (int var : candidate_vars) {
+            // we eliminate candidates mutex with other things (stop after two candidates)
+            int num_candidates = 0;
+            int candidate = -1;
+            for (int val = 0; num_candidates < 2 && val < h2.num_values(var); val++) {
+                bool mutex = h2.is_unreachable(var, val) ||
+                    h2.test_mask(var, val, known_mutexes) ||
+                    (!effect_var[var] && h2.test_mask(var, val, effects_mutexes));
+                if (!mutex) {
+                    num_candidates++;
+                    candidate = val;
                 }
             }
 
             // we check the remaining candidates
-            if (candidate_var.empty()) { // if no fluent is possible for a given variable, the operator is spurious
+            if (num_candidates == 0) { // if no fluent is possible for a given variable, the operator is spurious
                 spurious = true;
                 return;
-            } else if (candidate_var.size() == 1) { // add the single possible fluent to preconditions and aux_values and remove the variables from candidate
-                pair<int, int> new_fluent = make_pair(var, candidate_var.front());
-                aux_values.push_back(new_fluent);
-                preconditions[new_fluent.first] = new_fluent.second;
-                it = candidates.erase(it);
+            } else if (num_candidates == 1) { // add the single possible fluent to preconditions and aux_values and remove the variables from candidate
+                aux_values.push_back(make_pair(var, candidate));
+                preconditions[var] = candidate;
             } else {
-                ++it;
+                remaining_candidate_vars.push_back(var);
             }
         }
+        candidate_vars.swap(remaining_candidate_vars);
 
         known_values.swap(aux_values);
     }
@@ -248,6 +256,10 @@ void Operator::remove_ambiguity(const H2Mutexes &h2) {
     // important for backwards h^2
     // note: they may overlap with augmented preconditions
     potential_preconditions.clear();
+    vector<uint64_t> precondition_mutexes = h2.create_fact_mask();
+    for (size_t k = 0; k < preconditions.size(); k++) {
+        h2.add_mutexes_to_mask(k, preconditions[k], precondition_mutexes);
+    }
     for (size_t i = 0; i < pre_post.size(); i++) {
         // for each undefined precondition
         if (pre_post[i].pre != -1)
@@ -260,13 +272,9 @@ void Operator::remove_ambiguity(const H2Mutexes &h2) {
         }
 
         // for each fluent
+        // the precondition of var is undefined, so var is no precondition variable
         for (int j = 0; j < h2.num_values(var); j++) {
-            bool conflict = false;
-            for (size_t k = 0; !conflict && k < preconditions.size(); k++)
-                if (preconditions[k] != -1)
-                    conflict = h2.are_mutex(var, j, k, preconditions[k]);
-
-            if (!conflict)
+            if (!h2.test_mask(var, j, precondition_mutexes))
                 potential_preconditions.push_back(make_pair(var, j));
         }
     }
@@ -12,15 +12,21 @@
 #include "operator.h"
 #include "axiom.h"
 #include "h2_mutexes.h"
+#include "sas_io.h"
 #include "variable.h"
 #include <iostream>
 using namespace std;
 
 int main(int argc, const char **argv) {
+    // We only use C++ streams, so decouple them from C stdio for faster I/O.
+    ios::sync_with_stdio(false);
+
     int h2_mutex_time = 300; // 5 minutes to compute mutexes by default
+    int h2_threads = 1;
     bool include_augmented_preconditions = false;
     bool expensive_statistics = false;
     bool disable_bw_h2 = false;
+    bool binary_output = false;
 
     bool metric;
     vector<Variable *> variables;
@@ -49,23 +55,36 @@ int main(int argc, const char **argv) {
                 cerr << "please specify the number of seconds after --h2_time_limit" << endl;
                 exit(2);
             }
+        } else if (arg.compare("--h2_threads") == 0) {
+            i++;
+            if (i < argc && atoi(argv[i]) > 0) {
+                h2_threads = atoi(argv[i]);
+            } else {
+                cerr << "please specify a positive number of threads after --h2_threads" << endl;
+                exit(2);
+            }
         } else if (arg.compare("--no_h2") == 0) {
             h2_mutex_time = 0;
         } else if (arg.compare("--augmented_pre") == 0) {
             include_augmented_preconditions = true;
         } else if (arg.compare("--no_bw_h2") == 0) {
             disable_bw_h2 = true;
+        } else if (arg.compare("--binary_output") == 0) {
+            binary_output = true;
         } else if (arg.compare("--stat") == 0) {
             expensive_statistics = true;
         } else {
             cerr << "unknown option " << arg << endl << endl;
-            cout << "Usage: ./preprocess [--no_rel] [--no_h2]  [--no_bw_h2] [--augmented_pre] [--stat] < output" << endl;
+            cout << "Usage: ./preprocess [--no_rel] [--no_h2]  [--no_bw_h2] [--h2_time_limit SECONDS] [--h2_threads N] [--augmented_pre] [--binary_output] [--stat] < output" << endl;
             exit(2);
         }
     }
 
+    // The output uses the binary format if the input does (see sas_io.h).
+    SASInput input(cin);
+    binary_output |= input.is_binary();
     read_preprocessed_problem_description
-        (cin, metric, internal_variables, variables, mutexes, initial_state, goals, operators, axioms);
+        (input, metric, internal_variables, variables, mutexes, initial_state, goals, operators, axioms);
     //dump_preprocessed_problem_description
     //  (variables, initial_state, goals, operators, axioms);
 
@@ -95,10 +114,10 @@ int main(int argc, const char **argv) {
 
         if (!compute_h2_mutexes(ordering, operators, axioms,
                                 mutexes, initial_state, goals,
-                                h2_mutex_time, disable_bw_h2)) {
+                                h2_mutex_time, disable_bw_h2, h2_threads)) {
             // TODO: don't duplicate the code to return an unsolvable task, log and exit here
             cout << "Unsolvable task in preprocessor" << endl;
-            generate_unsolvable_cpp_input();
+            generate_unsolvable_cpp_input(binary_output);
             cout << "done" << endl;
             return 0;
         }
@@ -135,7 +154,7 @@ int main(int argc, const char **argv) {
         if (initial_state.remove_unreachable_facts()) {
             // TODO: don't duplicate the code to return an unsolvable task, log and exit here
             cout << "Unsolvable task in preprocessor" << endl;
-            generate_unsolvable_cpp_input();
+            generate_unsolvable_cpp_input(binary_output);
             cout << "done" << endl;
             return 0;
         }
@@ -240,10 +259,11 @@ int main(int argc, const char **argv) {
     cout << "Writing output..." << endl;
     if (ordering.empty()) {
         cout << "Unsolvable task in preprocessor" << endl;
-        generate_unsolvable_cpp_input();
+        generate_unsolvable_cpp_input(binary_output);
     } else {
         generate_cpp_input(
-            ordering, metric, mutexes, initial_state, goals, operators, axioms);
+            ordering, metric, mutexes, initial_state, goals, operators, axioms,
+            binary_output);
     }
     cout << "done" << endl;
 }
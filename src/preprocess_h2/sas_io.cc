@@ -0,0 +1,126 @@
+#include "sas_io.h"
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+const char BINARY_SAS_MAGIC[4] = {'\0', 'S', 'A', 'S'};
+
+SASInput::SASInput(istream &in)
+    : in(in),
+      binary(in.peek() == BINARY_SAS_MAGIC[0]) {
+    if (binary) {
+        char magic[sizeof(BINARY_SAS_MAGIC)];
+        in.read(magic, sizeof(magic));
+        if (!in || memcmp(magic, BINARY_SAS_MAGIC, sizeof(magic)) != 0) {
+            cerr << "Failed to read binary translator file header." << endl;
+            exit(1);
+        }
+    }
+}
+
+int SASInput::read_varint() {
+    unsigned int value = 0;
+    int shift = 0;
+    while (true) {
+        int byte = in.get();
+        if (byte == EOF || shift > 28) {
+            cerr << "Unexpected end of binary translator file." << endl;
+            exit(1);
+        }
+        value |= static_cast<unsigned int>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            break;
+        shift += 7;
+    }
+    // Undo the zigzag encoding.
+    return static_cast<int>(value >> 1) ^ -static_cast<int>(value & 1);
+}
+
+void SASInput::check_magic(const string &magic) {
+    if (binary)
+        return;
+    string word;
+    in >> word;
+    if (word != magic) {
+        cerr << "Failed to match magic word '" << magic << "'." << endl;
+        cerr << "Got '" << word << "'." << endl;
+        if (magic == "begin_version") {
+            cerr << "Possible cause: you are running the preprocessor "
+                 << "on a translator file from an " << endl
+                 << "older version." << endl;
+        }
+        exit(1);
+    }
+}
+
+int SASInput::read_int() {
+    if (binary)
+        return read_varint();
+    int value;
+    in >> value;
+    return value;
+}
+
+string SASInput::read_word() {
+    if (binary)
+        return read_line();
+    string word;
+    in >> word;
+    return word;
+}
+
+string SASInput::read_line() {
+    string line;
+    if (binary) {
+        int length = read_varint();
+        line.resize(length);
+        if (length > 0)
+            in.read(&line[0], length);
+    } else {
+        in >> ws;
+        getline(in, line);
+    }
+    return line;
+}
+
+
+SASOutput::SASOutput(ostream &out, bool binary)
+    : out(out),
+      binary(binary) {
+    if (binary)
+        out.write(BINARY_SAS_MAGIC, sizeof(BINARY_SAS_MAGIC));
+}
+
+void SASOutput::write_varint(int value) {
+    // Zigzag encoding maps small negative numbers to small codes.
+    unsigned int code = (static_cast<unsigned int>(value) << 1) ^
+        static_cast<unsigned int>(value >> 31);
+    while (code >= 0x80) {
+        out.put(static_cast<char>((code & 0x7f) | 0x80));
+        code >>= 7;
+    }
+    out.put(static_cast<char>(code));
+}
+
+void SASOutput::write_magic(const string &magic) {
+    if (!binary)
+        out << magic << '\n';
+}
+
+void SASOutput::write_int(int value, char separator) {
+    if (binary)
+        write_varint(value);
+    else
+        out << value << separator;
+}
+
+void SASOutput::write_line(const string &line) {
+    if (binary) {
+        write_varint(line.size());
+        out.write(line.data(), line.size());
+    } else {
+        out << line << '\n';
+    }
+}
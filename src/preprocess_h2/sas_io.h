@@ -0,0 +1,57 @@
+#ifndef SAS_IO_H
+#define SAS_IO_H
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+/*
+  Reading and writing of translator files in the textual format or in the
+  equivalent binary format. A binary file starts with the four bytes
+  BINARY_SAS_MAGIC. After that, it contains the same sequence of values as
+  the textual format (starting with the file version), except that the
+  magic words (begin_version, begin_variable, ...) are omitted. Integers are
+  stored as zigzag-encoded base-128 varints and strings (names of
+  variables, facts and operators) as their length followed by the
+  characters. The translator writes this format with --binary-sas.
+*/
+extern const char BINARY_SAS_MAGIC[4];
+
+class SASInput {
+    istream &in;
+    bool binary;
+
+    int read_varint();
+public:
+    // Detects the format of the input from its first byte.
+    explicit SASInput(istream &in);
+
+    bool is_binary() const {
+        return binary;
+    }
+
+    void check_magic(const string &magic);
+    int read_int();
+    // Read a whitespace-free word.
+    string read_word();
+    // Read the rest of the line (skipping leading whitespace).
+    string read_line();
+};
+
+class SASOutput {
+    ostream &out;
+    bool binary;
+
+    void write_varint(int value);
+public:
+    // Writes the binary header if binary is true.
+    SASOutput(ostream &out, bool binary);
+
+    void write_magic(const string &magic);
+    // In the textual format, the value is followed by the given separator.
+    void write_int(int value, char separator = '\n');
+    void write_line(const string &line);
+};
+
+#endif
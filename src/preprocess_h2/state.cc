@@ -1,16 +1,15 @@
 #include "state.h"
 #include "helper_functions.h"
+#include "sas_io.h"
 
 class Variable;
 
-State::State(istream &in, const vector<Variable *> &variables) {
-    check_magic(in, "begin_state");
+State::State(SASInput &in, const vector<Variable *> &variables) {
+    in.check_magic("begin_state");
     for (Variable *var : variables) {
-        int value;
-        in >> value; //for axioms, this is default value
-        values[var] = value;
+        values[var] = in.read_int(); //for axioms, this is default value
     }
-    check_magic(in, "end_state");
+    in.check_magic("end_state");
 }
 
 int State::operator[](Variable *var) const {
@@ -6,13 +6,14 @@
 #include <vector>
 using namespace std;
 
+class SASInput;
 class Variable;
 
 class State {
     map<Variable *, int> values;
 public:
     State() {} // TODO: Entfernen (erfordert kleines Redesign)
-    State(istream &in, const vector<Variable *> &variables);
+    State(SASInput &in, const vector<Variable *> &variables);
 
     int operator[](Variable *var) const;
     void dump() const;
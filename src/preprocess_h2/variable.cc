@@ -1,6 +1,7 @@
 #include "variable.h"
 
 #include "helper_functions.h"
+#include "sas_io.h"
 
 #include <cassert>
 #include <fstream>
@@ -8,14 +9,15 @@
 
 using namespace std;
 
-Variable::Variable(istream &in) {
-    int range;
-    check_magic(in, "begin_variable");
-    in >> ws >> name >> layer >> range >> ws;
+Variable::Variable(SASInput &in) {
+    in.check_magic("begin_variable");
+    name = in.read_word();
+    layer = in.read_int();
+    int range = in.read_int();
     values.resize(range);
     for (int i = 0; i < range; ++i)
-        getline(in, values[i]);
-    check_magic(in, "end_variable");
+        values[i] = in.read_line();
+    in.check_magic("end_variable");
     level = -1;
     necessary = false;
     reachable_values = range;
@@ -60,15 +62,15 @@ void Variable::dump() const {
     cout << "]" << endl;
 }
 
-void Variable::generate_cpp_input(ofstream &outfile) const {
-    outfile << "begin_variable" << endl
-            << name << endl
-            << layer << endl
-            << reachable_values << endl;
+void Variable::generate_cpp_input(SASOutput &outfile) const {
+    outfile.write_magic("begin_variable");
+    outfile.write_line(name);
+    outfile.write_int(layer);
+    outfile.write_int(reachable_values);
     for (size_t i = 0; i < values.size(); ++i)
         if (reachable[i])
-            outfile << values[i] << endl;
-    outfile << "end_variable" << endl;
+            outfile.write_line(values[i]);
+    outfile.write_magic("end_variable");
 }
 
 void Variable::remove_unreachable_facts() {
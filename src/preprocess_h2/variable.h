@@ -5,6 +5,9 @@
 #include <vector>
 using namespace std;
 
+class SASInput;
+class SASOutput;
+
 class Variable {
     vector<string> values;
     string name;
@@ -14,7 +17,7 @@ class Variable {
     vector<bool> reachable; //atorralba: added to prune unreachable values
     int reachable_values;
 public:
-    Variable(istream &in);
+    Variable(SASInput &in);
     void set_level(int level);
     void set_necessary();
     void reset_necessary(){necessary= false;}
@@ -24,7 +27,7 @@ public:
     string get_name() const;
     int get_layer() const {return layer; }
     bool is_derived() const {return layer != -1; }
-    void generate_cpp_input(ofstream &outfile) const;
+    void generate_cpp_input(SASOutput &outfile) const;
     void dump() const;
 
     string get_fact_name(int value) const {
@@ -116,8 +116,11 @@ fast_downward_plugin(
         utils/markup
         utils/math
         utils/memory
+        utils/parallel
+        utils/profiling
         utils/rng
         utils/rng_options
+        utils/segment_allocator
         utils/strings
         utils/system
         utils/system_unix
@@ -182,6 +185,14 @@ fast_downward_plugin(
         open_lists/type_based_best_first_open_list
 )
 
+fast_downward_plugin(
+    NAME COMPACT_INT_TABLE
+    HELP "Integer table stored with the narrowest sufficient integer width"
+    SOURCES
+        algorithms/compact_int_table
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME DYNAMIC_BITSET
     HELP "Poor man's version of boost::dynamic_bitset"
@@ -404,23 +415,49 @@ fast_downward_plugin(
     HELP "Breadth-first search"
     SOURCES
         search_engines/breadth_first_search
+        search_engines/parallel_breadth_first_search
     DEPENDS SEARCH_COMMON NULL_PRUNING_METHOD
 )
 
+fast_downward_plugin(
+    NAME EXTERNAL_BREADTH_FIRST_SEARCH
+    HELP "External-memory breadth-first search"
+    SOURCES
+        search_engines/external_breadth_first_search
+    DEPENDS SUCCESSOR_GENERATOR
+)
+
 fast_downward_plugin(
     NAME EAGER_SEARCH
     HELP "Eager search algorithm"
     SOURCES
         search_engines/eager_search
-    DEPENDS NULL_PRUNING_METHOD ORDERED_SET SUCCESSOR_GENERATOR
+    DEPENDS INCREMENTAL_SUCCESSOR_GENERATOR NULL_PRUNING_METHOD ORDERED_SET SUCCESSOR_GENERATOR
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME EVALUATOR_BENCHMARK
+    HELP "Benchmark evaluators on states recorded with random walks"
+    SOURCES
+        search_engines/evaluator_benchmark
+    DEPENDS SAMPLING SUCCESSOR_GENERATOR
+)
+
+fast_downward_plugin(
+    NAME SUCCESSOR_GENERATOR_BENCHMARK
+    HELP "Benchmark the successor generator on states recorded with random walks"
+    SOURCES
+        search_engines/successor_generator_benchmark
+    DEPENDS SAMPLING SUCCESSOR_GENERATOR
+)
+
 fast_downward_plugin(
     NAME EXHAUSTIVE_SEARCH
     HELP "Exhaustive search"
     SOURCES
         search_engines/exhaustive_search
+        search_engines/state_space_dump
     DEPENDS SEARCH_COMMON NULL_PRUNING_METHOD
 )
 
@@ -437,6 +474,7 @@ fast_downward_plugin(
     HELP "IDA* search"
     SOURCES
         search_engines/idastar_search
+    DEPENDS INCREMENTAL_SUCCESSOR_GENERATOR
 )
 
 fast_downward_plugin(
@@ -529,7 +567,7 @@ fast_downward_plugin(
     HELP "Lazy search algorithm"
     SOURCES
         search_engines/lazy_search
-    DEPENDS ORDERED_SET SUCCESSOR_GENERATOR
+    DEPENDS INCREMENTAL_SUCCESSOR_GENERATOR ORDERED_SET SUCCESSOR_GENERATOR
     DEPENDENCY_ONLY
 )
 
@@ -696,8 +734,9 @@ fast_downward_plugin(
     NAME INCREMENTAL_SUCCESSOR_GENERATOR
     HELP "Incremental successor generator"
     SOURCES
+        task_utils/applicable_operators_cache
         task_utils/incremental_successor_generator
-    DEPENDS TASK_PROPERTIES
+    DEPENDS SUCCESSOR_GENERATOR TASK_PROPERTIES
     DEPENDENCY_ONLY
 )
 
@@ -738,7 +777,7 @@ fast_downward_plugin(
         cegar/types
         cegar/utils
         cegar/utils_landmarks
-    DEPENDS ADDITIVE_HEURISTIC DYNAMIC_BITSET EXTRA_TASKS LANDMARKS PRIORITY_QUEUES TASK_PROPERTIES
+    DEPENDS ADDITIVE_HEURISTIC EXTRA_TASKS LANDMARKS PRIORITY_QUEUES TASK_PROPERTIES
 )
 
 fast_downward_plugin(
@@ -774,7 +813,7 @@ fast_downward_plugin(
         cost_saturation/unsolvability_heuristic
         cost_saturation/utils
         cost_saturation/zero_one_cost_partitioning_heuristic
-    DEPENDS CEGAR LP_SOLVER PDBS PARTIAL_STATE_TREE PRIORITY_QUEUES SAMPLING TASK_PROPERTIES
+    DEPENDS CEGAR COMPACT_INT_TABLE LP_SOLVER PDBS PARTIAL_STATE_TREE PRIORITY_QUEUES SAMPLING TASK_PROPERTIES
 )
 
 fast_downward_plugin(
@@ -896,7 +935,7 @@ fast_downward_plugin(
         pdbs/validation
         pdbs/zero_one_pdbs
         pdbs/zero_one_pdbs_heuristic
-    DEPENDS CAUSAL_GRAPH MAX_CLIQUES PRIORITY_QUEUES SAMPLING SUCCESSOR_GENERATOR TASK_PROPERTIES VARIABLE_ORDER_FINDER
+    DEPENDS CAUSAL_GRAPH COMPACT_INT_TABLE MAX_CLIQUES PRIORITY_QUEUES SAMPLING SUCCESSOR_GENERATOR TASK_PROPERTIES VARIABLE_ORDER_FINDER
 )
 
 fast_downward_plugin(
@@ -0,0 +1,84 @@
+#include "compact_int_table.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace compact_int_table {
+CompactIntTable::CompactIntTable()
+    : bytes_per_value(4),
+      num_values(0) {
+}
+
+CompactIntTable::CompactIntTable(
+    const vector<int> &values, double max_escaped_fraction)
+    : bytes_per_value(4),
+      num_values(values.size()) {
+    bool has_negative_value = any_of(
+        values.begin(), values.end(), [](int value) {return value < 0;});
+    if (has_negative_value) {
+        values32 = values;
+        return;
+    }
+    double max_escaped_values = max_escaped_fraction * num_values;
+    if (count_escaped_values<uint8_t>(values) <= max_escaped_values) {
+        bytes_per_value = 1;
+        encode(values, values8);
+    } else if (count_escaped_values<uint16_t>(values) <= max_escaped_values) {
+        bytes_per_value = 2;
+        encode(values, values16);
+    } else {
+        values32 = values;
+    }
+}
+
+template<typename T>
+int CompactIntTable::count_escaped_values(const vector<int> &values) {
+    return count_if(
+        values.begin(), values.end(), [](int value) {
+            return value != INF && value >= escape_code<T>();
+        });
+}
+
+template<typename T>
+void CompactIntTable::encode(const vector<int> &values, vector<T> &codes) {
+    codes.reserve(num_values);
+    for (int index = 0; index < num_values; ++index) {
+        int value = values[index];
+        if (value == INF) {
+            codes.push_back(infinity_code<T>());
+        } else if (value >= escape_code<T>()) {
+            codes.push_back(escape_code<T>());
+            escaped_values.emplace_back(index, value);
+        } else {
+            codes.push_back(value);
+        }
+    }
+    escaped_values.shrink_to_fit();
+}
+
+int CompactIntTable::lookup_escaped(int index) const {
+    auto it = lower_bound(
+        escaped_values.begin(), escaped_values.end(), make_pair(index, 0));
+    assert(it != escaped_values.end() && it->first == index);
+    return it->second;
+}
+
+vector<int> CompactIntTable::to_vector() const {
+    if (bytes_per_value == 4) {
+        return values32;
+    }
+    vector<int> values;
+    values.reserve(num_values);
+    for (int index = 0; index < num_values; ++index) {
+        values.push_back((*this)[index]);
+    }
+    return values;
+}
+
+size_t CompactIntTable::estimate_memory_in_bytes() const {
+    return sizeof(CompactIntTable) +
+           static_cast<size_t>(num_values) * bytes_per_value +
+           escaped_values.capacity() * sizeof(pair<int, int>);
+}
+}
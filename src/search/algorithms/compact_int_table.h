@@ -0,0 +1,107 @@
+#ifndef ALGORITHMS_COMPACT_INT_TABLE_H
+#define ALGORITHMS_COMPACT_INT_TABLE_H
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/*
+  Store a table of integers (usually goal distances) using the narrowest
+  unsigned integer type (8, 16 or 32 bits) that is sufficient for almost all
+  entries.
+
+  Infinity (numeric_limits<int>::max()) is encoded by the largest value of
+  the chosen type. The second largest value marks an "escaped" entry whose
+  actual value is too large for the chosen type and is stored in a sorted
+  side table instead. A narrow type is only chosen if at most a given
+  fraction of all entries needs to be escaped. Tables with negative entries
+  always use 32 bits.
+
+  Lookups for non-escaped entries only need a single load from a contiguous
+  array of the chosen width.
+*/
+namespace compact_int_table {
+class CompactIntTable {
+    static const int INF = std::numeric_limits<int>::max();
+
+    std::vector<std::uint8_t> values8;
+    std::vector<std::uint16_t> values16;
+    std::vector<int> values32;
+    // 1, 2 or 4.
+    int bytes_per_value;
+    int num_values;
+    // Pairs (index, value) for escaped entries, sorted by index.
+    std::vector<std::pair<int, int>> escaped_values;
+
+    template<typename T>
+    static int infinity_code() {
+        return std::numeric_limits<T>::max();
+    }
+
+    template<typename T>
+    static int escape_code() {
+        return std::numeric_limits<T>::max() - 1;
+    }
+
+    template<typename T>
+    static int count_escaped_values(const std::vector<int> &values);
+
+    template<typename T>
+    void encode(const std::vector<int> &values, std::vector<T> &codes);
+
+    int lookup_escaped(int index) const;
+
+    template<typename T>
+    int lookup(const std::vector<T> &codes, int index) const {
+        assert(index >= 0 && index < num_values);
+        int code = codes[index];
+        if (code < escape_code<T>()) {
+            return code;
+        } else if (code == infinity_code<T>()) {
+            return INF;
+        } else {
+            return lookup_escaped(index);
+        }
+    }
+
+public:
+    CompactIntTable();
+    /*
+      Choose the narrowest type for which at most
+      max_escaped_fraction * values.size() entries must be escaped.
+    */
+    explicit CompactIntTable(
+        const std::vector<int> &values, double max_escaped_fraction = 0.001);
+
+    int operator[](int index) const {
+        if (bytes_per_value == 1) {
+            return lookup(values8, index);
+        } else if (bytes_per_value == 2) {
+            return lookup(values16, index);
+        } else {
+            assert(index >= 0 && index < num_values);
+            return values32[index];
+        }
+    }
+
+    int size() const {
+        return num_values;
+    }
+
+    int get_bytes_per_value() const {
+        return bytes_per_value;
+    }
+
+    int get_num_escaped_values() const {
+        return escaped_values.size();
+    }
+
+    std::vector<int> to_vector() const;
+
+    std::size_t estimate_memory_in_bytes() const;
+};
+}
+
+#endif
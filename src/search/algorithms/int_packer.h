@@ -39,9 +39,22 @@ public:
     explicit IntPacker(const std::vector<int> &ranges);
     ~IntPacker();
 
+    /*
+      Position of a variable in the packed buffer. Its value is
+      (buffer[bin_index] & read_mask) >> shift. This lets hot loops
+      read packed values without a call per access.
+    */
+    struct VariableLocation {
+        int bin_index;
+        int shift;
+        Bin read_mask;
+    };
+
     int get(const Bin *buffer, int var) const;
     void set(Bin *buffer, int var, int value) const;
 
+    VariableLocation get_location(int var) const;
+
     int get_num_bins() const {return num_bins;}
 };
 }
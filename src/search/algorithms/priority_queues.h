@@ -7,6 +7,7 @@
 #include <cassert>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <queue>
 #include <utility>
 #include <vector>
@@ -25,7 +26,10 @@
   currently not necessary, and by not deriving we can save virtual
   function calls and do some additional inlining. The class has the
   same interface as AbstractQueue, however, to facilitate swapping the
-  different implementations in and out.
+  different implementations in and out. For the same reason,
+  AdaptiveQueue stores its BucketQueue by value: as long as all keys are
+  small (e.g., for unit-cost or small integer costs), no virtual calls
+  are made at all.
  */
 namespace priority_queues {
 template<typename Value>
@@ -68,7 +72,7 @@ public:
 
 
 template<typename Value>
-class HeapQueue : public AbstractQueue<Value> {
+class HeapQueue final : public AbstractQueue<Value> {
     typedef typename AbstractQueue<Value>::Entry Entry;
 
     bool is_valid_key(int key) const {
@@ -133,7 +137,7 @@ public:
 
 
 template<typename Value>
-class BucketQueue : public AbstractQueue<Value> {
+class BucketQueue final : public AbstractQueue<Value> {
     static const int MIN_BUCKETS_BEFORE_SWITCH = 100;
     static const bool DEBUG = false;
 
@@ -243,43 +247,48 @@ public:
 
 template<typename Value>
 class AdaptiveQueue {
-    AbstractQueue<Value> *wrapped_queue;
+    BucketQueue<Value> bucket_queue;
+    // Set once the bucket-based queue has been converted.
+    std::unique_ptr<HeapQueue<Value>> heap_queue;
     // Forbid assigning or copying -- would need to implement them properly.
     AdaptiveQueue &operator=(const AdaptiveQueue<Value> &);
     AdaptiveQueue(const AdaptiveQueue<Value> &);
 public:
     typedef std::pair<int, Value> Entry;
 
-    AdaptiveQueue() : wrapped_queue(new BucketQueue<Value>) {
-    }
-
-    ~AdaptiveQueue() {
-        delete wrapped_queue;
+    AdaptiveQueue() {
     }
 
     void push(int key, const Value &value) {
-        AbstractQueue<Value> *q = wrapped_queue->convert_if_necessary(key);
-        if (q != wrapped_queue) {
-            delete wrapped_queue;
-            wrapped_queue = q;
+        if (!heap_queue) {
+            AbstractQueue<Value> *q = bucket_queue.convert_if_necessary(key);
+            if (q == &bucket_queue) {
+                bucket_queue.push(key, value);
+                return;
+            }
+            heap_queue.reset(static_cast<HeapQueue<Value> *>(q));
         }
-        wrapped_queue->push(key, value);
+        heap_queue->push(key, value);
     }
 
     Entry pop() {
-        return wrapped_queue->pop();
+        return heap_queue ? heap_queue->pop() : bucket_queue.pop();
     }
 
     bool empty() const {
-        return wrapped_queue->empty();
+        return heap_queue ? heap_queue->empty() : bucket_queue.empty();
     }
 
     void clear() {
-        wrapped_queue->clear();
+        if (heap_queue)
+            heap_queue->clear();
+        else
+            bucket_queue.clear();
     }
 
     void add_virtual_pushes(int num_extra_pushes) {
-        wrapped_queue->add_virtual_pushes(num_extra_pushes);
+        if (!heap_queue)
+            bucket_queue.add_virtual_pushes(num_extra_pushes);
     }
 };
 }
@@ -1,6 +1,8 @@
 #ifndef ALGORITHMS_SEGMENTED_VECTOR_H
 #define ALGORITHMS_SEGMENTED_VECTOR_H
 
+#include "../utils/segment_allocator.h"
+
 #include <algorithm>
 #include <cassert>
 #include <iostream>
@@ -35,6 +37,11 @@
   storing many fixed-size arrays. It's essentially a variant of SegmentedVector
   where the size of the stored data is only known at runtime, not at compile
   time. Note that we do not support 0-length arrays (checked with an assertion).
+
+  By default, both classes obtain their segments from the default
+  utils::SegmentMemory at the time of their construction (see
+  utils/segment_allocator.h), which can place them in large memory-mapped
+  chunks backed by huge pages.
 */
 
 // TODO: Get rid of the code duplication here. How to do it without
@@ -44,7 +51,7 @@
 // states see the file state_registry.h.
 
 namespace segmented_vector {
-template<class Entry, class Allocator = std::allocator<Entry>>
+template<class Entry, class Allocator = utils::SegmentAllocator<Entry>>
 class SegmentedVector {
     typedef typename Allocator::template rebind<Entry>::other EntryAllocator;
     // TODO: Try to find a good value for SEGMENT_BYTES.
@@ -146,7 +153,7 @@ public:
 };
 
 
-template<class Element, class Allocator = std::allocator<Element>>
+template<class Element, class Allocator = utils::SegmentAllocator<Element>>
 class SegmentedArrayVector {
     typedef typename Allocator::template rebind<Element>::other ElementAllocator;
     // TODO: Try to find a good value for SEGMENT_BYTES.
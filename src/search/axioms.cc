@@ -6,7 +6,7 @@
 #include <algorithm>
 #include <cassert>
 #include <iostream>
-#include <unordered_map>
+#include <map>
 #include <vector>
 
 using namespace std;
@@ -17,145 +17,251 @@ AxiomEvaluator::AxiomEvaluator(const TaskProxy &task_proxy) {
         VariablesProxy variables = task_proxy.get_variables();
         AxiomsProxy axioms = task_proxy.get_axioms();
 
-        // Initialize literals
-        for (VariableProxy var : variables)
-            axiom_literals.emplace_back(var.get_domain_size());
+        // Initialize facts and variables
+        int num_facts = 0;
+        int num_layers = 0;
+        default_values.reserve(variables.size());
+        for (VariableProxy var : variables) {
+            fact_offsets.push_back(num_facts);
+            num_facts += var.get_domain_size();
+            variable_of_fact.insert(
+                variable_of_fact.end(), var.get_domain_size(), var.get_id());
+            if (var.is_derived()) {
+                derived_variables.push_back(var.get_id());
+                default_values.push_back(var.get_default_axiom_value());
+                num_layers = max(num_layers, var.get_axiom_layer() + 1);
+            } else {
+                primary_variables.push_back(var.get_id());
+                default_values.push_back(-1);
+            }
+        }
+        fact_offsets.push_back(num_facts);
+        facts.resize((num_facts + 63) / 64);
+        is_deleted.resize(num_facts, false);
+        same_layer_dependents.resize(num_facts);
+        dependents.resize(num_facts);
+        rules_by_effect.resize(num_facts);
+        affected_rules_by_layer.resize(num_layers);
 
-        // Initialize rules
-        // Since we are skipping some axioms, we cannot access them through
-        // their id position directly.
-        vector<int> axiom_id_to_position(axioms.size(), -1);
+        // Sort rules by layer.
+        vector<vector<int>> axioms_by_layer(num_layers);
         for (OperatorProxy axiom : axioms) {
             assert(axiom.get_effects().size() == 1);
-            EffectProxy cond_effect = axiom.get_effects()[0];
-            FactPair effect = cond_effect.get_fact().get_pair();
-            int num_conditions = cond_effect.get_conditions().size();
+            FactPair effect = axiom.get_effects()[0].get_fact().get_pair();
             // Ignore axioms which set the variable to its default value.
-            if (effect.value != variables[effect.var].get_default_axiom_value()) {
-                AxiomLiteral *eff_literal = &axiom_literals[effect.var][effect.value];
-                axiom_id_to_position[axiom.get_id()] = rules.size();
-                rules.emplace_back(
-                    num_conditions, effect.var, effect.value, eff_literal);
+            if (effect.value != default_values[effect.var]) {
+                int layer = variables[effect.var].get_axiom_layer();
+                axioms_by_layer[layer].push_back(axiom.get_id());
             }
         }
 
-        // Cross-reference rules and literals
-        for (OperatorProxy axiom : axioms) {
-            // Ignore axioms which set the variable to its default value.
-            int position = axiom_id_to_position[axiom.get_id()];
-            if (position != -1) {
-                EffectProxy effect = axiom.get_effects()[0];
+        // Compile conditions into masks
+        layer_begin.push_back(0);
+        for (int layer = 0; layer < num_layers; ++layer) {
+            for (int axiom_id : axioms_by_layer[layer]) {
+                EffectProxy effect = axioms[axiom_id].get_effects()[0];
+                int rule_id = rules.size();
+                map<int, pair<uint64_t, uint64_t>> masks_by_word;
                 for (FactProxy condition : effect.get_conditions()) {
-                    int var_id = condition.get_variable().get_id();
-                    int val = condition.get_value();
-                    AxiomRule *rule = &rules[position];
-                    axiom_literals[var_id][val].condition_of.push_back(rule);
+                    FactPair fact = condition.get_pair();
+                    int offset = fact_offsets[fact.var];
+                    int default_value = default_values[fact.var];
+                    int fact_layer = -1;
+                    if (default_value != -1) {
+                        fact_layer = variables[fact.var].get_axiom_layer();
+                    }
+                    vector<int> condition_facts;
+                    bool negated = (fact.value == default_value);
+                    if (negated) {
+                        // Negation by failure: no other value is derived.
+                        int domain_size = fact_offsets[fact.var + 1] - offset;
+                        for (int value = 0; value < domain_size; ++value) {
+                            if (value != default_value)
+                                condition_facts.push_back(offset + value);
+                        }
+                    } else {
+                        condition_facts.push_back(offset + fact.value);
+                    }
+                    for (int condition_fact : condition_facts) {
+                        pair<uint64_t, uint64_t> &masks =
+                            masks_by_word[condition_fact / 64];
+                        uint64_t bit = uint64_t(1) << (condition_fact % 64);
+                        if (negated)
+                            masks.second |= bit;
+                        else
+                            masks.first |= bit;
+                        if (fact_layer == layer && !negated) {
+                            same_layer_dependents[condition_fact].push_back(rule_id);
+                        } else if (fact_layer < layer) {
+                            dependents[condition_fact].push_back(rule_id);
+                        }
+                    }
                 }
+                AxiomRule rule;
+                rule.conditions_begin = conditions.size();
+                for (const auto &entry : masks_by_word) {
+                    ConditionWord word;
+                    word.word = entry.first;
+                    word.positive = entry.second.first;
+                    word.negative = entry.second.second;
+                    conditions.push_back(word);
+                }
+                rule.conditions_end = conditions.size();
+                FactPair effect_fact = effect.get_fact().get_pair();
+                rule.effect_fact = fact_offsets[effect_fact.var] + effect_fact.value;
+                rule.layer = layer;
+                rules.push_back(rule);
+                rules_by_effect[rule.effect_fact].push_back(rule_id);
             }
+            layer_begin.push_back(rules.size());
         }
+    }
+}
 
-        // Initialize negation-by-failure information
-        int last_layer = -1;
-        for (VariableProxy var : variables) {
-            if (var.is_derived()) {
-                last_layer = max(last_layer, var.get_axiom_layer());
-            }
+void AxiomEvaluator::fire(int rule_id) {
+    const AxiomRule &rule = rules[rule_id];
+    if (!is_set(rule.effect_fact) && is_applicable(rule)) {
+        set(rule.effect_fact);
+        queue.push_back(rule.effect_fact);
+    }
+}
+
+void AxiomEvaluator::propagate_derived_facts(size_t queue_start) {
+    for (size_t i = queue_start; i < queue.size(); ++i) {
+        for (int rule_id : same_layer_dependents[queue[i]]) {
+            fire(rule_id);
         }
-        nbf_info_by_layer.resize(last_layer + 1);
+    }
+}
 
-        for (VariableProxy var : variables) {
-            if (var.is_derived()) {
-                int layer = var.get_axiom_layer();
-                if (layer != last_layer) {
-                    int var_id = var.get_id();
-                    int nbf_value = var.get_default_axiom_value();
-                    AxiomLiteral *nbf_literal = &axiom_literals[var_id][nbf_value];
-                    nbf_info_by_layer[layer].emplace_back(var_id, nbf_literal);
-                }
+void AxiomEvaluator::delete_fact(int fact) {
+    /*
+      Delete the fact and all facts of the same layer that might depend
+      on it. They are re-derived later if they are still supported.
+    */
+    size_t start = deleted_facts.size();
+    clear(fact);
+    is_deleted[fact] = true;
+    deleted_facts.push_back(fact);
+    for (size_t i = start; i < deleted_facts.size(); ++i) {
+        for (int rule_id : same_layer_dependents[deleted_facts[i]]) {
+            int effect_fact = rules[rule_id].effect_fact;
+            if (is_set(effect_fact)) {
+                clear(effect_fact);
+                is_deleted[effect_fact] = true;
+                deleted_facts.push_back(effect_fact);
             }
         }
+    }
+}
 
-        default_values.reserve(variables.size());
-        for (VariableProxy var : variables) {
-            if (var.is_derived())
-                default_values.emplace_back(var.get_default_axiom_value());
-            else
-                default_values.emplace_back(-1);
-        }
+void AxiomEvaluator::mark_affected_rules(int fact) {
+    for (int rule_id : dependents[fact]) {
+        affected_rules_by_layer[rules[rule_id].layer].push_back(rule_id);
     }
 }
 
+int AxiomEvaluator::get_derived_value(int var) const {
+    int default_value = default_values[var];
+    for (int fact = fact_offsets[var]; fact < fact_offsets[var + 1]; ++fact) {
+        int value = fact - fact_offsets[var];
+        if (value != default_value && is_set(fact))
+            return value;
+    }
+    return default_value;
+}
+
 void AxiomEvaluator::evaluate(vector<int> &state) {
     if (!task_has_axioms)
         return;
 
-    assert(queue.empty());
-    for (size_t var_id = 0; var_id < default_values.size(); ++var_id) {
-        int default_value = default_values[var_id];
-        if (default_value != -1) {
-            state[var_id] = default_value;
-        } else {
-            int value = state[var_id];
-            queue.push_back(&axiom_literals[var_id][value]);
+    fill(facts.begin(), facts.end(), 0);
+    for (int var : primary_variables) {
+        set(fact_offsets[var] + state[var]);
+    }
+
+    for (size_t layer = 0; layer + 1 < layer_begin.size(); ++layer) {
+        assert(queue.empty());
+        for (int rule_id = layer_begin[layer]; rule_id < layer_begin[layer + 1];
+             ++rule_id) {
+            fire(rule_id);
         }
+        propagate_derived_facts(0);
+        queue.clear();
     }
 
-    for (AxiomRule &rule : rules) {
-        rule.unsatisfied_conditions = rule.condition_count;
-
-        /*
-          TODO: In a perfect world, trivial axioms would have been
-          compiled away, and we could have the following assertion
-          instead of the following block.
-          assert(rule.condition_count != 0);
-        */
-        if (rule.condition_count == 0) {
-            /*
-              NOTE: This duplicates code from the main loop below.
-              I don't mind because this is (hopefully!) going away
-              some time.
-            */
-            int var_no = rule.effect_var;
-            int val = rule.effect_val;
-            if (state[var_no] != val) {
-                state[var_no] = val;
-                queue.push_back(rule.effect_literal);
-            }
+    for (int var : derived_variables) {
+        state[var] = get_derived_value(var);
+    }
+}
+
+void AxiomEvaluator::evaluate_incrementally(
+    const vector<int> &parent_state, vector<int> &state) {
+    if (!task_has_axioms)
+        return;
+
+    fill(facts.begin(), facts.end(), 0);
+    for (int var : primary_variables) {
+        int value = state[var];
+        set(fact_offsets[var] + value);
+        int parent_value = parent_state[var];
+        if (value != parent_value) {
+            mark_affected_rules(fact_offsets[var] + parent_value);
+            mark_affected_rules(fact_offsets[var] + value);
         }
     }
+    for (int var : derived_variables) {
+        assert(state[var] == parent_state[var]);
+        int value = state[var];
+        if (value != default_values[var])
+            set(fact_offsets[var] + value);
+    }
 
-    for (size_t layer_no = 0; layer_no < nbf_info_by_layer.size(); ++layer_no) {
-        // Apply Horn rules.
-        while (!queue.empty()) {
-            const AxiomLiteral *curr_literal = queue.back();
-            queue.pop_back();
-            for (size_t i = 0; i < curr_literal->condition_of.size(); ++i) {
-                AxiomRule *rule = curr_literal->condition_of[i];
-                if (--rule->unsatisfied_conditions == 0) {
-                    int var_no = rule->effect_var;
-                    int val = rule->effect_val;
-                    if (state[var_no] != val) {
-                        state[var_no] = val;
-                        queue.push_back(rule->effect_literal);
-                    }
-                }
+    for (size_t layer = 0; layer < affected_rules_by_layer.size(); ++layer) {
+        vector<int> &affected_rules = affected_rules_by_layer[layer];
+        if (affected_rules.empty())
+            continue;
+        assert(queue.empty() && deleted_facts.empty());
+
+        // Delete facts whose rule might not be applicable anymore.
+        for (int rule_id : affected_rules) {
+            const AxiomRule &rule = rules[rule_id];
+            if (is_set(rule.effect_fact) && !is_applicable(rule))
+                delete_fact(rule.effect_fact);
+        }
+
+        // Re-derive deleted facts and derive new facts.
+        for (int fact : deleted_facts) {
+            for (int rule_id : rules_by_effect[fact]) {
+                fire(rule_id);
             }
         }
+        for (int rule_id : affected_rules) {
+            fire(rule_id);
+        }
+        affected_rules.clear();
+        propagate_derived_facts(0);
 
-        /*
-          Apply negation by failure rules. Skip this in last iteration
-          to save some time (see issue420, msg3058).
-        */
-        if (layer_no != nbf_info_by_layer.size() - 1) {
-            const vector<NegationByFailureInfo> &nbf_info = nbf_info_by_layer[layer_no];
-            for (size_t i = 0; i < nbf_info.size(); ++i) {
-                int var_no = nbf_info[i].var_no;
-                // Verify that variable is derived.
-                assert(default_values[var_no] != -1);
-                if (state[var_no] == default_values[var_no])
-                    queue.push_back(nbf_info[i].literal);
+        // Update the changed derived variables and mark affected rules.
+        for (int fact : deleted_facts) {
+            if (!is_set(fact)) {
+                state[variable_of_fact[fact]] =
+                    get_derived_value(variable_of_fact[fact]);
+                mark_affected_rules(fact);
             }
         }
+        for (int fact : queue) {
+            if (!is_deleted[fact]) {
+                state[variable_of_fact[fact]] =
+                    get_derived_value(variable_of_fact[fact]);
+                mark_affected_rules(fact);
+            }
+        }
+        for (int fact : deleted_facts) {
+            is_deleted[fact] = false;
+        }
+        deleted_facts.clear();
+        queue.clear();
     }
 }
 
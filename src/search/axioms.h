@@ -4,37 +4,55 @@
 #include "per_task_information.h"
 #include "task_proxy.h"
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
+/*
+  Compute the values of the derived variables of a state.
+
+  Every fact of the task is a bit in a packed fact vector. Primary facts
+  are set according to the state, derived facts are set if the derived
+  variable has the corresponding (non-default) value. The conditions of
+  each rule are compiled into a list of 64-bit words of the fact vector,
+  each with a mask of bits that must be set (primary facts and derived
+  facts with a non-default value) and a mask of bits that must be clear
+  (negation by failure on the derived variables of lower layers). A rule
+  is applicable if all of its words match both masks, which tests all
+  conditions in a word with a single comparison.
+
+  The layers are evaluated in order. Within a layer, we first test every
+  rule once and then only re-test the rules that have a newly derived
+  fact of the same layer as a condition.
+
+  evaluate_incrementally() starts from the derived values of a parent
+  state and only re-evaluates the rules that are affected by the changed
+  primary variables. Within each layer it over-deletes the derived facts
+  that might have lost their support, re-derives the ones that are still
+  supported and derives the facts of rules whose conditions became true
+  (the "delete and rederive" algorithm for stratified programs).
+*/
 class AxiomEvaluator {
-    struct AxiomRule;
-    struct AxiomLiteral {
-        std::vector<AxiomRule *> condition_of;
+    struct ConditionWord {
+        int word;
+        std::uint64_t positive;
+        std::uint64_t negative;
     };
     struct AxiomRule {
-        int condition_count;
-        int unsatisfied_conditions;
-        int effect_var;
-        int effect_val;
-        AxiomLiteral *effect_literal;
-        AxiomRule(int cond_count, int eff_var, int eff_val, AxiomLiteral *eff_literal)
-            : condition_count(cond_count), unsatisfied_conditions(cond_count),
-              effect_var(eff_var), effect_val(eff_val), effect_literal(eff_literal) {
-        }
-    };
-    struct NegationByFailureInfo {
-        int var_no;
-        AxiomLiteral *literal;
-        NegationByFailureInfo(int var, AxiomLiteral *lit)
-            : var_no(var), literal(lit) {}
+        // Conditions are the words [conditions_begin, conditions_end).
+        int conditions_begin;
+        int conditions_end;
+        int effect_fact;
+        int layer;
     };
 
     bool task_has_axioms;
 
-    std::vector<std::vector<AxiomLiteral>> axiom_literals;
-    std::vector<AxiomRule> rules;
-    std::vector<std::vector<NegationByFailureInfo>> nbf_info_by_layer;
+    // Each fact (var, value) is bit fact_offsets[var] + value.
+    std::vector<int> fact_offsets;
+    std::vector<int> variable_of_fact;
+    std::vector<int> primary_variables;
+    std::vector<int> derived_variables;
     /*
       default_values stores the default (negation by failure) values
       for all derived variables, i.e., the value that a derived
@@ -42,24 +60,78 @@ class AxiomEvaluator {
 
       This is indexed by variable number and set to -1 for non-derived
       variables, so can also be used to test if a variable is derived.
-
-      We have our own copy of the data to avoid going through the task
-      interface in the time-critical evaluate method.
     */
     std::vector<int> default_values;
 
+    std::vector<ConditionWord> conditions;
+    // Rules are sorted by layer. Layer i has the rules [layer_begin[i], layer_begin[i + 1]).
+    std::vector<AxiomRule> rules;
+    std::vector<int> layer_begin;
+
+    // Rules with the fact as a condition in the same layer as the fact.
+    std::vector<std::vector<int>> same_layer_dependents;
+    // Rules with the fact as a condition in a higher layer than the fact.
+    std::vector<std::vector<int>> dependents;
+    // Only used for incremental evaluation.
+    std::vector<std::vector<int>> rules_by_effect;
+
     /*
-      The queue is an instance variable rather than a local variable
+      The following are instance variables rather than local variables
       to reduce reallocation effort. See issue420.
     */
-    std::vector<const AxiomLiteral *> queue;
+    std::vector<std::uint64_t> facts;
+    // Facts derived in the current layer. Processed in FIFO order.
+    std::vector<int> queue;
+    std::vector<std::vector<int>> affected_rules_by_layer;
+    std::vector<int> deleted_facts;
+    std::vector<bool> is_deleted;
 
-    template<typename Values, typename Accessor>
-    void evaluate_aux(Values &values, const Accessor &accessor);
+    bool is_set(int fact) const {
+        return (facts[fact >> 6] >> (fact & 63)) & 1;
+    }
+
+    void set(int fact) {
+        facts[fact >> 6] |= std::uint64_t(1) << (fact & 63);
+    }
+
+    void clear(int fact) {
+        facts[fact >> 6] &= ~(std::uint64_t(1) << (fact & 63));
+    }
+
+    bool is_applicable(const AxiomRule &rule) const {
+        for (int i = rule.conditions_begin; i < rule.conditions_end; ++i) {
+            const ConditionWord &condition = conditions[i];
+            std::uint64_t word = facts[condition.word];
+            if ((word & condition.positive) != condition.positive ||
+                (word & condition.negative)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void fire(int rule_id);
+    void propagate_derived_facts(std::size_t queue_start);
+    void delete_fact(int fact);
+    void mark_affected_rules(int fact);
+    int get_derived_value(int var) const;
 public:
     explicit AxiomEvaluator(const TaskProxy &task_proxy);
 
+    /*
+      Set the derived variables of the state. The values of the derived
+      variables in the given state are ignored.
+    */
     void evaluate(std::vector<int> &state);
+
+    /*
+      Set the derived variables of the state, which must have the same
+      derived values as the given parent state. The derived values of the
+      parent must be correct for its primary values. This is much faster
+      than evaluate() if few primary variables differ.
+    */
+    void evaluate_incrementally(
+        const std::vector<int> &parent_state, std::vector<int> &state);
 };
 
 extern PerTaskInformation<AxiomEvaluator> g_axiom_evaluators;
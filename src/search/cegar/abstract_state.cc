@@ -100,7 +100,7 @@ NodeID AbstractState::get_node_id() const {
 }
 
 unique_ptr<AbstractState> AbstractState::get_trivial_abstract_state(
-    const vector<int> &domain_sizes) {
-    return utils::make_unique_ptr<AbstractState>(0, 0, CartesianSet(domain_sizes));
+    const shared_ptr<const CartesianSet::Layout> &layout) {
+    return utils::make_unique_ptr<AbstractState>(0, 0, CartesianSet(layout));
 }
 }
@@ -4,6 +4,7 @@
 #include "cartesian_set.h"
 #include "types.h"
 
+#include <memory>
 #include <vector>
 
 class ConditionsProxy;
@@ -64,7 +65,7 @@ public:
 
     // Create the initial, unrefined abstract state.
     static std::unique_ptr<AbstractState> get_trivial_abstract_state(
-        const std::vector<int> &domain_sizes);
+        const std::shared_ptr<const CartesianSet::Layout> &layout);
 };
 }
 
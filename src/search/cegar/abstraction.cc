@@ -23,9 +23,11 @@ Abstraction::Abstraction(const shared_ptr<AbstractTask> &task, utils::LogProxy &
     : transition_system(utils::make_unique_ptr<TransitionSystem>(TaskProxy(*task).get_operators())),
       concrete_initial_state(TaskProxy(*task).get_initial_state()),
       goal_facts(task_properties::get_fact_pairs(TaskProxy(*task).get_goals())),
+      cartesian_set_layout(make_shared<CartesianSet::Layout>(
+                               get_domain_sizes(TaskProxy(*task)))),
       refinement_hierarchy(utils::make_unique_ptr<RefinementHierarchy>(task)),
       log(log) {
-    initialize_trivial_abstraction(get_domain_sizes(TaskProxy(*task)));
+    initialize_trivial_abstraction();
 }
 
 Abstraction::~Abstraction() {
@@ -51,8 +53,13 @@ const TransitionSystem &Abstraction::get_transition_system() const {
     return *transition_system;
 }
 
+const shared_ptr<const CartesianSet::Layout> &Abstraction::get_cartesian_set_layout() const {
+    return cartesian_set_layout;
+}
+
 unique_ptr<RefinementHierarchy> Abstraction::extract_refinement_hierarchy() {
     assert(refinement_hierarchy);
+    refinement_hierarchy->compile();
     return move(refinement_hierarchy);
 }
 
@@ -66,9 +73,9 @@ void Abstraction::mark_all_states_as_goals() {
     }
 }
 
-void Abstraction::initialize_trivial_abstraction(const vector<int> &domain_sizes) {
+void Abstraction::initialize_trivial_abstraction() {
     unique_ptr<AbstractState> init_state =
-        AbstractState::get_trivial_abstract_state(domain_sizes);
+        AbstractState::get_trivial_abstract_state(cartesian_set_layout);
     init_id = init_state->get_id();
     goals.insert(init_state->get_id());
     states.push_back(move(init_state));
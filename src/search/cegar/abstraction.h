@@ -1,6 +1,7 @@
 #ifndef CEGAR_ABSTRACTION_H
 #define CEGAR_ABSTRACTION_H
 
+#include "cartesian_set.h"
 #include "types.h"
 
 #include "../task_proxy.h"
@@ -29,6 +30,8 @@ class Abstraction {
     const std::unique_ptr<TransitionSystem> transition_system;
     const State concrete_initial_state;
     const std::vector<FactPair> goal_facts;
+    // Shared by all Cartesian sets of this abstraction.
+    const std::shared_ptr<const CartesianSet::Layout> cartesian_set_layout;
 
     // All (as of yet unsplit) abstract states.
     AbstractStates states;
@@ -43,7 +46,7 @@ class Abstraction {
 
     utils::LogProxy &log;
 
-    void initialize_trivial_abstraction(const std::vector<int> &domain_sizes);
+    void initialize_trivial_abstraction();
 
 public:
     Abstraction(const std::shared_ptr<AbstractTask> &task, utils::LogProxy &log);
@@ -56,6 +59,7 @@ public:
     const Goals &get_goals() const;
     const AbstractState &get_state(int state_id) const;
     const TransitionSystem &get_transition_system() const;
+    const std::shared_ptr<const CartesianSet::Layout> &get_cartesian_set_layout() const;
     std::unique_ptr<RefinementHierarchy> extract_refinement_hierarchy();
 
     /* Needed for CEGAR::separate_facts_unreachable_before_goal(). */
@@ -2,6 +2,7 @@
 
 #include "cartesian_heuristic_function.h"
 #include "cost_saturation.h"
+#include "refinement_hierarchy.h"
 #include "types.h"
 #include "utils.h"
 
@@ -46,13 +47,35 @@ AdditiveCartesianHeuristic::AdditiveCartesianHeuristic(
     const options::Options &opts)
     : Heuristic(opts),
       heuristic_functions(generate_heuristic_functions(opts, log)) {
+    for (size_t i = 0; i < heuristic_functions.size(); ++i) {
+        const RefinementHierarchy &hierarchy =
+            heuristic_functions[i].get_refinement_hierarchy();
+        if (hierarchy.is_compiled() &&
+            hierarchy.uses_ancestor_state_values(*task)) {
+            batch_function_ids.push_back(i);
+            batch_hierarchies.push_back(&hierarchy);
+        } else {
+            other_function_ids.push_back(i);
+        }
+    }
 }
 
 int AdditiveCartesianHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
+    state.unpack();
     int sum_h = 0;
-    for (const CartesianHeuristicFunction &function : heuristic_functions) {
-        int value = function.get_value(state);
+    RefinementHierarchy::get_abstract_state_ids(
+        batch_hierarchies, state.get_unpacked_values(), abstract_state_ids);
+    for (size_t i = 0; i < batch_function_ids.size(); ++i) {
+        int value = heuristic_functions[batch_function_ids[i]]
+            .get_abstract_state_value(abstract_state_ids[i]);
+        assert(value >= 0);
+        if (value == INF)
+            return DEAD_END;
+        sum_h += value;
+    }
+    for (int function_id : other_function_ids) {
+        int value = heuristic_functions[function_id].get_value(state);
         assert(value >= 0);
         if (value == INF)
             return DEAD_END;
@@ -7,13 +7,22 @@
 
 namespace cegar {
 class CartesianHeuristicFunction;
+class RefinementHierarchy;
 
 /*
   Store CartesianHeuristicFunctions and compute overall heuristic by
   summing all of their values.
+
+  The abstract states of all functions whose refinement hierarchies work
+  directly on the states of this heuristic's task are looked up together
+  in one pass (see RefinementHierarchy::get_abstract_state_ids()).
 */
 class AdditiveCartesianHeuristic : public Heuristic {
     const std::vector<CartesianHeuristicFunction> heuristic_functions;
+    std::vector<int> batch_function_ids;
+    std::vector<const RefinementHierarchy *> batch_hierarchies;
+    std::vector<int> other_function_ids;
+    std::vector<int> abstract_state_ids;
 
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
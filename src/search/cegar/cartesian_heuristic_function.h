@@ -26,6 +26,14 @@ public:
     CartesianHeuristicFunction(CartesianHeuristicFunction &&) = default;
 
     int get_value(const State &state) const;
+
+    const RefinementHierarchy &get_refinement_hierarchy() const {
+        return *refinement_hierarchy;
+    }
+
+    int get_abstract_state_value(int abstract_state_id) const {
+        return h_values[abstract_state_id];
+    }
 };
 }
 
@@ -1,25 +1,84 @@
 #include "cartesian_set.h"
 
+#include <bitset>
 #include <sstream>
 
 using namespace std;
 
 namespace cegar {
-CartesianSet::CartesianSet(const vector<int> &domain_sizes) {
-    domain_subsets.reserve(domain_sizes.size());
+static int count_bits(uint64_t word) {
+    return bitset<64>(word).count();
+}
+
+static uint64_t get_low_bits_mask(int num_bits) {
+    assert(num_bits >= 1 && num_bits <= 64);
+    return (num_bits == 64) ? ~uint64_t(0) : (uint64_t(1) << num_bits) - 1;
+}
+
+CartesianSet::Layout::Layout(const vector<int> &domain_sizes)
+    : num_words(0) {
+    variables.reserve(domain_sizes.size());
+    int used_bits_in_last_word = BITS_PER_WORD;
     for (int domain_size : domain_sizes) {
-        Bitset domain(domain_size);
-        domain.set();
-        domain_subsets.push_back(move(domain));
+        assert(domain_size >= 1);
+        VariableLayout var_layout;
+        var_layout.domain_size = domain_size;
+        if (domain_size <= BITS_PER_WORD - used_bits_in_last_word) {
+            // The variable fits into the remaining bits of the last word.
+            var_layout.first_word = num_words - 1;
+            var_layout.shift = used_bits_in_last_word;
+            used_bits_in_last_word += domain_size;
+        } else {
+            var_layout.first_word = num_words;
+            var_layout.shift = 0;
+            int words_for_var = (domain_size + BITS_PER_WORD - 1) / BITS_PER_WORD;
+            num_words += words_for_var;
+            used_bits_in_last_word =
+                domain_size - (words_for_var - 1) * BITS_PER_WORD;
+        }
+        variables.push_back(var_layout);
+    }
+}
+
+template<typename Callback>
+void CartesianSet::for_each_word(int var, const Callback &callback) const {
+    const VariableLayout &var_layout = layout->variables[var];
+    int remaining_bits = var_layout.domain_size;
+    int word = var_layout.first_word;
+    if (var_layout.shift + remaining_bits <= BITS_PER_WORD) {
+        callback(word, get_low_bits_mask(remaining_bits) << var_layout.shift);
+        return;
+    }
+    assert(var_layout.shift == 0);
+    while (remaining_bits > 0) {
+        int bits = min(remaining_bits, BITS_PER_WORD);
+        callback(word, get_low_bits_mask(bits));
+        remaining_bits -= bits;
+        ++word;
+    }
+}
+
+CartesianSet::CartesianSet(const shared_ptr<const Layout> &layout)
+    : layout(layout),
+      words(layout->num_words, 0) {
+    int num_vars = layout->variables.size();
+    for (int var = 0; var < num_vars; ++var) {
+        add_all(var);
     }
 }
 
 void CartesianSet::add(int var, int value) {
-    domain_subsets[var].set(value);
+    int word;
+    Word mask;
+    get_position(var, value, word, mask);
+    words[word] |= mask;
 }
 
 void CartesianSet::remove(int var, int value) {
-    domain_subsets[var].reset(value);
+    int word;
+    Word mask;
+    get_position(var, value, word, mask);
+    words[word] &= ~mask;
 }
 
 void CartesianSet::set_single_value(int var, int value) {
@@ -28,20 +87,28 @@ void CartesianSet::set_single_value(int var, int value) {
 }
 
 void CartesianSet::add_all(int var) {
-    domain_subsets[var].set();
+    for_each_word(var, [this](int word, Word mask) {
+                      words[word] |= mask;
+                  });
 }
 
 void CartesianSet::remove_all(int var) {
-    domain_subsets[var].reset();
+    for_each_word(var, [this](int word, Word mask) {
+                      words[word] &= ~mask;
+                  });
 }
 
 int CartesianSet::count(int var) const {
-    return domain_subsets[var].count();
+    int num_values = 0;
+    for_each_word(var, [this, &num_values](int word, Word mask) {
+                      num_values += count_bits(words[word] & mask);
+                  });
+    return num_values;
 }
 
 vector<int> CartesianSet::get_values(int var) const {
     vector<int> values;
-    int domain_size = domain_subsets[var].size();
+    int domain_size = layout->variables[var].domain_size;
     for (int value = 0; value < domain_size; ++value) {
         if (test(var, value)) {
             values.push_back(value);
@@ -51,31 +118,38 @@ vector<int> CartesianSet::get_values(int var) const {
 }
 
 bool CartesianSet::intersects(const CartesianSet &other, int var) const {
-    return domain_subsets[var].intersects(other.domain_subsets[var]);
+    assert(words.size() == other.words.size());
+    bool result = false;
+    for_each_word(var, [this, &other, &result](int word, Word mask) {
+                      if (words[word] & other.words[word] & mask) {
+                          result = true;
+                      }
+                  });
+    return result;
 }
 
 bool CartesianSet::is_superset_of(const CartesianSet &other) const {
-    int num_vars = domain_subsets.size();
-    for (int var = 0; var < num_vars; ++var) {
-        if (!other.domain_subsets[var].is_subset_of(domain_subsets[var]))
-            return false;
+    assert(words.size() == other.words.size());
+    /* Unused bits are zero in both sets, so we can compare whole words. We
+       accumulate the result instead of returning early to allow for
+       vectorization. */
+    Word missing_bits = 0;
+    int num_words = words.size();
+    for (int i = 0; i < num_words; ++i) {
+        missing_bits |= other.words[i] & ~words[i];
     }
-    return true;
+    return missing_bits == 0;
 }
 
 ostream &operator<<(ostream &os, const CartesianSet &cartesian_set) {
-    int num_vars = cartesian_set.domain_subsets.size();
+    int num_vars = cartesian_set.layout->variables.size();
     string var_sep;
     os << "<";
     for (int var = 0; var < num_vars; ++var) {
-        const Bitset &domain = cartesian_set.domain_subsets[var];
-        vector<int> values;
-        for (size_t value = 0; value < domain.size(); ++value) {
-            if (domain[value])
-                values.push_back(value);
-        }
+        vector<int> values = cartesian_set.get_values(var);
         assert(!values.empty());
-        if (values.size() < domain.size()) {
+        int domain_size = cartesian_set.layout->variables[var].domain_size;
+        if (static_cast<int>(values.size()) < domain_size) {
             os << var_sep << var << "={";
             string value_sep;
             for (int value : values) {
@@ -1,24 +1,69 @@
 #ifndef CEGAR_CARTESIAN_SET_H
 #define CEGAR_CARTESIAN_SET_H
 
-#include "../algorithms/dynamic_bitset.h"
-
+#include <cassert>
+#include <cstdint>
+#include <memory>
 #include <ostream>
 #include <vector>
 
 namespace cegar {
-using Bitset = dynamic_bitset::DynamicBitset<unsigned short>;
-
 /*
   For each variable store a subset of its domain.
 
-  The underlying data structure is a vector of bitsets.
+  All subsets are stored in a single contiguous array of 64-bit words. The
+  variables are packed greedily into the words in the order of their IDs: a
+  variable with at most 64 values occupies a contiguous bit range inside a
+  single word, larger variables start at a word boundary and occupy as many
+  words as needed. Unused bits are always zero. This way, most operations
+  on a single variable touch one word and operations on all variables (like
+  is_superset_of()) are simple loops over the word array that the compiler
+  can vectorize.
+
+  The layout only depends on the domain sizes. Each abstraction creates it
+  once and shares it between all of its sets.
 */
 class CartesianSet {
-    std::vector<Bitset> domain_subsets;
+    using Word = std::uint64_t;
+    static const int BITS_PER_WORD = 64;
+
+    struct VariableLayout {
+        int first_word;
+        // Bit position of value 0 in first_word (0 for large variables).
+        int shift;
+        int domain_size;
+    };
+
+public:
+    struct Layout {
+        std::vector<VariableLayout> variables;
+        int num_words;
+
+        explicit Layout(const std::vector<int> &domain_sizes);
+    };
+
+private:
+    std::shared_ptr<const Layout> layout;
+    std::vector<Word> words;
+
+    /*
+      Call callback(word_index, mask) for all words that hold bits of the
+      given variable. The mask selects the bits of the variable.
+    */
+    template<typename Callback>
+    void for_each_word(int var, const Callback &callback) const;
+
+    void get_position(int var, int value, int &word, Word &mask) const {
+        const VariableLayout &var_layout = layout->variables[var];
+        assert(value >= 0 && value < var_layout.domain_size);
+        int bit = var_layout.shift + value;
+        word = var_layout.first_word + bit / BITS_PER_WORD;
+        mask = Word(1) << (bit % BITS_PER_WORD);
+    }
 
 public:
-    explicit CartesianSet(const std::vector<int> &domain_sizes);
+    // Create the set that contains all values of all variables.
+    explicit CartesianSet(const std::shared_ptr<const Layout> &layout);
 
     void add(int var, int value);
     void set_single_value(int var, int value);
@@ -27,7 +72,10 @@ public:
     void remove_all(int var);
 
     bool test(int var, int value) const {
-        return domain_subsets[var][value];
+        int word;
+        Word mask;
+        get_position(var, value, word, mask);
+        return words[word] & mask;
     }
 
     int count(int var) const;
@@ -24,8 +24,9 @@ using namespace std;
 namespace cegar {
 // Create the Cartesian set that corresponds to the given preconditions or goals.
 static CartesianSet get_cartesian_set(
-    const vector<int> &domain_sizes, const ConditionsProxy &conditions) {
-    CartesianSet cartesian_set(domain_sizes);
+    const shared_ptr<const CartesianSet::Layout> &layout,
+    const ConditionsProxy &conditions) {
+    CartesianSet cartesian_set(layout);
     for (FactProxy condition : conditions) {
         cartesian_set.set_single_value(
             condition.get_variable().get_id(), condition.get_value());
@@ -90,7 +91,6 @@ CEGAR::CEGAR(
     utils::RandomNumberGenerator &rng,
     utils::LogProxy &log)
     : task_proxy(*task),
-      domain_sizes(get_domain_sizes(task_proxy)),
       max_states(max_states),
       max_non_looping_transitions(max_non_looping_transitions),
       split_selector(task, pick),
@@ -365,7 +365,8 @@ unique_ptr<Flaw> CEGAR::find_flaw(const Solution &solution) {
             return utils::make_unique_ptr<Flaw>(
                 move(concrete_state),
                 *abstract_state,
-                get_cartesian_set(domain_sizes, op.get_preconditions()));
+                get_cartesian_set(
+                    abstraction->get_cartesian_set_layout(), op.get_preconditions()));
         }
     }
     assert(abstraction->get_goals().count(abstract_state->get_id()));
@@ -378,7 +379,8 @@ unique_ptr<Flaw> CEGAR::find_flaw(const Solution &solution) {
         return utils::make_unique_ptr<Flaw>(
             move(concrete_state),
             *abstract_state,
-            get_cartesian_set(domain_sizes, task_proxy.get_goals()));
+            get_cartesian_set(
+                abstraction->get_cartesian_set_layout(), task_proxy.get_goals()));
     }
 }
 
@@ -31,7 +31,6 @@ class ShortestPaths;
 */
 class CEGAR {
     const TaskProxy task_proxy;
-    const std::vector<int> domain_sizes;
     const int max_states;
     const int max_non_looping_transitions;
     const SplitSelector split_selector;
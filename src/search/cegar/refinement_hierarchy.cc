@@ -2,6 +2,10 @@
 
 #include "../task_proxy.h"
 
+#include "../utils/collections.h"
+
+#include <deque>
+
 using namespace std;
 
 namespace cegar {
@@ -47,7 +51,9 @@ ostream &operator<<(ostream &os, const Node &node) {
 
 
 RefinementHierarchy::RefinementHierarchy(const shared_ptr<AbstractTask> &task)
-    : task(task) {
+    : task(task),
+      compiled_root(UNDEFINED),
+      compiled(false) {
     nodes.emplace_back(0);
 }
 
@@ -60,6 +66,7 @@ NodeID RefinementHierarchy::add_node(int state_id) {
 NodeID RefinementHierarchy::get_node_id(const State &state) const {
     const vector<int> &values = state.get_unpacked_values();
     NodeID id = 0;
+    assert(!is_compiled());
     while (nodes[id].is_split()) {
         id = nodes[id].get_child(values[nodes[id].get_var()]);
     }
@@ -68,6 +75,7 @@ NodeID RefinementHierarchy::get_node_id(const State &state) const {
 
 pair<NodeID, NodeID> RefinementHierarchy::split(
     NodeID node_id, int var, const vector<int> &values, int left_state_id, int right_state_id) {
+    assert(!is_compiled());
     NodeID helper_id = node_id;
     NodeID right_child_id = add_node(right_state_id);
     for (int value : values) {
@@ -82,9 +90,91 @@ int RefinementHierarchy::get_abstract_state_id(const State &state) const {
     TaskProxy subtask_proxy(*task);
     if (subtask_proxy.needs_to_convert_ancestor_state(state)) {
         State subtask_state = subtask_proxy.convert_ancestor_state(state);
+        if (is_compiled()) {
+            return lookup_compiled(subtask_state.get_unpacked_values());
+        }
         return nodes[get_node_id(subtask_state)].get_state_id();
+    } else if (is_compiled()) {
+        state.unpack();
+        return lookup_compiled(state.get_unpacked_values());
     } else {
         return nodes[get_node_id(state)].get_state_id();
     }
 }
+
+void RefinementHierarchy::compile() {
+    assert(!is_compiled());
+    VariablesProxy variables = TaskProxy(*task).get_variables();
+    vector<int> node_offsets(nodes.size(), UNDEFINED);
+    deque<NodeID> queue;
+
+    auto get_code = [&](NodeID node_id) {
+            const Node &node = nodes[node_id];
+            if (!node.is_split()) {
+                return -node.get_state_id() - 1;
+            }
+            if (node_offsets[node_id] == UNDEFINED) {
+                node_offsets[node_id] = compiled_nodes.size();
+                int domain_size = variables[node.get_var()].get_domain_size();
+                compiled_nodes.resize(compiled_nodes.size() + 1 + domain_size);
+                queue.push_back(node_id);
+            }
+            return node_offsets[node_id];
+        };
+
+    compiled_root = get_code(0);
+    while (!queue.empty()) {
+        NodeID node_id = queue.front();
+        queue.pop_front();
+        int var = nodes[node_id].get_var();
+        int offset = node_offsets[node_id];
+        compiled_nodes[offset] = var;
+        int domain_size = variables[var].get_domain_size();
+        for (int value = 0; value < domain_size; ++value) {
+            // Follow all splits on the same variable for this value.
+            NodeID target_id = node_id;
+            while (nodes[target_id].is_split() &&
+                   nodes[target_id].get_var() == var) {
+                target_id = nodes[target_id].get_child(value);
+            }
+            int code = get_code(target_id);
+            compiled_nodes[offset + 1 + value] = code;
+        }
+    }
+    compiled_nodes.shrink_to_fit();
+    utils::release_vector_memory(nodes);
+    compiled = true;
+}
+
+bool RefinementHierarchy::uses_ancestor_state_values(
+    const AbstractTask &ancestor_task) const {
+    return !task->does_convert_ancestor_state_values(&ancestor_task);
+}
+
+void RefinementHierarchy::get_abstract_state_ids(
+    const vector<const RefinementHierarchy *> &hierarchies,
+    const vector<int> &values,
+    vector<int> &abstract_state_ids) {
+    int num_hierarchies = hierarchies.size();
+    abstract_state_ids.resize(num_hierarchies);
+    for (int i = 0; i < num_hierarchies; ++i) {
+        assert(hierarchies[i]->is_compiled());
+        abstract_state_ids[i] = hierarchies[i]->compiled_root;
+    }
+    bool done = false;
+    while (!done) {
+        done = true;
+        for (int i = 0; i < num_hierarchies; ++i) {
+            int &code = abstract_state_ids[i];
+            if (code >= 0) {
+                const vector<int> &program = hierarchies[i]->compiled_nodes;
+                code = program[code + 1 + values[program[code]]];
+                done = false;
+            }
+        }
+    }
+    for (int &code : abstract_state_ids) {
+        code = -code - 1;
+    }
+}
 }
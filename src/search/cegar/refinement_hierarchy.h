@@ -26,14 +26,41 @@ class Node;
   helper nodes, see below). Leaf nodes correspond to the current
   (unsplit) states in an abstraction. The use of helper nodes makes
   this structure a directed acyclic graph (instead of a tree).
+
+  Once the abstraction is fully refined, the hierarchy can be compiled into
+  a flat lookup program (see compile()). Each compiled node tests a single
+  variable and has a jump table with one entry per value of the variable.
+  All consecutive splits on the same variable (including the helper node
+  chains) are merged into one compiled node, so a lookup needs at most one
+  step per variable change along the path. The compiled nodes are stored
+  in breadth-first order in a single vector.
 */
 class RefinementHierarchy {
     std::shared_ptr<AbstractTask> task;
     std::vector<Node> nodes;
 
+    /*
+      Compiled lookup program. A compiled node at offset i stores its
+      variable var at position i and the codes of its children for value
+      val at position i + 1 + val. Non-negative codes are offsets of inner
+      nodes, a negative code c stands for the leaf with state ID -c - 1.
+    */
+    std::vector<int> compiled_nodes;
+    int compiled_root;
+    // We can't use compiled_root for this, since a leaf root for state 0 is -1.
+    bool compiled;
+
     NodeID add_node(int state_id);
     NodeID get_node_id(const State &state) const;
 
+    int lookup_compiled(const std::vector<int> &values) const {
+        int code = compiled_root;
+        while (code >= 0) {
+            code = compiled_nodes[code + 1 + values[compiled_nodes[code]]];
+        }
+        return -code - 1;
+    }
+
 public:
     explicit RefinementHierarchy(const std::shared_ptr<AbstractTask> &task);
 
@@ -49,6 +76,35 @@ public:
 
     int get_abstract_state_id(const State &state) const;
 
+    /*
+      Replace the node representation by the compiled lookup program (see
+      class comment). Afterwards, the hierarchy can't be split anymore.
+    */
+    void compile();
+
+    bool is_compiled() const {
+        return compiled;
+    }
+
+    /*
+      Return true iff states of the given ancestor task can be looked up
+      without converting them to the task of this hierarchy first.
+    */
+    bool uses_ancestor_state_values(const AbstractTask &ancestor_task) const;
+
+    /*
+      Look up the abstract state IDs for the given state values in all given
+      compiled hierarchies. The states values must be valid for all
+      hierarchies without conversion (see uses_ancestor_state_values()).
+      Instead of finishing one lookup before starting the next one, we
+      advance all lookups by one step per pass, which allows the CPU to
+      overlap the memory accesses of different hierarchies.
+    */
+    static void get_abstract_state_ids(
+        const std::vector<const RefinementHierarchy *> &hierarchies,
+        const std::vector<int> &values,
+        std::vector<int> &abstract_state_ids);
+
     int get_num_nodes() const {
         return nodes.size();
     }
@@ -7,6 +7,7 @@
 #include "../task_proxy.h"
 
 #include "../task_utils/task_properties.h"
+#include "../utils/collections.h"
 #include "../utils/logging.h"
 
 #include <algorithm>
@@ -77,6 +78,19 @@ static void remove_transitions_with_given_target(
     transitions.erase(new_end, transitions.end());
 }
 
+/* Return the sorted IDs of all states that the given transitions lead to.
+   This is cheaper than collecting them in a hash set since we only need to
+   iterate over them once. */
+static vector<int> get_unique_target_ids(const Transitions &transitions) {
+    vector<int> target_ids;
+    target_ids.reserve(transitions.size());
+    for (const Transition &transition : transitions) {
+        target_ids.push_back(transition.target_id);
+    }
+    utils::sort_unique(target_ids);
+    return target_ids;
+}
+
 
 TransitionSystem::TransitionSystem(const OperatorsProxy &ops)
     : preconditions_by_operator(get_preconditions_by_operator(ops)),
@@ -131,13 +145,8 @@ void TransitionSystem::rewire_incoming_transitions(
     int v1_id = v1.get_id();
     int v2_id = v2.get_id();
 
-    unordered_set<int> updated_states;
-    for (const Transition &transition : old_incoming) {
-        int u_id = transition.target_id;
-        bool is_new_state = updated_states.insert(u_id).second;
-        if (is_new_state) {
-            remove_transitions_with_given_target(outgoing[u_id], v_id);
-        }
+    for (int u_id : get_unique_target_ids(old_incoming)) {
+        remove_transitions_with_given_target(outgoing[u_id], v_id);
     }
     num_non_loops -= old_incoming.size();
 
@@ -176,13 +185,8 @@ void TransitionSystem::rewire_outgoing_transitions(
     int v1_id = v1.get_id();
     int v2_id = v2.get_id();
 
-    unordered_set<int> updated_states;
-    for (const Transition &transition : old_outgoing) {
-        int w_id = transition.target_id;
-        bool is_new_state = updated_states.insert(w_id).second;
-        if (is_new_state) {
-            remove_transitions_with_given_target(incoming[w_id], v_id);
-        }
+    for (int w_id : get_unique_target_ids(old_outgoing)) {
+        remove_transitions_with_given_target(incoming[w_id], v_id);
     }
     num_non_loops -= old_outgoing.size();
 
@@ -7,6 +7,7 @@
 #include "options/doc_printer.h"
 #include "options/predefinitions.h"
 #include "options/registries.h"
+#include "utils/profiling.h"
 #include "utils/strings.h"
 
 #include <algorithm>
@@ -46,6 +47,8 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(
     string plan_filename = "sas_plan";
     int num_previously_generated_plans = 0;
     bool is_part_of_anytime_portfolio = false;
+    string profile_filename;
+    int profile_interval = 0;
     options::Predefinitions predefinitions;
 
     shared_ptr<SearchEngine> engine;
@@ -105,6 +108,18 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(
             num_previously_generated_plans = parse_int_arg(arg, args[i]);
             if (num_previously_generated_plans < 0)
                 throw ArgError("argument for --internal-previous-portfolio-plans must be positive");
+        } else if (arg == "--profile") {
+            if (is_last)
+                throw ArgError("missing argument after --profile");
+            ++i;
+            profile_filename = args[i];
+        } else if (arg == "--profile-interval") {
+            if (is_last)
+                throw ArgError("missing argument after --profile-interval");
+            ++i;
+            profile_interval = parse_int_arg(arg, args[i]);
+            if (profile_interval <= 0)
+                throw ArgError("argument for --profile-interval must be positive");
         } else if (utils::startswith(arg, "--") &&
                    registry.is_predefinition(arg.substr(2))) {
             if (is_last)
@@ -124,6 +139,11 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(
         plan_manager.set_num_previously_generated_plans(num_previously_generated_plans);
         plan_manager.set_is_part_of_anytime_portfolio(is_part_of_anytime_portfolio);
     }
+    if (profile_interval > 0 && profile_filename.empty())
+        throw ArgError("--profile-interval requires --profile");
+    if (!profile_filename.empty() && !dry_run) {
+        utils::enable_profiling(profile_filename, profile_interval);
+    }
     return engine;
 }
 
@@ -171,5 +191,12 @@ string usage(const string &progname) {
            "    This planner call is part of a portfolio which already created\n"
            "    plan files FILENAME.1 up to FILENAME.COUNTER.\n"
            "    Start enumerating plan files with COUNTER+1, i.e. FILENAME.COUNTER+1\n\n"
+           "--profile FILENAME\n"
+           "    Measure the time spent in evaluators, pruning methods, successor\n"
+           "    generation and open lists and write it to FILENAME when the search\n"
+           "    ends (CSV if FILENAME ends in .csv, JSON otherwise).\n"
+           "--profile-interval SECONDS\n"
+           "    Additionally overwrite the profile every SECONDS seconds during\n"
+           "    the search.\n\n"
            "See https://www.fast-downward.org for details.";
 }
@@ -34,20 +34,22 @@ void CostPartitioningHeuristic::merge_h_values(
             lookup_tables.emplace_back(abstraction_id, move(h_values));
         } else {
             // Sum values from old and new lookup table.
-            vector<int> &old_h_values = lookup_tables[lookup_table_id].h_values;
+            LookupTable &old_table = lookup_tables[lookup_table_id];
+            vector<int> old_h_values = old_table.h_values.to_vector();
             assert(h_values.size() == old_h_values.size());
             for (size_t i = 0; i < h_values.size(); ++i) {
                 int &h1 = old_h_values[i];
                 int h2 = h_values[i];
                 h1 = left_addition(h1, h2);
             }
+            old_table.h_values = compact_int_table::CompactIntTable(old_h_values);
         }
     }
 }
 
 void CostPartitioningHeuristic::add(CostPartitioningHeuristic &&other) {
     for (LookupTable &table : other.lookup_tables) {
-        merge_h_values(table.abstraction_id, move(table.h_values));
+        merge_h_values(table.abstraction_id, table.h_values.to_vector());
     }
 }
 
@@ -57,7 +59,7 @@ int CostPartitioningHeuristic::compute_heuristic(
     for (const LookupTable &lookup_table : lookup_tables) {
         assert(utils::in_bounds(lookup_table.abstraction_id, abstract_state_ids));
         int state_id = abstract_state_ids[lookup_table.abstraction_id];
-        assert(utils::in_bounds(state_id, lookup_table.h_values));
+        assert(state_id >= 0 && state_id < lookup_table.h_values.size());
         int h = lookup_table.h_values[state_id];
         assert(h >= 0);
         if (h == INF) {
@@ -82,8 +84,11 @@ int CostPartitioningHeuristic::get_num_heuristic_values() const {
 }
 
 int CostPartitioningHeuristic::estimate_size_in_kb() const {
-    return (get_num_heuristic_values() * sizeof(int) +
-            lookup_tables.size() * sizeof(vector<int>)) / 1024.;
+    size_t size_in_bytes = 0;
+    for (const auto &lookup_table : lookup_tables) {
+        size_in_bytes += sizeof(int) + lookup_table.h_values.estimate_memory_in_bytes();
+    }
+    return size_in_bytes / 1024.;
 }
 
 void CostPartitioningHeuristic::mark_useful_abstractions(
@@ -3,6 +3,8 @@
 
 #include "types.h"
 
+#include "../algorithms/compact_int_table.h"
+
 #include <vector>
 
 namespace cost_saturation {
@@ -15,7 +17,8 @@ namespace cost_saturation {
   compute the mapping only once instead of once for each abstraction order.
 
   We call the stored goal distances for an abstraction a lookup table.
-  To save space, we only store lookup tables that contain positive estimates.
+  To save space, we only store lookup tables that contain positive estimates
+  and store each table with the narrowest sufficient integer width.
 */
 class CostPartitioningHeuristic {
     // Allow this class to extract and compress information about unsolvable states.
@@ -25,11 +28,11 @@ class CostPartitioningHeuristic {
         int abstraction_id;
         /* h_values[i] is the goal distance of abstract state i under the cost
            function assigned to the associated abstraction. */
-        std::vector<int> h_values;
+        compact_int_table::CompactIntTable h_values;
 
-        LookupTable(int abstraction_id, std::vector<int> &&h_values)
+        LookupTable(int abstraction_id, const std::vector<int> &h_values)
             : abstraction_id(abstraction_id),
-              h_values(move(h_values)) {
+              h_values(h_values) {
         }
     };
 
@@ -23,7 +23,7 @@ UnsolvabilityHeuristic::UnsolvabilityHeuristic(
     vector<bool> has_unsolvable_states(num_abstractions, false);
     for (const auto &cp : cp_heuristics) {
         for (const auto &lookup_table : cp.lookup_tables) {
-            for (size_t state = 0; state < lookup_table.h_values.size(); ++state) {
+            for (int state = 0; state < lookup_table.h_values.size(); ++state) {
                 if (lookup_table.h_values[state] == INF) {
                     unsolvable[lookup_table.abstraction_id][state] = true;
                     has_unsolvable_states[lookup_table.abstraction_id] = true;
@@ -45,8 +45,13 @@ UnsolvabilityHeuristic::UnsolvabilityHeuristic(
         tables.erase(
             remove_if(tables.begin(), tables.end(),
                       [](const CostPartitioningHeuristic::LookupTable &table) {
-                          return all_of(table.h_values.begin(), table.h_values.end(),
-                                        [](int h) {return h == 0 || h == INF;});
+                          for (int state = 0; state < table.h_values.size(); ++state) {
+                              int h = table.h_values[state];
+                              if (h != 0 && h != INF) {
+                                  return false;
+                              }
+                          }
+                          return true;
                       }), tables.end());
         tables.shrink_to_fit();
     }
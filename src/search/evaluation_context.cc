@@ -45,6 +45,7 @@ EvaluationContext::EvaluationContext(
 const EvaluationResult &EvaluationContext::get_result(Evaluator *evaluator) {
     EvaluationResult &result = cache[evaluator];
     if (result.is_uninitialized()) {
+        utils::ScopedProfileTimer timer(evaluator->get_compute_result_profile());
         result = evaluator->compute_result(*this);
         if (statistics &&
             evaluator->is_used_for_counting_evaluations() &&
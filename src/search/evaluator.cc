@@ -14,7 +14,10 @@ Evaluator::Evaluator(const options::Options &opts,
                      bool use_for_reporting_minima,
                      bool use_for_boosting,
                      bool use_for_counting_evaluations)
-    : description(opts.get_unparsed_config()),
+    : compute_result_profile(
+          utils::register_profile_entry(
+              opts.get_unparsed_config(), "compute_result")),
+      description(opts.get_unparsed_config()),
       use_for_reporting_minima(use_for_reporting_minima),
       use_for_boosting(use_for_boosting),
       use_for_counting_evaluations(use_for_counting_evaluations),
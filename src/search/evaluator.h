@@ -4,6 +4,7 @@
 #include "evaluation_result.h"
 
 #include "../utils/logging.h"
+#include "../utils/profiling.h"
 
 #include <set>
 
@@ -16,6 +17,8 @@ class Options;
 }
 
 class Evaluator {
+    // Measures the calls to compute_result (see EvaluationContext).
+    utils::ProfileEntry *compute_result_profile;
 protected:
     std::string description;
     bool use_for_reporting_minima;
@@ -92,6 +95,9 @@ public:
     virtual void notify_progress() {}
 
     const std::string &get_description() const;
+    utils::ProfileEntry *get_compute_result_profile() const {
+        return compute_result_profile;
+    }
     bool is_used_for_reporting_minima() const;
     bool is_used_for_boosting() const;
     bool is_used_for_counting_evaluations() const;
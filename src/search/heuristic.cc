@@ -4,6 +4,7 @@
 #include "evaluation_result.h"
 #include "option_parser.h"
 #include "plugin.h"
+#include "state_registry.h"
 
 #include "task_utils/task_properties.h"
 #include "tasks/cost_adapted_task.h"
@@ -19,6 +20,7 @@ Heuristic::Heuristic(const Options &opts)
     : Evaluator(opts, true, true, true),
       heuristic_cache(HEntry(NO_VALUE, true)), //TODO: is true really a good idea here?
       cache_evaluator_values(opts.get<bool>("cache_estimates")),
+      preferred_operators_cache(-1),
       task(opts.get<shared_ptr<AbstractTask>>("transform")),
       task_proxy(*task) {
 }
@@ -54,14 +56,35 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
 
     int heuristic = NO_VALUE;
 
-    if (!calculate_preferred && cache_evaluator_values &&
-        heuristic_cache[state].h != NO_VALUE && !heuristic_cache[state].dirty) {
+    bool cache_preferred_operators = cache_evaluator_values &&
+        state.get_registry()->is_shared();
+
+    if (cache_evaluator_values &&
+        heuristic_cache[state].h != NO_VALUE && !heuristic_cache[state].dirty &&
+        (!calculate_preferred ||
+         (cache_preferred_operators && preferred_operators_cache[state] != -1))) {
         heuristic = heuristic_cache[state].h;
+        if (calculate_preferred) {
+            int pos = preferred_operators_cache[state];
+            int num_operators = cached_preferred_operators[pos];
+            for (int i = pos + 1; i <= pos + num_operators; ++i) {
+                preferred_operators.insert(OperatorID(cached_preferred_operators[i]));
+            }
+        }
         result.set_count_evaluation(false);
     } else {
         heuristic = compute_heuristic(state);
         if (cache_evaluator_values) {
             heuristic_cache[state] = HEntry(heuristic, false);
+            if (cache_preferred_operators && calculate_preferred) {
+                preferred_operators_cache[state] = cached_preferred_operators.size();
+                cached_preferred_operators.push_back(preferred_operators.size());
+                for (OperatorID op_id : preferred_operators) {
+                    cached_preferred_operators.push_back(op_id.get_index());
+                }
+            } else if (cache_preferred_operators) {
+                preferred_operators_cache[state] = -1;
+            }
         }
         result.set_count_evaluation(true);
     }
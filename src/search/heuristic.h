@@ -54,6 +54,20 @@ protected:
     PerStateInformation<HEntry> heuristic_cache;
     bool cache_evaluator_values;
 
+    /*
+      For states in shared registries (see SharedStateRegistryScope), we
+      also cache the preferred operators, so that later phases of an
+      iterated search can reuse the estimates when they request preferred
+      operators. If the preferred operators of a state with a cached
+      estimate have been computed, preferred_operators_cache holds the
+      position of the number of preferred operators in
+      cached_preferred_operators, followed by the operator IDs. Otherwise,
+      it holds -1. For other registries, both stay empty and we recompute
+      the estimate whenever preferred operators are requested.
+    */
+    PerStateInformation<int> preferred_operators_cache;
+    std::vector<int> cached_preferred_operators;
+
     // Hold a reference to the task implementation and pass it to objects that need it.
     const std::shared_ptr<AbstractTask> task;
     // Use task_proxy to access task information.
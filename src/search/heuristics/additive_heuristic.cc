@@ -6,6 +6,7 @@
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 
@@ -13,14 +14,26 @@ using namespace std;
 
 namespace additive_heuristic {
 const int AdditiveHeuristic::MAX_COST_VALUE;
+static const int UNTOUCHED = -2;
 
 // construction and destruction
 AdditiveHeuristic::AdditiveHeuristic(const Options &opts)
     : RelaxationHeuristic(opts),
-      did_write_overflow_warning(false) {
+      did_write_overflow_warning(false),
+      incremental(opts.get<bool>("incremental")),
+      incremental_overflow(false) {
     if (log.is_at_least_normal()) {
         log << "Initializing additive heuristic..." << endl;
     }
+    if (incremental) {
+        achievers.resize(propositions.size());
+        for (const UnaryOperator &op : unary_operators) {
+            achievers[op.effect].push_back(get_op_id(op));
+        }
+        old_costs.assign(propositions.size(), UNTOUCHED);
+        is_affected.assign(propositions.size(), false);
+        is_dirty.assign(unary_operators.size(), false);
+    }
 }
 
 void AdditiveHeuristic::write_overflow_warning() {
@@ -41,18 +54,17 @@ void AdditiveHeuristic::write_overflow_warning() {
 void AdditiveHeuristic::setup_exploration_queue() {
     queue.clear();
 
-    for (Proposition &prop : propositions) {
-        prop.cost = -1;
-        prop.marked = false;
-    }
+    fill(proposition_costs.begin(), proposition_costs.end(), -1);
+    fill(marked.begin(), marked.end(), false);
 
-    // Deal with operators and axioms without preconditions.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.num_preconditions;
-        op.cost = op.base_cost; // will be increased by precondition costs
+    unsatisfied_preconditions = initial_unsatisfied_preconditions;
+    // Will be increased by precondition costs.
+    operator_costs = initial_operator_costs;
 
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost, get_op_id(op));
+    // Deal with operators and axioms without preconditions.
+    for (OpID op_id : operators_without_preconditions) {
+        const UnaryOperator &op = unary_operators[op_id];
+        enqueue_if_necessary(op.effect, op.base_cost, op_id);
     }
 }
 
@@ -63,45 +75,45 @@ void AdditiveHeuristic::setup_exploration_queue_state(const State &state) {
     }
 }
 
-void AdditiveHeuristic::relaxed_exploration() {
-    int unsolved_goals = goal_propositions.size();
+void AdditiveHeuristic::relaxed_exploration(bool stop_at_goals) {
+    int unsolved_goals = stop_at_goals ? goal_propositions.size() : -1;
     while (!queue.empty()) {
         pair<int, PropID> top_pair = queue.pop();
         int distance = top_pair.first;
         PropID prop_id = top_pair.second;
-        Proposition *prop = get_proposition(prop_id);
-        int prop_cost = prop->cost;
+        int prop_cost = proposition_costs[prop_id];
         assert(prop_cost >= 0);
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
+        const Proposition *prop = get_proposition(prop_id);
         if (prop->is_goal && --unsolved_goals == 0)
             return;
         for (OpID op_id : precondition_of_pool.get_slice(
                  prop->precondition_of, prop->num_precondition_occurences)) {
-            UnaryOperator *unary_op = get_operator(op_id);
-            increase_cost(unary_op->cost, prop_cost);
-            --unary_op->unsatisfied_preconditions;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect,
-                                     unary_op->cost, op_id);
+            int &op_cost = operator_costs[op_id];
+            increase_cost(op_cost, prop_cost);
+            int &unsatisfied = unsatisfied_preconditions[op_id];
+            --unsatisfied;
+            assert(unsatisfied >= 0);
+            if (unsatisfied == 0)
+                enqueue_if_necessary(unary_operators[op_id].effect,
+                                     op_cost, op_id);
         }
     }
 }
 
 void AdditiveHeuristic::mark_preferred_operators(
     const State &state, PropID goal_id) {
-    Proposition *goal = get_proposition(goal_id);
-    if (!goal->marked) { // Only consider each subgoal once.
-        goal->marked = true;
-        OpID op_id = goal->reached_by;
+    if (!marked[goal_id]) { // Only consider each subgoal once.
+        marked[goal_id] = true;
+        OpID op_id = reached_by[goal_id];
         if (op_id != NO_OP) { // We have not yet chained back to a start node.
             UnaryOperator *unary_op = get_operator(op_id);
             bool is_preferred = true;
             for (PropID precond : get_preconditions(op_id)) {
                 mark_preferred_operators(state, precond);
-                if (get_proposition(precond)->reached_by != NO_OP) {
+                if (reached_by[precond] != NO_OP) {
                     is_preferred = false;
                 }
             }
@@ -116,15 +128,192 @@ void AdditiveHeuristic::mark_preferred_operators(
     }
 }
 
-int AdditiveHeuristic::compute_add_and_ff(const State &state) {
+void AdditiveHeuristic::compute_fixpoint(const State &state) {
     setup_exploration_queue();
     setup_exploration_queue_state(state);
-    relaxed_exploration();
+    relaxed_exploration(false);
+    /*
+      Clamped operator costs cannot be repaired incrementally, so we
+      recompute the fixpoint from scratch until no clamping occurs.
+    */
+    incremental_overflow = false;
+    for (int op_cost : operator_costs) {
+        if (op_cost >= MAX_COST_VALUE) {
+            incremental_overflow = true;
+            break;
+        }
+    }
+    int num_variables = task_proxy.get_variables().size();
+    fixpoint_state_values.resize(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        fixpoint_state_values[var] = state[var].get_value();
+    }
+}
+
+void AdditiveHeuristic::decrease_cost(PropID prop_id, int cost, OpID op_id) {
+    int &prop_cost = proposition_costs[prop_id];
+    if (prop_cost == -1 || prop_cost > cost) {
+        if (old_costs[prop_id] == UNTOUCHED) {
+            old_costs[prop_id] = prop_cost;
+            touched_propositions.push_back(prop_id);
+        }
+        if (cost > MAX_COST_VALUE) {
+            incremental_overflow = true;
+        }
+        prop_cost = cost;
+        reached_by[prop_id] = op_id;
+        queue.push(cost, prop_id);
+    }
+}
+
+void AdditiveHeuristic::clear_incremental_data() {
+    for (PropID prop_id : touched_propositions) {
+        old_costs[prop_id] = UNTOUCHED;
+    }
+    touched_propositions.clear();
+    for (PropID prop_id : affected_propositions) {
+        is_affected[prop_id] = false;
+    }
+    affected_propositions.clear();
+    for (OpID op_id : dirty_operators) {
+        is_dirty[op_id] = false;
+    }
+    dirty_operators.clear();
+}
+
+/*
+  Repair the stored fixpoint for the given state. Return false if the
+  fixpoint has to be recomputed from scratch.
+*/
+bool AdditiveHeuristic::update_fixpoint(const State &state) {
+    removed_propositions.clear();
+    added_propositions.clear();
+    int num_variables = fixpoint_state_values.size();
+    for (int var = 0; var < num_variables; ++var) {
+        int value = state[var].get_value();
+        int &old_value = fixpoint_state_values[var];
+        if (value != old_value) {
+            removed_propositions.push_back(get_prop_id(var, old_value));
+            added_propositions.push_back(get_prop_id(var, value));
+            old_value = value;
+        }
+    }
+
+    /*
+      Collect the affected cone: removed facts and all propositions whose
+      supporter has an affected precondition. All unary operators with an
+      affected precondition become dirty.
+    */
+    size_t max_affected = propositions.size() / 2;
+    for (PropID prop_id : removed_propositions) {
+        is_affected[prop_id] = true;
+        affected_propositions.push_back(prop_id);
+    }
+    for (size_t i = 0; i < affected_propositions.size(); ++i) {
+        const Proposition *prop = get_proposition(affected_propositions[i]);
+        for (OpID op_id : precondition_of_pool.get_slice(
+                 prop->precondition_of, prop->num_precondition_occurences)) {
+            if (!is_dirty[op_id]) {
+                is_dirty[op_id] = true;
+                dirty_operators.push_back(op_id);
+            }
+            PropID effect = unary_operators[op_id].effect;
+            if (unsatisfied_preconditions[op_id] == 0 &&
+                reached_by[effect] == op_id && !is_affected[effect]) {
+                is_affected[effect] = true;
+                affected_propositions.push_back(effect);
+            }
+        }
+        if (affected_propositions.size() > max_affected) {
+            clear_incremental_data();
+            return false;
+        }
+    }
+
+    for (PropID prop_id : affected_propositions) {
+        proposition_costs[prop_id] = -1;
+        reached_by[prop_id] = NO_OP;
+        old_costs[prop_id] = -1;
+        touched_propositions.push_back(prop_id);
+    }
+
+    // Recompute the dirty operators from their unaffected preconditions.
+    for (OpID op_id : dirty_operators) {
+        int &op_cost = operator_costs[op_id];
+        int &unsatisfied = unsatisfied_preconditions[op_id];
+        op_cost = initial_operator_costs[op_id];
+        unsatisfied = 0;
+        for (PropID precond : get_preconditions(op_id)) {
+            int precond_cost = proposition_costs[precond];
+            if (precond_cost == -1) {
+                ++unsatisfied;
+            } else {
+                op_cost += precond_cost;
+            }
+        }
+    }
+
+    queue.clear();
+    for (PropID prop_id : added_propositions) {
+        decrease_cost(prop_id, 0, NO_OP);
+    }
+    for (PropID prop_id : affected_propositions) {
+        for (OpID op_id : achievers[prop_id]) {
+            if (!is_dirty[op_id] && unsatisfied_preconditions[op_id] == 0) {
+                decrease_cost(prop_id, operator_costs[op_id], op_id);
+            }
+        }
+    }
+
+    /*
+      Propagate the new costs. The costs of the unary operators contain the
+      old costs of the preconditions unless these were unreachable or
+      affected, so we add either the difference or the full new cost.
+    */
+    while (!queue.empty()) {
+        pair<int, PropID> top_pair = queue.pop();
+        int distance = top_pair.first;
+        PropID prop_id = top_pair.second;
+        if (proposition_costs[prop_id] < distance)
+            continue;
+        int old_cost = old_costs[prop_id];
+        assert(old_cost != UNTOUCHED);
+        const Proposition *prop = get_proposition(prop_id);
+        for (OpID op_id : precondition_of_pool.get_slice(
+                 prop->precondition_of, prop->num_precondition_occurences)) {
+            int &op_cost = operator_costs[op_id];
+            int &unsatisfied = unsatisfied_preconditions[op_id];
+            if (old_cost == -1) {
+                op_cost += distance;
+                --unsatisfied;
+                assert(unsatisfied >= 0);
+            } else {
+                op_cost += distance - old_cost;
+            }
+            if (unsatisfied == 0)
+                decrease_cost(unary_operators[op_id].effect, op_cost, op_id);
+        }
+    }
+    clear_incremental_data();
+    return !incremental_overflow;
+}
+
+int AdditiveHeuristic::compute_add_and_ff(const State &state) {
+    if (!incremental) {
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        relaxed_exploration();
+    } else {
+        if (fixpoint_state_values.empty() || incremental_overflow ||
+            !update_fixpoint(state)) {
+            compute_fixpoint(state);
+        }
+        fill(marked.begin(), marked.end(), false);
+    }
 
     int total_cost = 0;
     for (PropID goal_id : goal_propositions) {
-        const Proposition *goal = get_proposition(goal_id);
-        int goal_cost = goal->cost;
+        int goal_cost = proposition_costs[goal_id];
         if (goal_cost == -1)
             return DEAD_END;
         increase_cost(total_cost, goal_cost);
@@ -146,6 +335,17 @@ void AdditiveHeuristic::compute_heuristic_for_cegar(const State &state) {
     compute_heuristic(state);
 }
 
+void add_incremental_option_to_parser(OptionParser &parser) {
+    parser.add_option<bool>(
+        "incremental",
+        "repair the h^add costs of the previously evaluated state instead of "
+        "recomputing them from scratch (falls back to a full computation if "
+        "the states differ too much). The h^add values are unchanged, but "
+        "ties between cheapest supporters can be broken differently, which "
+        "can change FF values and preferred operators.",
+        "false");
+}
+
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis("Additive heuristic", "");
     parser.document_language_support("action costs", "supported");
@@ -161,6 +361,7 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_property("preferred operators", "yes");
 
     Heuristic::add_options_to_parser(parser);
+    add_incremental_option_to_parser(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
         return nullptr;
@@ -10,6 +10,10 @@
 
 class State;
 
+namespace options {
+class OptionParser;
+}
+
 namespace additive_heuristic {
 using relaxation_heuristic::PropID;
 using relaxation_heuristic::OpID;
@@ -32,20 +36,50 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
     priority_queues::AdaptiveQueue<PropID> queue;
     bool did_write_overflow_warning;
 
+    /*
+      Incremental evaluation: we keep the complete h^add fixpoint of the
+      last evaluated state (in the propositions and unary operators) and
+      repair it for the next state. Propositions whose cheapest supporter
+      depends on a fact that is no longer true form the affected cone: they
+      are reset and recomputed, while cost decreases (e.g., from new facts)
+      are propagated Dijkstra-style from the changed propositions only. If
+      the cone grows too large, we recompute the fixpoint from scratch.
+    */
+    const bool incremental;
+    // Values of the state for which the fixpoint is stored (empty if none).
+    std::vector<int> fixpoint_state_values;
+    // Unary operators by effect.
+    std::vector<std::vector<OpID>> achievers;
+    // Cost before the current update, UNTOUCHED or -1 if not counted in
+    // the costs of the unary operators.
+    std::vector<int> old_costs;
+    std::vector<PropID> touched_propositions;
+    std::vector<bool> is_affected;
+    std::vector<PropID> affected_propositions;
+    std::vector<bool> is_dirty;
+    std::vector<OpID> dirty_operators;
+    std::vector<PropID> removed_propositions;
+    std::vector<PropID> added_propositions;
+    bool incremental_overflow;
+
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
-    void relaxed_exploration();
+    void relaxed_exploration(bool stop_at_goals = true);
+    void compute_fixpoint(const State &state);
+    bool update_fixpoint(const State &state);
+    void clear_incremental_data();
+    void decrease_cost(PropID prop_id, int cost, OpID op_id);
     void mark_preferred_operators(const State &state, PropID goal_id);
 
     void enqueue_if_necessary(PropID prop_id, int cost, OpID op_id) {
         assert(cost >= 0);
-        Proposition *prop = get_proposition(prop_id);
-        if (prop->cost == -1 || prop->cost > cost) {
-            prop->cost = cost;
-            prop->reached_by = op_id;
+        int &prop_cost = proposition_costs[prop_id];
+        if (prop_cost == -1 || prop_cost > cost) {
+            prop_cost = cost;
+            reached_by[prop_id] = op_id;
             queue.push(cost, prop_id);
         }
-        assert(prop->cost != -1 && prop->cost <= cost);
+        assert(prop_cost != -1 && prop_cost <= cost);
     }
 
     void increase_cost(int &cost, int amount) {
@@ -76,9 +110,11 @@ public:
     void compute_heuristic_for_cegar(const State &state);
 
     int get_cost_for_cegar(int var, int value) const {
-        return get_proposition(var, value)->cost;
+        return proposition_costs[get_prop_id(var, value)];
     }
 };
+
+extern void add_incremental_option_to_parser(options::OptionParser &parser);
 }
 
 #endif
@@ -4,28 +4,48 @@
 
 #include "../task_utils/causal_graph.h"
 #include "../utils/collections.h"
+#include "../utils/hash.h"
 #include "../utils/logging.h"
-#include "../utils/math.h"
 
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <vector>
 
 using namespace std;
 
 namespace cg_heuristic {
-const int CGCache::NOT_COMPUTED;
+static const int EMPTY = -1;
+static const size_t MIN_TABLE_SIZE = 1024;
 
-CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size, utils::LogProxy &log)
-    : task_proxy(task_proxy) {
+CGCache::CGCache(
+    const shared_ptr<AbstractTask> &task, int max_memory_in_mb,
+    utils::LogProxy &log)
+    : task(task),
+      log(log),
+      clock_hand(0),
+      num_hits(0),
+      num_misses(0),
+      num_evictions(0),
+      memory_releaser(
+          "CG cache",
+          [this]() {return get_memory_usage();},
+          [this]() {release_memory();}) {
     if (log.is_at_least_normal()) {
         log << "Initializing heuristic cache... " << flush;
     }
 
+    TaskProxy task_proxy(*task);
     int var_count = task_proxy.get_variables().size();
     const causal_graph::CausalGraph &cg = task_proxy.get_causal_graph();
 
+    domain_sizes.reserve(var_count);
+    for (VariableProxy var : task_proxy.get_variables()) {
+        domain_sizes.push_back(var.get_domain_size());
+    }
+
     // Compute inverted causal graph.
     depends_on.resize(var_count);
     for (int var = 0; var < var_count; ++var) {
@@ -54,81 +74,245 @@ CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size, utils::LogProx
                               depends_on[var].end());
     }
 
-    cache.resize(var_count);
-    helpful_transition_cache.resize(var_count);
-
+    // A variable can be cached if the number of possible keys fits into 64 bits.
+    const uint64_t max_key = numeric_limits<uint64_t>::max();
+    cacheable.resize(var_count, false);
+    int num_cacheable = 0;
     for (int var = 0; var < var_count; ++var) {
-        int required_cache_size = compute_required_cache_size(
-            var, depends_on[var], max_cache_size);
-        if (required_cache_size != -1) {
-            cache[var].resize(required_cache_size, NOT_COMPUTED);
-            helpful_transition_cache[var].resize(required_cache_size, nullptr);
+        uint64_t num_keys = domain_sizes[var];
+        bool fits = true;
+        for (int factor : depends_on[var]) {
+            uint64_t domain_size = domain_sizes[factor];
+            if (num_keys > max_key / domain_size) {
+                fits = false;
+                break;
+            }
+            num_keys *= domain_size;
+        }
+        uint64_t num_targets = max(domain_sizes[var] - 1, 1);
+        if (fits && num_keys <= max_key / num_targets) {
+            cacheable[var] = true;
+            ++num_cacheable;
         }
     }
 
+    /*
+      The table size is a power of two with at least two slots per entry.
+      We use the largest table that fits into the memory limit together
+      with the entries for half of its slots. Since the entries vector
+      never grows beyond max_entries (see store()) and the table never
+      grows beyond 2 * max_entries slots, the cache never exceeds the
+      limit (apart from the minimum table size).
+    */
+    uint64_t max_bytes = static_cast<uint64_t>(max_memory_in_mb) * 1024 * 1024;
+    uint64_t max_table_size = MIN_TABLE_SIZE;
+    while (get_memory_usage(max_table_size, 2 * max_table_size) <= max_bytes) {
+        max_table_size *= 2;
+    }
+    max_entries = max_table_size / 2;
+    resize_table(MIN_TABLE_SIZE);
+
     if (log.is_at_least_normal()) {
-        log << "done!" << endl;
+        log << "done! [" << num_cacheable << " of " << var_count
+            << " variables cacheable, at most " << max_entries
+            << " entries]" << endl;
     }
 }
 
 CGCache::~CGCache() {
+    print_statistics();
 }
 
-int CGCache::compute_required_cache_size(
-    int var_id, const vector<int> &depends_on, int max_cache_size) const {
-    /*
-      Compute the size of the cache required for variable with ID "var_id",
-      which depends on the variables in "depends_on". Requires that the caches
-      for all variables in "depends_on" have already been allocated. Returns -1
-      if the variable cannot be cached because the required cache size would be
-      too large.
-    */
+size_t CGCache::get_bucket(int var, uint64_t key) const {
+    utils::HashState hash_state;
+    utils::feed(hash_state, var);
+    utils::feed(hash_state, key);
+    return hash_state.get_hash64() & (table.size() - 1);
+}
 
-    VariablesProxy variables = task_proxy.get_variables();
-    int var_domain = variables[var_id].get_domain_size();
-    if (!utils::is_product_within_limit(var_domain, var_domain - 1,
-                                        max_cache_size))
-        return -1;
+size_t CGCache::find_position(int var, uint64_t key) const {
+    size_t mask = table.size() - 1;
+    size_t pos = get_bucket(var, key);
+    while (table[pos] != EMPTY) {
+        const Entry &entry = entries[table[pos]];
+        if (entry.key == key && entry.var == var)
+            break;
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
 
-    int required_size = var_domain * (var_domain - 1);
+void CGCache::erase_position(size_t pos) {
+    /*
+      Close the gap by moving entries that are not at their home bucket
+      (backward shift deletion). This keeps lookups tombstone-free.
+    */
+    assert(table[pos] != EMPTY);
+    size_t mask = table.size() - 1;
+    size_t hole = pos;
+    size_t next = (hole + 1) & mask;
+    while (table[next] != EMPTY) {
+        const Entry &entry = entries[table[next]];
+        size_t home = get_bucket(entry.var, entry.key);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            table[hole] = table[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    table[hole] = EMPTY;
+}
 
-    for (int depend_var_id : depends_on) {
-        int depend_var_domain = variables[depend_var_id].get_domain_size();
+void CGCache::resize_table(size_t new_size) {
+    assert((new_size & (new_size - 1)) == 0);
+    table.assign(new_size, EMPTY);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const Entry &entry = entries[i];
+        table[find_position(entry.var, entry.key)] = i;
+    }
+}
 
-        /*
-          If var depends on a variable var_i that is not cached, then
-          it cannot be cached. This is possible even if var would have
-          an acceptable cache size because the domain of var_i
-          contributes quadratically to its own cache size but only
-          linearly to the cache size of var.
-        */
-        if (cache[depend_var_id].empty())
-            return -1;
+int CGCache::evict_entry() {
+    // CLOCK: give referenced entries a second chance.
+    while (entries[clock_hand].referenced) {
+        entries[clock_hand].referenced = false;
+        clock_hand = (clock_hand + 1) % entries.size();
+    }
+    int index = clock_hand;
+    clock_hand = (clock_hand + 1) % entries.size();
+    const Entry &entry = entries[index];
+    erase_position(find_position(entry.var, entry.key));
+    ++num_evictions;
+    return index;
+}
 
-        if (!utils::is_product_within_limit(required_size, depend_var_domain,
-                                            max_cache_size))
-            return -1;
+uint64_t CGCache::get_memory_usage(uint64_t num_entries, uint64_t table_size) {
+    return num_entries * sizeof(Entry) + table_size * sizeof(int);
+}
 
-        required_size *= depend_var_domain;
+int CGCache::get_memory_in_mb_for_entries(int num_entries) {
+    uint64_t table_size = MIN_TABLE_SIZE;
+    while (table_size < 2 * static_cast<uint64_t>(num_entries)) {
+        table_size *= 2;
     }
+    uint64_t bytes = get_memory_usage(table_size / 2, table_size);
+    const uint64_t bytes_per_mb = 1024 * 1024;
+    return static_cast<int>(min<uint64_t>(
+        (bytes + bytes_per_mb - 1) / bytes_per_mb, numeric_limits<int>::max()));
+}
 
-    return required_size;
+size_t CGCache::get_memory_usage() const {
+    lock_guard<mutex> lock(cache_mutex);
+    return get_memory_usage(entries.capacity(), table.capacity());
 }
 
-int CGCache::get_index(int var, const State &state,
-                       int from_val, int to_val) const {
+void CGCache::release_memory() {
+    lock_guard<mutex> lock(cache_mutex);
+    vector<Entry>().swap(entries);
+    vector<int>().swap(table);
+    resize_table(MIN_TABLE_SIZE);
+    clock_hand = 0;
+    max_entries = max<size_t>(1, max_entries / 2);
+}
+
+uint64_t CGCache::get_key(
+    int var, const State &state, int from_val, int to_val) const {
     assert(is_cached(var));
     assert(from_val != to_val);
-    int index = from_val;
-    int multiplier = task_proxy.get_variables()[var].get_domain_size();
-    for (int dep_var : depends_on[var]) {
-        index += state[dep_var].get_value() * multiplier;
-        multiplier *= task_proxy.get_variables()[dep_var].get_domain_size();
-    }
+    int domain_size = domain_sizes[var];
     if (to_val > from_val)
         --to_val;
-    index += to_val * multiplier;
-    assert(utils::in_bounds(index, cache[var]));
-    return index;
+    uint64_t key = from_val + static_cast<uint64_t>(to_val) * domain_size;
+    uint64_t multiplier = static_cast<uint64_t>(domain_size) * max(domain_size - 1, 1);
+    for (int dep_var : depends_on[var]) {
+        key += state[dep_var].get_value() * multiplier;
+        multiplier *= domain_sizes[dep_var];
+    }
+    return key;
+}
+
+bool CGCache::lookup(int var, const State &state, int from_val, int to_val,
+                     int &cost, int &helpful_transition) {
+    uint64_t key = get_key(var, state, from_val, to_val);
+    lock_guard<mutex> lock(cache_mutex);
+    int index = table[find_position(var, key)];
+    if (index == EMPTY) {
+        ++num_misses;
+        return false;
+    }
+    ++num_hits;
+    Entry &entry = entries[index];
+    entry.referenced = true;
+    cost = entry.cost;
+    helpful_transition = entry.helpful_transition;
+    return true;
+}
+
+void CGCache::store(int var, const State &state, int from_val, int to_val,
+                    int cost, int helpful_transition) {
+    uint64_t key = get_key(var, state, from_val, to_val);
+    lock_guard<mutex> lock(cache_mutex);
+    size_t pos = find_position(var, key);
+    if (table[pos] != EMPTY) {
+        Entry &entry = entries[table[pos]];
+        entry.cost = cost;
+        entry.helpful_transition = helpful_transition;
+        return;
+    }
+    Entry entry = {key, var, cost, helpful_transition, false};
+    if (entries.size() == max_entries) {
+        int index = evict_entry();
+        entries[index] = entry;
+        table[find_position(var, key)] = index;
+    } else {
+        if (entries.size() == entries.capacity()) {
+            // Don't let vector doubling exceed the memory limit.
+            entries.reserve(min(max<size_t>(2 * entries.size(), 1), max_entries));
+        }
+        entries.push_back(entry);
+        if (2 * entries.size() > table.size()) {
+            resize_table(2 * table.size());
+        } else {
+            table[pos] = entries.size() - 1;
+        }
+    }
+}
+
+void CGCache::print_statistics() const {
+    lock_guard<mutex> lock(cache_mutex);
+    if (log.is_at_least_normal()) {
+        long long num_lookups = num_hits + num_misses;
+        double hit_rate = num_lookups ? 100.0 * num_hits / num_lookups : 0.0;
+        log << "CG cache: " << entries.size() << " entries, "
+            << num_hits << " hits, " << num_misses << " misses (hit rate "
+            << hit_rate << "%), " << num_evictions << " evictions" << endl;
+    }
+}
+
+shared_ptr<CGCache> get_shared_cache(
+    const shared_ptr<AbstractTask> &task, int max_memory_in_mb,
+    utils::LogProxy &log) {
+    static mutex registry_mutex;
+    static map<pair<const AbstractTask *, int>, weak_ptr<CGCache>> caches;
+    lock_guard<mutex> lock(registry_mutex);
+    // Forget caches that are not used anymore.
+    for (auto it = caches.begin(); it != caches.end();) {
+        if (it->second.expired()) {
+            it = caches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    weak_ptr<CGCache> &weak_cache = caches[make_pair(task.get(), max_memory_in_mb)];
+    shared_ptr<CGCache> cache = weak_cache.lock();
+    if (cache) {
+        if (log.is_at_least_normal()) {
+            log << "Reusing heuristic cache of another CG heuristic." << endl;
+        }
+    } else {
+        cache = make_shared<CGCache>(task, max_memory_in_mb, log);
+        weak_cache = cache;
+    }
+    return cache;
 }
 }
@@ -3,58 +3,111 @@
 
 #include "../task_proxy.h"
 
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <vector>
 
-namespace domain_transition_graph {
-struct ValueTransitionLabel;
-}
-
-namespace utils {
-class LogProxy;
-}
+class AbstractTask;
 
 namespace cg_heuristic {
+/*
+  Cache for the transition costs and helpful transitions computed by the
+  causal graph heuristic.
+
+  The cost of changing variable var from one value to another only depends
+  on the values of the variables that var (transitively) depends on in the
+  reduced causal graph. We pack these values together with the start and
+  target value into a single 64-bit key (mixed-radix encoding). Variables
+  for which the key does not fit into 64 bits are not cached.
+
+  All entries live in one table whose size is bounded by a memory limit.
+  When the table is full, we evict entries with the CLOCK algorithm, an
+  approximation of least-recently-used eviction. Helpful transitions are
+  stored as indices into the list of labels of the variable's domain
+  transition graph (see CGHeuristic), which makes it possible to share a
+  cache between all CG heuristics for the same task (see get_shared_cache).
+  All public methods are thread-safe.
+
+  Under memory pressure (see utils::MemoryReleaser), we drop all entries
+  and halve the maximum number of entries.
+*/
 class CGCache {
-    TaskProxy task_proxy;
-    std::vector<std::vector<int>> cache;
-    std::vector<std::vector<domain_transition_graph::ValueTransitionLabel *>> helpful_transition_cache;
+    struct Entry {
+        std::uint64_t key;
+        int var;
+        int cost;
+        int helpful_transition;
+        bool referenced;
+    };
+
+    const std::shared_ptr<AbstractTask> task;
+    mutable utils::LogProxy log;
+    std::vector<int> domain_sizes;
+    // Variables on which the transition costs of each variable depend.
     std::vector<std::vector<int>> depends_on;
+    std::vector<bool> cacheable;
 
-    int get_index(int var, const State &state, int from_val, int to_val) const;
-    int compute_required_cache_size(
-        int var_id, const std::vector<int> &depends_on, int max_cache_size) const;
-public:
-    static const int NOT_COMPUTED = -2;
+    std::vector<Entry> entries;
+    // Open addressing table (linear probing) with indices into entries.
+    std::vector<int> table;
+    std::size_t max_entries;
+    std::size_t clock_hand;
 
-    CGCache(const TaskProxy &task_proxy, int max_cache_size, utils::LogProxy &log);
+    long long num_hits;
+    long long num_misses;
+    long long num_evictions;
+
+    mutable std::mutex cache_mutex;
+    utils::MemoryReleaser memory_releaser;
+
+    std::size_t get_bucket(int var, std::uint64_t key) const;
+    std::size_t find_position(int var, std::uint64_t key) const;
+    void erase_position(std::size_t pos);
+    void resize_table(std::size_t new_size);
+    int evict_entry();
+    static std::uint64_t get_memory_usage(
+        std::uint64_t num_entries, std::uint64_t table_size);
+    std::size_t get_memory_usage() const;
+    void release_memory();
+    std::uint64_t get_key(
+        int var, const State &state, int from_val, int to_val) const;
+public:
+    CGCache(const std::shared_ptr<AbstractTask> &task, int max_memory_in_mb,
+            utils::LogProxy &log);
     ~CGCache();
 
     bool is_cached(int var) const {
-        return !cache[var].empty();
+        return cacheable[var];
     }
 
-    int lookup(int var, const State &state, int from_val, int to_val) const {
-        return cache[var][get_index(var, state, from_val, to_val)];
-    }
+    /*
+      If the cache contains an entry for the given transition in the
+      given state, set cost and helpful_transition and return true.
+      helpful_transition is -1 if the target is unreachable.
+    */
+    bool lookup(int var, const State &state, int from_val, int to_val,
+                int &cost, int &helpful_transition);
 
-    void store(int var, const State &state,
-               int from_val, int to_val, int cost) {
-        cache[var][get_index(var, state, from_val, to_val)] = cost;
-    }
+    void store(int var, const State &state, int from_val, int to_val,
+               int cost, int helpful_transition);
 
-    domain_transition_graph::ValueTransitionLabel *lookup_helpful_transition(
-        int var, const State &state, int from_val, int to_val) const {
-        int index = get_index(var, state, from_val, to_val);
-        return helpful_transition_cache[var][index];
-    }
+    void print_statistics() const;
 
-    void store_helpful_transition(
-        int var, const State &state, int from_val, int to_val,
-        domain_transition_graph::ValueTransitionLabel *helpful_transition) {
-        int index = get_index(var, state, from_val, to_val);
-        helpful_transition_cache[var][index] = helpful_transition;
-    }
+    // Return the memory limit that allows storing num_entries entries.
+    static int get_memory_in_mb_for_entries(int num_entries);
 };
+
+/*
+  Return the cache for the given task and memory limit. Heuristics that
+  ask for the same task and limit share a single cache.
+*/
+extern std::shared_ptr<CGCache> get_shared_cache(
+    const std::shared_ptr<AbstractTask> &task, int max_memory_in_mb,
+    utils::LogProxy &log);
 }
 
 #endif
@@ -20,17 +20,24 @@ using namespace domain_transition_graph;
 namespace cg_heuristic {
 CGHeuristic::CGHeuristic(const Options &opts)
     : Heuristic(opts),
-      cache_hits(0),
-      cache_misses(0),
       helpful_transition_extraction_counter(0),
       min_action_cost(task_properties::get_min_operator_cost(task_proxy)) {
     if (log.is_at_least_normal()) {
         log << "Initializing causal graph heuristic..." << endl;
     }
 
+    int max_cache_memory = opts.get<int>("max_cache_memory");
     int max_cache_size = opts.get<int>("max_cache_size");
-    if (max_cache_size > 0)
-        cache = utils::make_unique_ptr<CGCache>(task_proxy, max_cache_size, log);
+    if (max_cache_size >= 0) {
+        max_cache_memory = (max_cache_size == 0) ? 0 :
+            CGCache::get_memory_in_mb_for_entries(max_cache_size);
+        if (log.is_warning()) {
+            log << "Warning: max_cache_size is deprecated, use "
+                << "max_cache_memory=" << max_cache_memory << " instead." << endl;
+        }
+    }
+    if (max_cache_memory > 0)
+        cache = get_shared_cache(task, max_cache_memory, log);
 
     unsigned int num_vars = task_proxy.get_variables().size();
     prio_queues.reserve(num_vars);
@@ -41,6 +48,22 @@ CGHeuristic::CGHeuristic(const Options &opts)
         [](int dtg_var, int cond_var) {return dtg_var <= cond_var;};
     DTGFactory factory(task_proxy, false, pruning_condition);
     transition_graphs = factory.build_dtgs();
+
+    if (cache) {
+        labels.resize(num_vars);
+        label_ids.resize(num_vars);
+        for (auto &dtg : transition_graphs) {
+            int var = dtg->var;
+            for (ValueNode &node : dtg->nodes) {
+                for (ValueTransition &transition : node.transitions) {
+                    for (ValueTransitionLabel &label : transition.labels) {
+                        label_ids[var][&label] = labels[var].size();
+                        labels[var].push_back(&label);
+                    }
+                }
+            }
+        }
+    }
 }
 
 CGHeuristic::~CGHeuristic() {
@@ -94,13 +117,12 @@ int CGHeuristic::get_transition_cost(const State &state,
     // Check cache.
     bool use_the_cache = cache && cache->is_cached(var_no);
     if (use_the_cache) {
-        int cached_val = cache->lookup(var_no, state, start_val, goal_val);
-        if (cached_val != CGCache::NOT_COMPUTED) {
-            ++cache_hits;
-            return cached_val;
+        int cached_cost;
+        int helpful_transition;
+        if (cache->lookup(var_no, state, start_val, goal_val,
+                          cached_cost, helpful_transition)) {
+            return cached_cost;
         }
-    } else {
-        ++cache_misses;
     }
 
     ValueNode *start = &dtg->nodes[start_val];
@@ -206,23 +228,29 @@ int CGHeuristic::get_transition_cost(const State &state,
     }
 
     if (use_the_cache) {
-        int num_values = start->distances.size();
-        for (int val = 0; val < num_values; ++val) {
-            if (val == start_val)
-                continue;
-            int distance = start->distances[val];
-            ValueTransitionLabel *helpful = start->helpful_transitions[val];
-            // We should have a helpful transition iff distance is infinite.
-            assert((distance == numeric_limits<int>::max()) == !helpful);
-            cache->store(var_no, state, start_val, val, distance);
-            cache->store_helpful_transition(
-                var_no, state, start_val, val, helpful);
-        }
+        store_in_cache(state, dtg, start_val);
     }
 
     return start->distances[goal_val];
 }
 
+void CGHeuristic::store_in_cache(
+    const State &state, DomainTransitionGraph *dtg, int start_val) {
+    int var_no = dtg->var;
+    const ValueNode &start = dtg->nodes[start_val];
+    int num_values = start.distances.size();
+    for (int val = 0; val < num_values; ++val) {
+        if (val == start_val)
+            continue;
+        int distance = start.distances[val];
+        ValueTransitionLabel *helpful = start.helpful_transitions[val];
+        // We should have a helpful transition iff distance is finite.
+        assert((distance == numeric_limits<int>::max()) == !helpful);
+        int helpful_id = helpful ? label_ids[var_no][helpful] : -1;
+        cache->store(var_no, state, start_val, val, distance, helpful_id);
+    }
+}
+
 void CGHeuristic::mark_helpful_transitions(const State &state,
                                            DomainTransitionGraph *dtg, int to) {
     int var_no = dtg->var;
@@ -256,17 +284,26 @@ void CGHeuristic::mark_helpful_transitions(const State &state,
 
     ValueTransitionLabel *helpful;
     int cost;
+    int helpful_id;
     // Check cache.
-    if (cache && cache->is_cached(var_no)) {
-        helpful = cache->lookup_helpful_transition(var_no, state, from, to);
-        cost = cache->lookup(var_no, state, from, to);
-        assert(helpful);
+    if (cache && cache->is_cached(var_no) &&
+        cache->lookup(var_no, state, from, to, cost, helpful_id)) {
+        assert(helpful_id != -1);
+        helpful = labels[var_no][helpful_id];
     } else {
         ValueNode *start_node = &dtg->nodes[from];
-        assert(!start_node->helpful_transitions.empty());
+        if (start_node->helpful_transitions.empty()) {
+            /*
+              The cost was looked up in the cache, but the entry has been
+              evicted since then, so we have to compute it again.
+            */
+            assert(cache);
+            get_transition_cost(state, dtg, from, to);
+        }
         helpful = start_node->helpful_transitions[to];
         cost = start_node->distances[to];
     }
+    assert(helpful);
 
     OperatorProxy op = helpful->is_axiom ?
         task_proxy.get_axioms()[helpful->op_id] :
@@ -302,10 +339,21 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_property("preferred operators", "yes");
 
     parser.add_option<int>(
-        "max_cache_size",
-        "maximum number of cached entries per variable (set to 0 to disable cache)",
-        "1000000",
+        "max_cache_memory",
+        "maximum memory in MiB for cached transition costs (set to 0 to "
+        "disable the cache). When the cache is full, the least recently "
+        "used entries (approximately) are evicted. All CG heuristics for "
+        "the same task with the same limit share one cache.",
+        "100",
         Bounds("0", "infinity"));
+    parser.add_option<int>(
+        "max_cache_size",
+        "deprecated, use max_cache_memory instead. If set, this overrides "
+        "max_cache_memory with the memory needed for the given number of "
+        "entries (0 disables the cache). Previously, this was the number of "
+        "entries per variable.",
+        "-1",
+        Bounds("-1", "infinity"));
 
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
@@ -4,6 +4,7 @@
 #include "../heuristic.h"
 
 #include "../algorithms/priority_queues.h"
+#include "../utils/hash.h"
 
 #include <memory>
 #include <string>
@@ -12,6 +13,7 @@
 namespace domain_transition_graph {
 class DomainTransitionGraph;
 struct ValueNode;
+struct ValueTransitionLabel;
 }
 
 namespace cg_heuristic {
@@ -22,15 +24,22 @@ class CGHeuristic : public Heuristic {
     std::vector<std::unique_ptr<ValueNodeQueue>> prio_queues;
     std::vector<std::unique_ptr<domain_transition_graph::DomainTransitionGraph>> transition_graphs;
 
-    std::unique_ptr<CGCache> cache;
-    int cache_hits;
-    int cache_misses;
+    std::shared_ptr<CGCache> cache;
+    /*
+      The cache refers to helpful transitions by their index in the list of
+      labels of the variable's domain transition graph.
+    */
+    std::vector<std::vector<domain_transition_graph::ValueTransitionLabel *>> labels;
+    std::vector<utils::HashMap<const domain_transition_graph::ValueTransitionLabel *, int>> label_ids;
 
     int helpful_transition_extraction_counter;
 
     int min_action_cost;
 
     void setup_domain_transition_graphs();
+    void store_in_cache(
+        const State &state, domain_transition_graph::DomainTransitionGraph *dtg,
+        int start_val);
     int get_transition_cost(
         const State &state,
         domain_transition_graph::DomainTransitionGraph *dtg,
@@ -5,6 +5,7 @@
 
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 
@@ -35,16 +36,16 @@ HSPMaxHeuristic::HSPMaxHeuristic(const Options &opts)
 void HSPMaxHeuristic::setup_exploration_queue() {
     queue.clear();
 
-    for (Proposition &prop : propositions)
-        prop.cost = -1;
+    fill(proposition_costs.begin(), proposition_costs.end(), -1);
 
-    // Deal with operators and axioms without preconditions.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.num_preconditions;
-        op.cost = op.base_cost; // will be increased by precondition costs
+    unsatisfied_preconditions = initial_unsatisfied_preconditions;
+    // Will be increased by precondition costs.
+    operator_costs = initial_operator_costs;
 
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost);
+    // Deal with operators and axioms without preconditions.
+    for (OpID op_id : operators_without_preconditions) {
+        const UnaryOperator &op = unary_operators[op_id];
+        enqueue_if_necessary(op.effect, op.base_cost);
     }
 }
 
@@ -61,23 +62,23 @@ void HSPMaxHeuristic::relaxed_exploration() {
         pair<int, PropID> top_pair = queue.pop();
         int distance = top_pair.first;
         PropID prop_id = top_pair.second;
-        Proposition *prop = get_proposition(prop_id);
-        int prop_cost = prop->cost;
+        int prop_cost = proposition_costs[prop_id];
         assert(prop_cost >= 0);
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
+        const Proposition *prop = get_proposition(prop_id);
         if (prop->is_goal && --unsolved_goals == 0)
             return;
         for (OpID op_id : precondition_of_pool.get_slice(
                  prop->precondition_of, prop->num_precondition_occurences)) {
-            UnaryOperator *unary_op = get_operator(op_id);
-            unary_op->cost = max(unary_op->cost,
-                                 unary_op->base_cost + prop_cost);
-            --unary_op->unsatisfied_preconditions;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect, unary_op->cost);
+            int &op_cost = operator_costs[op_id];
+            op_cost = max(op_cost, initial_operator_costs[op_id] + prop_cost);
+            int &unsatisfied = unsatisfied_preconditions[op_id];
+            --unsatisfied;
+            assert(unsatisfied >= 0);
+            if (unsatisfied == 0)
+                enqueue_if_necessary(unary_operators[op_id].effect, op_cost);
         }
     }
 }
@@ -91,8 +92,7 @@ int HSPMaxHeuristic::compute_heuristic(const State &ancestor_state) {
 
     int total_cost = 0;
     for (PropID goal_id : goal_propositions) {
-        const Proposition *goal = get_proposition(goal_id);
-        int goal_cost = goal->cost;
+        int goal_cost = proposition_costs[goal_id];
         if (goal_cost == -1)
             return DEAD_END;
         total_cost = max(total_cost, goal_cost);
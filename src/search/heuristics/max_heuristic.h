@@ -23,12 +23,12 @@ class HSPMaxHeuristic : public relaxation_heuristic::RelaxationHeuristic {
 
     void enqueue_if_necessary(PropID prop_id, int cost) {
         assert(cost >= 0);
-        Proposition *prop = get_proposition(prop_id);
-        if (prop->cost == -1 || prop->cost > cost) {
-            prop->cost = cost;
+        int &prop_cost = proposition_costs[prop_id];
+        if (prop_cost == -1 || prop_cost > cost) {
+            prop_cost = cost;
             queue.push(cost, prop_id);
         }
-        assert(prop->cost != -1 && prop->cost <= cost);
+        assert(prop_cost != -1 && prop_cost <= cost);
     }
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
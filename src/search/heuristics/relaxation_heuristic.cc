@@ -15,10 +15,7 @@ using namespace std;
 
 namespace relaxation_heuristic {
 Proposition::Proposition()
-    : cost(-1),
-      reached_by(NO_OP),
-      is_goal(false),
-      marked(false),
+    : is_goal(false),
       num_precondition_occurences(-1) {
 }
 
@@ -90,6 +87,21 @@ RelaxationHeuristic::RelaxationHeuristic(const options::Options &opts)
             precondition_of_pool.append(precondition_of_vec);
         propositions[prop_id].num_precondition_occurences = precondition_of_vec.size();
     }
+
+    proposition_costs.resize(num_propositions, -1);
+    reached_by.resize(num_propositions, NO_OP);
+    marked.resize(num_propositions, false);
+    operator_costs.resize(num_unary_ops);
+    unsatisfied_preconditions.resize(num_unary_ops);
+    initial_operator_costs.reserve(num_unary_ops);
+    initial_unsatisfied_preconditions.reserve(num_unary_ops);
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+        const UnaryOperator &op = unary_operators[op_id];
+        initial_operator_costs.push_back(op.base_cost);
+        initial_unsatisfied_preconditions.push_back(op.num_preconditions);
+        if (op.num_preconditions == 0)
+            operators_without_preconditions.push_back(op_id);
+    }
 }
 
 bool RelaxationHeuristic::dead_ends_are_reliable() const {
@@ -22,29 +22,25 @@ using OpID = int;
 
 const OpID NO_OP = -1;
 
+/*
+  Proposition and UnaryOperator only hold the static data of the relaxed
+  task. Everything that changes while exploring from a state lives in the
+  arrays of RelaxationHeuristic below.
+*/
 struct Proposition {
     Proposition();
-    int cost; // used for h^max cost or h^add cost
-    // TODO: Make sure in constructor that reached_by does not overflow.
-    OpID reached_by : 30;
-    /* The following two variables are conceptually bools, but Visual C++ does
-       not support packing ints and bools together in a bitfield. */
-    unsigned int is_goal : 1;
-    unsigned int marked : 1; // used for preferred operators of h^add and h^FF
+    bool is_goal;
     int num_precondition_occurences;
     array_pool::ArrayPoolIndex precondition_of;
 };
 
-static_assert(sizeof(Proposition) == 16, "Proposition has wrong size");
+static_assert(sizeof(Proposition) == 12, "Proposition has wrong size");
 
 struct UnaryOperator {
     UnaryOperator(int num_preconditions,
                   array_pool::ArrayPoolIndex preconditions,
                   PropID effect,
                   int operator_no, int base_cost);
-    int cost; // Used for h^max cost or h^add cost;
-              // includes operator cost (base_cost)
-    int unsatisfied_preconditions;
     PropID effect;
     int base_cost;
     int num_preconditions;
@@ -52,7 +48,7 @@ struct UnaryOperator {
     int operator_no; // -1 for axioms; index into the task's operators otherwise
 };
 
-static_assert(sizeof(UnaryOperator) == 28, "UnaryOperator has wrong size");
+static_assert(sizeof(UnaryOperator) == 20, "UnaryOperator has wrong size");
 
 class RelaxationHeuristic : public Heuristic {
     void build_unary_operators(const OperatorProxy &op);
@@ -68,6 +64,21 @@ protected:
     array_pool::ArrayPool preconditions_pool;
     array_pool::ArrayPool precondition_of_pool;
 
+    /*
+      Exploration data, stored as one array per field (indexed by PropID or
+      OpID). This way, the inner loops only touch the fields they need and
+      resetting the data for a new state boils down to a few block copies.
+    */
+    std::vector<int> proposition_costs; // h^max or h^add cost, -1 if unreached
+    std::vector<OpID> reached_by;
+    std::vector<bool> marked; // used for preferred operators of h^add and h^FF
+    std::vector<int> operator_costs; // includes operator cost (base_cost)
+    std::vector<int> unsatisfied_preconditions;
+    // Values of operator_costs and unsatisfied_preconditions before exploring.
+    std::vector<int> initial_operator_costs;
+    std::vector<int> initial_unsatisfied_preconditions;
+    std::vector<OpID> operators_without_preconditions;
+
     array_pool::ArrayPoolSlice get_preconditions(OpID op_id) const {
         const UnaryOperator &op = unary_operators[op_id];
         return preconditions_pool.get_slice(op.preconditions, op.num_preconditions);
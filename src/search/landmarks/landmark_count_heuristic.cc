@@ -96,7 +96,7 @@ LandmarkCountHeuristic::LandmarkCountHeuristic(const options::Options &opts)
         log << "Landmark graph contains " << lgraph->get_num_edges()
             << " orderings." << endl;
     }
-    lm_status_manager = utils::make_unique_ptr<LandmarkStatusManager>(*lgraph);
+    lm_status_manager = utils::make_unique_ptr<LandmarkStatusManager>(*lgraph, task_proxy);
 
     if (admissible) {
         vector<int> operator_costs = task_properties::get_operator_costs(task_proxy);
@@ -12,119 +12,124 @@
 #include "../utils/logging.h"
 #include "../utils/system.h"
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
 using namespace std;
 using utils::ExitCode;
 
 namespace landmarks {
-// alist = alist \cup other
+// vec = vec \cup other (both sorted), buffer is used as scratch space
 template<typename T>
-void union_with(list<T> &alist, const list<T> &other) {
-    typename list<T>::iterator it1 = alist.begin();
-    typename list<T>::const_iterator it2 = other.begin();
-
-    while ((it1 != alist.end()) && (it2 != other.end())) {
-        if (*it1 < *it2) {
-            ++it1;
-        } else if (*it1 > *it2) {
-            alist.insert(it1, *it2);
-            ++it2;
-        } else {
-            ++it1;
-            ++it2;
-        }
-    }
-    alist.insert(it1, it2, other.end());
+static void union_with(vector<T> &vec, const vector<T> &other,
+                       vector<T> &buffer) {
+    if (other.empty())
+        return;
+    buffer.clear();
+    buffer.reserve(vec.size() + other.size());
+    set_union(vec.begin(), vec.end(), other.begin(), other.end(),
+              back_inserter(buffer));
+    vec.swap(buffer);
 }
 
-// alist = alist \cap other
+// vec = vec \cap other (both sorted)
 template<typename T>
-void intersect_with(list<T> &alist, const list<T> &other) {
-    typename list<T>::iterator it1 = alist.begin(), tmp;
-    typename list<T>::const_iterator it2 = other.begin();
-
-    while ((it1 != alist.end()) && (it2 != other.end())) {
-        if (*it1 < *it2) {
-            tmp = it1;
-            ++tmp;
-            alist.erase(it1);
-            it1 = tmp;
-        } else if (*it1 > *it2) {
+static void intersect_with(vector<T> &vec, const vector<T> &other) {
+    typename vector<T>::iterator out = vec.begin();
+    typename vector<T>::const_iterator it2 = other.begin();
+    for (typename vector<T>::iterator it1 = vec.begin(); it1 != vec.end(); ++it1) {
+        while (it2 != other.end() && *it2 < *it1)
             ++it2;
-        } else {
-            ++it1;
+        if (it2 == other.end())
+            break;
+        if (*it2 == *it1) {
+            *out++ = *it1;
             ++it2;
         }
     }
-    alist.erase(it1, alist.end());
+    vec.erase(out, vec.end());
 }
 
-// alist = alist \setminus other
+// vec = vec \setminus other (both sorted)
 template<typename T>
-void set_minus(list<T> &alist, const list<T> &other) {
-    typename list<T>::iterator it1 = alist.begin(), tmp;
-    typename list<T>::const_iterator it2 = other.begin();
-
-    while ((it1 != alist.end()) && (it2 != other.end())) {
-        if (*it1 < *it2) {
-            ++it1;
-        } else if (*it1 > *it2) {
-            ++it2;
-        } else {
-            tmp = it1;
-            ++tmp;
-            alist.erase(it1);
-            it1 = tmp;
+static void set_minus(vector<T> &vec, const vector<T> &other) {
+    typename vector<T>::iterator out = vec.begin();
+    typename vector<T>::const_iterator it2 = other.begin();
+    for (typename vector<T>::iterator it1 = vec.begin(); it1 != vec.end(); ++it1) {
+        while (it2 != other.end() && *it2 < *it1)
             ++it2;
-        }
+        if (it2 == other.end() || *it2 != *it1)
+            *out++ = *it1;
     }
+    vec.erase(out, vec.end());
 }
 
-// alist = alist \cup {val}
+// vec = vec \cup {val} (vec sorted)
 template<typename T>
-void insert_into(list<T> &alist, const T &val) {
-    typename list<T>::iterator it1 = alist.begin();
-
-    while (it1 != alist.end()) {
-        if (*it1 > val) {
-            alist.insert(it1, val);
-            return;
-        } else if (*it1 < val) {
-            ++it1;
-        } else {
-            return;
-        }
-    }
-    alist.insert(it1, val);
+static void insert_into(vector<T> &vec, const T &val) {
+    typename vector<T>::iterator pos = lower_bound(vec.begin(), vec.end(), val);
+    if (pos == vec.end() || *pos != val)
+        vec.insert(pos, val);
 }
 
 template<typename T>
-static bool contains(list<T> &alist, const T &val) {
-    return find(alist.begin(), alist.end(), val) != alist.end();
+static bool contains(const vector<T> &vec, const T &val) {
+    return binary_search(vec.begin(), vec.end(), val);
 }
 
 
+/*
+  Sets are identified by the sorted indices of their facts, read as digits
+  of a number with base (number of facts + 1). initialize() makes sure that
+  the keys of all sets with at most m facts fit into 64 bits.
+*/
+uint64_t LandmarkFactoryHM::get_fluent_key(const vector<int> &facts) const {
+    uint64_t base = facts_.size() + 1;
+    uint64_t key = 0;
+    for (int fact : facts) {
+        key = key * base + fact + 1;
+    }
+    return key;
+}
+
+int LandmarkFactoryHM::get_set_index(const vector<int> &facts) const {
+    auto it = set_indices_.find(get_fluent_key(facts));
+    assert(it != set_indices_.end());
+    return it->second;
+}
+
+vector<int> LandmarkFactoryHM::get_fact_indices(const vector<FactPair> &facts) const {
+    vector<int> indices;
+    indices.reserve(facts.size());
+    for (const FactPair &fact : facts) {
+        indices.push_back(fact_offsets_[fact.var] + fact.value);
+    }
+    return indices;
+}
+
 // find partial variable assignments with size m or less
-// (look at all the variables in the problem)
-void LandmarkFactoryHM::get_m_sets_(const VariablesProxy &variables, int m, int num_included, int current_var,
-                                    FluentSet &current,
-                                    vector<FluentSet> &subsets) {
+// (look at all the variables in the problem) and store them in the table
+void LandmarkFactoryHM::get_m_sets_(const VariablesProxy &variables,
+                                    int num_included, int current_var,
+                                    vector<int> &current) {
     int num_variables = variables.size();
-    if (num_included == m) {
-        subsets.push_back(current);
+    if (num_included == m_ ||
+        (current_var == num_variables && num_included != 0)) {
+        set_indices_[get_fluent_key(current)] = fluent_begin_.size() - 1;
+        fluent_facts_.insert(fluent_facts_.end(), current.begin(), current.end());
+        fluent_begin_.push_back(fluent_facts_.size());
         return;
     }
     if (current_var == num_variables) {
-        if (num_included != 0) {
-            subsets.push_back(current);
-        }
         return;
     }
     // include a value of current_var in the set
     for (int i = 0; i < variables[current_var].get_domain_size(); ++i) {
         bool use_var = true;
-        FactPair current_var_fact(current_var, i);
-        for (const FactPair &current_fact : current) {
-            if (!interesting(variables, current_var_fact, current_fact)) {
+        int current_var_fact = fact_offsets_[current_var] + i;
+        for (int current_fact : current) {
+            if (!interesting(current_var_fact, current_fact)) {
                 use_var = false;
                 break;
             }
@@ -132,36 +137,35 @@ void LandmarkFactoryHM::get_m_sets_(const VariablesProxy &variables, int m, int
 
         if (use_var) {
             current.push_back(current_var_fact);
-            get_m_sets_(variables, m, num_included + 1, current_var + 1, current, subsets);
+            get_m_sets_(variables, num_included + 1, current_var + 1, current);
             current.pop_back();
         }
     }
     // don't include a value of current_var in the set
-    get_m_sets_(variables, m, num_included, current_var + 1, current, subsets);
+    get_m_sets_(variables, num_included, current_var + 1, current);
 }
 
 // find all size m or less subsets of superset
-void LandmarkFactoryHM::get_m_sets_of_set(const VariablesProxy &variables,
-                                          int m, int num_included,
+void LandmarkFactoryHM::get_m_sets_of_set(int num_included,
                                           int current_var_index,
-                                          FluentSet &current,
-                                          vector<FluentSet> &subsets,
-                                          const FluentSet &superset) {
-    if (num_included == m) {
-        subsets.push_back(current);
+                                          vector<int> &current,
+                                          vector<int> &subsets,
+                                          const vector<int> &superset) {
+    if (num_included == m_) {
+        subsets.push_back(get_set_index(current));
         return;
     }
 
     if (current_var_index == static_cast<int>(superset.size())) {
         if (num_included != 0) {
-            subsets.push_back(current);
+            subsets.push_back(get_set_index(current));
         }
         return;
     }
 
     bool use_var = true;
-    for (const FactPair &fluent : current) {
-        if (!interesting(variables, superset[current_var_index], fluent)) {
+    for (int fluent : current) {
+        if (!interesting(superset[current_var_index], fluent)) {
             use_var = false;
             break;
         }
@@ -170,38 +174,30 @@ void LandmarkFactoryHM::get_m_sets_of_set(const VariablesProxy &variables,
     if (use_var) {
         // include current fluent in the set
         current.push_back(superset[current_var_index]);
-        get_m_sets_of_set(variables, m, num_included + 1, current_var_index + 1, current, subsets, superset);
+        get_m_sets_of_set(num_included + 1, current_var_index + 1, current, subsets, superset);
         current.pop_back();
     }
 
     // don't include current fluent in set
-    get_m_sets_of_set(variables, m, num_included, current_var_index + 1, current, subsets, superset);
+    get_m_sets_of_set(num_included, current_var_index + 1, current, subsets, superset);
 }
 
 // get subsets of superset1 \cup superset2 with size m or less,
 // such that they have >= 1 elements from each set.
 void LandmarkFactoryHM::get_split_m_sets(
-    const VariablesProxy &variables,
-    int m, int ss1_num_included, int ss2_num_included,
+    int ss1_num_included, int ss2_num_included,
     int ss1_var_index, int ss2_var_index,
-    FluentSet &current, vector<FluentSet> &subsets,
-    const FluentSet &superset1, const FluentSet &superset2) {
-    /*
-       if( ((ss1_var_index == superset1.size()) && (ss1_num_included == 0)) ||
-        ((ss2_var_index == superset2.size()) && (ss2_num_included == 0)) ) {
-       return;
-       }
-     */
-
+    vector<int> &current, vector<int> &subsets,
+    const vector<int> &superset1, const vector<int> &superset2) {
     int sup1_size = superset1.size();
     int sup2_size = superset2.size();
 
-    if (ss1_num_included + ss2_num_included == m ||
+    if (ss1_num_included + ss2_num_included == m_ ||
         (ss1_var_index == sup1_size && ss2_var_index == sup2_size)) {
         // if set is empty, don't have to include from it
         if ((ss1_num_included > 0 || sup1_size == 0) &&
             (ss2_num_included > 0 || sup2_size == 0)) {
-            subsets.push_back(current);
+            subsets.push_back(get_set_index(current));
         }
         return;
     }
@@ -211,8 +207,8 @@ void LandmarkFactoryHM::get_split_m_sets(
     if (ss1_var_index != sup1_size &&
         (ss2_var_index == sup2_size ||
          superset1[ss1_var_index] < superset2[ss2_var_index])) {
-        for (const FactPair &fluent : current) {
-            if (!interesting(variables, superset1[ss1_var_index], fluent)) {
+        for (int fluent : current) {
+            if (!interesting(superset1[ss1_var_index], fluent)) {
                 use_var = false;
                 break;
             }
@@ -221,19 +217,19 @@ void LandmarkFactoryHM::get_split_m_sets(
         if (use_var) {
             // include
             current.push_back(superset1[ss1_var_index]);
-            get_split_m_sets(variables, m, ss1_num_included + 1, ss2_num_included,
+            get_split_m_sets(ss1_num_included + 1, ss2_num_included,
                              ss1_var_index + 1, ss2_var_index,
                              current, subsets, superset1, superset2);
             current.pop_back();
         }
 
         // don't include
-        get_split_m_sets(variables, m, ss1_num_included, ss2_num_included,
+        get_split_m_sets(ss1_num_included, ss2_num_included,
                          ss1_var_index + 1, ss2_var_index,
                          current, subsets, superset1, superset2);
     } else {
-        for (const FactPair &fluent : current) {
-            if (!interesting(variables, superset2[ss2_var_index], fluent)) {
+        for (int fluent : current) {
+            if (!interesting(superset2[ss2_var_index], fluent)) {
                 use_var = false;
                 break;
             }
@@ -242,14 +238,14 @@ void LandmarkFactoryHM::get_split_m_sets(
         if (use_var) {
             // include
             current.push_back(superset2[ss2_var_index]);
-            get_split_m_sets(variables, m, ss1_num_included, ss2_num_included + 1,
+            get_split_m_sets(ss1_num_included, ss2_num_included + 1,
                              ss1_var_index, ss2_var_index + 1,
                              current, subsets, superset1, superset2);
             current.pop_back();
         }
 
         // don't include
-        get_split_m_sets(variables, m, ss1_num_included, ss2_num_included,
+        get_split_m_sets(ss1_num_included, ss2_num_included,
                          ss1_var_index, ss2_var_index + 1,
                          current, subsets, superset1, superset2);
     }
@@ -259,39 +255,38 @@ void LandmarkFactoryHM::get_split_m_sets(
 // e.g. we don't want to represent (truck1-loc x, truck2-loc y) type stuff
 
 // get partial assignments of size <= m in the problem
-void LandmarkFactoryHM::get_m_sets(const VariablesProxy &variables, int m, vector<FluentSet> &subsets) {
-    FluentSet c;
-    get_m_sets_(variables, m, 0, 0, c, subsets);
+void LandmarkFactoryHM::get_m_sets(const VariablesProxy &variables) {
+    vector<int> c;
+    fluent_begin_.push_back(0);
+    get_m_sets_(variables, 0, 0, c);
 }
 
-// get subsets of superset with size <= m
-void LandmarkFactoryHM::get_m_sets(const VariablesProxy &variables,
-                                   int m, vector<FluentSet> &subsets,
-                                   const FluentSet &superset) {
-    FluentSet c;
-    get_m_sets_of_set(variables, m, 0, 0, c, subsets, superset);
+// get indices of the subsets of superset with size <= m
+void LandmarkFactoryHM::get_m_sets(vector<int> &subsets,
+                                   const vector<int> &superset) {
+    vector<int> c;
+    get_m_sets_of_set(0, 0, c, subsets, superset);
 }
 
 // second function to get subsets of size at most m that
 // have at least one element in ss1 and same in ss2
 // assume disjoint
 void LandmarkFactoryHM::get_split_m_sets(
-    const VariablesProxy &variables,
-    int m, vector<FluentSet> &subsets,
-    const FluentSet &superset1, const FluentSet &superset2) {
-    FluentSet c;
-    get_split_m_sets(variables, m, 0, 0, 0, 0, c, subsets, superset1, superset2);
+    vector<int> &subsets,
+    const vector<int> &superset1, const vector<int> &superset2) {
+    vector<int> c;
+    get_split_m_sets(0, 0, 0, 0, c, subsets, superset1, superset2);
 }
 
 // get subsets of state with size <= m
-void LandmarkFactoryHM::get_m_sets(const VariablesProxy &variables, int m,
-                                   vector<FluentSet> &subsets,
-                                   const State &state) {
-    FluentSet state_fluents;
+void LandmarkFactoryHM::get_m_sets(vector<int> &subsets, const State &state) {
+    vector<int> state_fluents;
+    state_fluents.reserve(state.size());
     for (FactProxy fact : state) {
-        state_fluents.push_back(fact.get_pair());
+        state_fluents.push_back(
+            fact_offsets_[fact.get_variable().get_id()] + fact.get_value());
     }
-    get_m_sets(variables, m, subsets, state_fluents);
+    get_m_sets(subsets, state_fluents);
 }
 
 void LandmarkFactoryHM::print_proposition(const VariablesProxy &variables, const FactPair &fluent) const {
@@ -333,55 +328,54 @@ static FluentSet get_operator_postcondition(int num_vars, const OperatorProxy &o
 }
 
 
-void LandmarkFactoryHM::print_pm_op(const VariablesProxy &variables, const PMOp &op) const {
+void LandmarkFactoryHM::print_pm_op(const VariablesProxy &variables, int op_index) const {
     if (log.is_at_least_verbose()) {
+        const PMOp &op = pm_ops_[op_index];
         set<FactPair> pcs, effs, cond_pc, cond_eff;
         vector<pair<set<FactPair>, set<FactPair>>> conds;
 
         for (int pc : op.pc) {
-            for (const FactPair &fluent : h_m_table_[pc].fluents) {
-                pcs.insert(fluent);
+            for (int i = fluent_begin_[pc]; i < fluent_begin_[pc + 1]; ++i) {
+                pcs.insert(facts_[fluent_facts_[i]]);
             }
         }
         for (int eff : op.eff) {
-            for (const FactPair &fluent : h_m_table_[eff].fluents) {
-                effs.insert(fluent);
+            for (int i = fluent_begin_[eff]; i < fluent_begin_[eff + 1]; ++i) {
+                effs.insert(facts_[fluent_facts_[i]]);
             }
         }
-        for (size_t i = 0; i < op.cond_noops.size(); ++i) {
+        for (int noop = op.first_noop; noop < op.first_noop + op.num_noops; ++noop) {
             cond_pc.clear();
             cond_eff.clear();
-            int pm_fluent;
-            size_t j;
             log << "PC:" << endl;
-            for (j = 0; (pm_fluent = op.cond_noops[i][j]) != -1; ++j) {
-                print_fluentset(variables, h_m_table_[pm_fluent].fluents);
+            for (int j = noop_begin_[noop]; j < noop_separator_[noop]; ++j) {
+                int pm_fluent = noop_facts_[j];
+                print_fluentset(variables, pm_fluent);
                 log << endl;
 
-                for (size_t k = 0; k < h_m_table_[pm_fluent].fluents.size(); ++k) {
-                    cond_pc.insert(h_m_table_[pm_fluent].fluents[k]);
+                for (int k = fluent_begin_[pm_fluent]; k < fluent_begin_[pm_fluent + 1]; ++k) {
+                    cond_pc.insert(facts_[fluent_facts_[k]]);
                 }
             }
             // advance to effects section
             log << endl;
-            ++j;
 
             log << "EFF:" << endl;
-            for (; j < op.cond_noops[i].size(); ++j) {
-                int pm_fluent = op.cond_noops[i][j];
+            for (int j = noop_separator_[noop]; j < noop_begin_[noop + 1]; ++j) {
+                int pm_fluent = noop_facts_[j];
 
-                print_fluentset(variables, h_m_table_[pm_fluent].fluents);
+                print_fluentset(variables, pm_fluent);
                 log << endl;
 
-                for (size_t k = 0; k < h_m_table_[pm_fluent].fluents.size(); ++k) {
-                    cond_eff.insert(h_m_table_[pm_fluent].fluents[k]);
+                for (int k = fluent_begin_[pm_fluent]; k < fluent_begin_[pm_fluent + 1]; ++k) {
+                    cond_eff.insert(facts_[fluent_facts_[k]]);
                 }
             }
             conds.emplace_back(cond_pc, cond_eff);
             log << endl << endl << endl;
         }
 
-        log << "Action " << op.index << endl;
+        log << "Action " << op_index << endl;
         log << "Precondition: ";
         for (const FactPair &pc : pcs) {
             print_proposition(variables, pc);
@@ -411,54 +405,22 @@ void LandmarkFactoryHM::print_pm_op(const VariablesProxy &variables, const PMOp
     }
 }
 
-void LandmarkFactoryHM::print_fluentset(const VariablesProxy &variables, const FluentSet &fs) const {
+void LandmarkFactoryHM::print_fluentset(const VariablesProxy &variables, int set_index) const {
     if (log.is_at_least_verbose()) {
         log << "( ";
-        for (const FactPair &fact : fs) {
-            print_proposition(variables, fact);
+        for (int i = fluent_begin_[set_index]; i < fluent_begin_[set_index + 1]; ++i) {
+            print_proposition(variables, facts_[fluent_facts_[i]]);
             log << " ";
         }
         log << ")";
     }
 }
 
-// check whether fs2 is a possible noop set for action with fs1 as effect
-// sets cannot be 1) defined on same variable, 2) otherwise mutex
-bool LandmarkFactoryHM::possible_noop_set(const VariablesProxy &variables,
-                                          const FluentSet &fs1,
-                                          const FluentSet &fs2) {
-    FluentSet::const_iterator fs1it = fs1.begin(), fs2it = fs2.begin();
-
-    while (fs1it != fs1.end() && fs2it != fs2.end()) {
-        if (fs1it->var == fs2it->var) {
-            return false;
-        } else if (fs1it->var < fs2it->var) {
-            ++fs1it;
-        } else {
-            ++fs2it;
-        }
-    }
-
-    for (const FactPair &fluent1 : fs1) {
-        FactProxy fact1 = variables[fluent1.var].get_fact(fluent1.value);
-        for (const FactPair &fluent2 : fs2) {
-            if (fact1.is_mutex(
-                    variables[fluent2.var].get_fact(fluent2.value)))
-                return false;
-        }
-    }
-
-    return true;
-}
-
 
 // make the operators of the P_m problem
 void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
-    FluentSet pc, eff;
-    vector<FluentSet> pc_subsets, eff_subsets, noop_pc_subsets, noop_eff_subsets;
-
-    static int op_count = 0;
-    int set_index, noop_index;
+    vector<int> pc, eff, noop_set;
+    vector<int> pc_subsets, eff_subsets, noop_pc_subsets, noop_eff_subsets;
 
     OperatorsProxy operators = task_proxy.get_operators();
     pm_ops_.resize(operators.size());
@@ -468,112 +430,130 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
 
     VariablesProxy variables = task_proxy.get_variables();
 
+    /*
+      Facts that may not occur in a noop set of the current operator: facts
+      on the variables of the postcondition and facts mutex with it.
+    */
+    vector<uint64_t> blocked(mutex_words_per_fact_);
+
     // transfer ops from original problem
     // represent noops as "conditional" effects
     for (OperatorProxy op : operators) {
-        PMOp &pm_op = pm_ops_[op.get_id()];
-        pm_op.index = op_count++;
+        int op_id = op.get_id();
+        PMOp &pm_op = pm_ops_[op_id];
 
         pc_subsets.clear();
         eff_subsets.clear();
 
         // preconditions of P_m op are all subsets of original pc
-        pc = get_operator_precondition(op);
-        get_m_sets(variables, m_, pc_subsets, pc);
-        pm_op.pc.reserve(pc_subsets.size());
+        pc = get_fact_indices(get_operator_precondition(op));
+        get_m_sets(pc_subsets, pc);
+        pm_op.pc = pc_subsets;
 
         // set unsatisfied pc count for op
-        unsat_pc_count_[op.get_id()].first = pc_subsets.size();
+        unsat_pc_count_[op_id] = pc_subsets.size();
 
-        for (const FluentSet &pc_subset : pc_subsets) {
-            assert(set_indices_.find(pc_subset) != set_indices_.end());
-            set_index = set_indices_[pc_subset];
-            pm_op.pc.push_back(set_index);
-            h_m_table_[set_index].pc_for.emplace_back(op.get_id(), -1);
+        for (int set_index : pc_subsets) {
+            h_m_table_[set_index].pc_for.emplace_back(op_id, -1);
         }
 
         // same for effects
-        eff = get_operator_postcondition(variables.size(), op);
-        get_m_sets(variables, m_, eff_subsets, eff);
-        pm_op.eff.reserve(eff_subsets.size());
-
-        for (const FluentSet &eff_subset : eff_subsets) {
-            assert(set_indices_.find(eff_subset) != set_indices_.end());
-            set_index = set_indices_[eff_subset];
-            pm_op.eff.push_back(set_index);
-        }
+        eff = get_fact_indices(get_operator_postcondition(variables.size(), op));
+        get_m_sets(eff_subsets, eff);
+        pm_op.eff = eff_subsets;
 
-        noop_index = 0;
+        pm_op.first_noop = noop_separator_.size();
+        int noop_index = 0;
 
         // For all subsets used in the problem with size *<* m, check whether
         // they conflict with the effect of the operator (no need to check pc
         // because mvvs appearing in pc also appear in effect
-
-        FluentSetToIntMap::const_iterator it = set_indices_.begin();
-        while (static_cast<int>(it->first.size()) < m_
-               && it != set_indices_.end()) {
-            if (possible_noop_set(variables, eff, it->first)) {
-                // for each such set, add a "conditional effect" to the operator
-                pm_op.cond_noops.resize(pm_op.cond_noops.size() + 1);
-
-                vector<int> &this_cond_noop = pm_op.cond_noops.back();
-
-                noop_pc_subsets.clear();
-                noop_eff_subsets.clear();
-
-                // get the subsets that have >= 1 element in the pc (unless pc is empty)
-                // and >= 1 element in the other set
-
-                get_split_m_sets(variables, m_, noop_pc_subsets, pc, it->first);
-                get_split_m_sets(variables, m_, noop_eff_subsets, eff, it->first);
-
-                this_cond_noop.reserve(noop_pc_subsets.size() + noop_eff_subsets.size() + 1);
-
-                unsat_pc_count_[op.get_id()].second.push_back(noop_pc_subsets.size());
-
-                // push back all noop preconditions
-                for (size_t j = 0; j < noop_pc_subsets.size(); ++j) {
-                    assert(static_cast<int>(noop_pc_subsets[j].size()) <= m_);
-                    assert(set_indices_.find(noop_pc_subsets[j]) != set_indices_.end());
-
-                    set_index = set_indices_[noop_pc_subsets[j]];
-                    this_cond_noop.push_back(set_index);
-                    // these facts are "conditional pcs" for this action
-                    h_m_table_[set_index].pc_for.emplace_back(op.get_id(), noop_index);
+        if (!noop_sets_.empty()) {
+            fill(blocked.begin(), blocked.end(), 0);
+            for (int fact : eff) {
+                // the mutex row contains all other facts of the variable
+                const uint64_t *row = &mutexes_[fact * mutex_words_per_fact_];
+                for (int word = 0; word < mutex_words_per_fact_; ++word) {
+                    blocked[word] |= row[word];
                 }
+                blocked[fact / 64] |= uint64_t(1) << (fact % 64);
+            }
+        }
 
-                // separator
-                this_cond_noop.push_back(-1);
+        for (int set_index : noop_sets_) {
+            noop_set.assign(fluent_facts_.begin() + fluent_begin_[set_index],
+                            fluent_facts_.begin() + fluent_begin_[set_index + 1]);
+            bool possible_noop_set = true;
+            for (int fact : noop_set) {
+                if (blocked[fact / 64] & (uint64_t(1) << (fact % 64))) {
+                    possible_noop_set = false;
+                    break;
+                }
+            }
+            if (!possible_noop_set)
+                continue;
+
+            // for each such set, add a "conditional effect" to the operator
+            noop_pc_subsets.clear();
+            noop_eff_subsets.clear();
+
+            // get the subsets that have >= 1 element in the pc (unless pc is empty)
+            // and >= 1 element in the other set
+            get_split_m_sets(noop_pc_subsets, pc, noop_set);
+            get_split_m_sets(noop_eff_subsets, eff, noop_set);
+
+            noop_unsat_pc_count_.push_back(noop_pc_subsets.size());
+
+            // push back all noop preconditions
+            noop_begin_.push_back(noop_facts_.size());
+            for (int pc_index : noop_pc_subsets) {
+                noop_facts_.push_back(pc_index);
+                // these facts are "conditional pcs" for this action
+                h_m_table_[pc_index].pc_for.emplace_back(op_id, noop_index);
+            }
 
-                // and the noop effects
-                for (size_t j = 0; j < noop_eff_subsets.size(); ++j) {
-                    assert(static_cast<int>(noop_eff_subsets[j].size()) <= m_);
-                    assert(set_indices_.find(noop_eff_subsets[j]) != set_indices_.end());
+            // and the noop effects
+            noop_separator_.push_back(noop_facts_.size());
+            noop_facts_.insert(noop_facts_.end(),
+                               noop_eff_subsets.begin(), noop_eff_subsets.end());
 
-                    set_index = set_indices_[noop_eff_subsets[j]];
-                    this_cond_noop.push_back(set_index);
-                }
+            ++noop_index;
+        }
+        pm_op.num_noops = noop_index;
+    }
+    noop_begin_.push_back(noop_facts_.size());
 
-                ++noop_index;
-            }
-            ++it;
+    if (log.is_at_least_verbose()) {
+        for (OperatorProxy op : operators) {
+            print_pm_op(variables, op.get_id());
         }
-        print_pm_op(variables, pm_op);
     }
 }
 
-bool LandmarkFactoryHM::interesting(const VariablesProxy &variables,
-                                    const FactPair &fact1, const FactPair &fact2) const {
-    // mutexes can always be safely pruned
-    return !variables[fact1.var].get_fact(fact1.value).is_mutex(
-        variables[fact2.var].get_fact(fact2.value));
+void LandmarkFactoryHM::compute_mutexes(const VariablesProxy &variables) {
+    int num_facts = facts_.size();
+    mutex_words_per_fact_ = (num_facts + 63) / 64;
+    mutexes_.assign(static_cast<size_t>(num_facts) * mutex_words_per_fact_, 0);
+    for (int fact1 = 0; fact1 < num_facts; ++fact1) {
+        FactProxy fact_proxy1 = variables[facts_[fact1].var].get_fact(facts_[fact1].value);
+        for (int fact2 = fact1 + 1; fact2 < num_facts; ++fact2) {
+            if (fact_proxy1.is_mutex(
+                    variables[facts_[fact2].var].get_fact(facts_[fact2].value))) {
+                mutexes_[fact1 * mutex_words_per_fact_ + fact2 / 64] |=
+                    uint64_t(1) << (fact2 % 64);
+                mutexes_[fact2 * mutex_words_per_fact_ + fact1 / 64] |=
+                    uint64_t(1) << (fact1 % 64);
+            }
+        }
+    }
 }
 
 LandmarkFactoryHM::LandmarkFactoryHM(const options::Options &opts)
     : LandmarkFactory(opts),
       m_(opts.get<int>("m")),
       conjunctive_landmarks(opts.get<bool>("conjunctive_landmarks")),
-      use_orders(opts.get<bool>("use_orders")) {
+      use_orders(opts.get<bool>("use_orders")),
+      mutex_words_per_fact_(0) {
 }
 
 void LandmarkFactoryHM::initialize(const TaskProxy &task_proxy) {
@@ -584,21 +564,60 @@ void LandmarkFactoryHM::initialize(const TaskProxy &task_proxy) {
         cerr << "h^m landmarks don't support axioms" << endl;
         utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
     }
+    VariablesProxy variables = task_proxy.get_variables();
+    for (VariableProxy var : variables) {
+        fact_offsets_.push_back(facts_.size());
+        for (int value = 0; value < var.get_domain_size(); ++value) {
+            facts_.emplace_back(var.get_id(), value);
+        }
+    }
+    uint64_t base = facts_.size() + 1;
+    uint64_t max_key = 1;
+    for (int i = 0; i < m_; ++i) {
+        if (max_key > numeric_limits<uint64_t>::max() / base) {
+            cerr << "h^m landmarks don't support m=" << m_
+                 << " for tasks with " << facts_.size() << " facts" << endl;
+            utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
+        }
+        max_key *= base;
+    }
+    if (m_ > 1) {
+        compute_mutexes(variables);
+    }
+
     // Get all the m or less size subsets in the domain.
-    vector<vector<FactPair>> msets;
-    get_m_sets(task_proxy.get_variables(), m_, msets);
-
-    // map each set to an integer
-    for (size_t i = 0; i < msets.size(); ++i) {
-        h_m_table_.emplace_back();
-        set_indices_[msets[i]] = i;
-        h_m_table_[i].fluents = msets[i];
+    get_m_sets(variables);
+
+    int num_fluents = fluent_begin_.size() - 1;
+    h_m_table_.resize(num_fluents);
+    reached_fluents_.assign(num_fluents, false);
+
+    for (int i = 0; i < num_fluents; ++i) {
+        if (fluent_begin_[i + 1] - fluent_begin_[i] < m_)
+            noop_sets_.push_back(i);
     }
+    sort(noop_sets_.begin(), noop_sets_.end(),
+         [this](int set1, int set2) {
+             int size1 = fluent_begin_[set1 + 1] - fluent_begin_[set1];
+             int size2 = fluent_begin_[set2 + 1] - fluent_begin_[set2];
+             if (size1 != size2)
+                 return size1 < size2;
+             return lexicographical_compare(
+                 fluent_facts_.begin() + fluent_begin_[set1],
+                 fluent_facts_.begin() + fluent_begin_[set1 + 1],
+                 fluent_facts_.begin() + fluent_begin_[set2],
+                 fluent_facts_.begin() + fluent_begin_[set2 + 1]);
+         });
+
     if (log.is_at_least_normal()) {
-        log << "Using " << h_m_table_.size() << " P^m fluents." << endl;
+        log << "Using " << num_fluents << " P^m fluents." << endl;
     }
 
     build_pm_ops(task_proxy);
+    if (log.is_at_least_normal()) {
+        log << "Using " << noop_separator_.size()
+            << " conditional noop effects." << endl;
+    }
 }
 
 void LandmarkFactoryHM::postprocess(const TaskProxy &task_proxy) {
@@ -689,8 +708,20 @@ void LandmarkFactoryHM::free_unneeded_memory() {
     utils::release_vector_memory(h_m_table_);
     utils::release_vector_memory(pm_ops_);
     utils::release_vector_memory(unsat_pc_count_);
-
-    set_indices_.clear();
+    utils::release_vector_memory(noop_unsat_pc_count_);
+    utils::release_vector_memory(noop_begin_);
+    utils::release_vector_memory(noop_separator_);
+    utils::release_vector_memory(noop_facts_);
+    utils::release_vector_memory(fluent_begin_);
+    utils::release_vector_memory(fluent_facts_);
+    utils::release_vector_memory(reached_fluents_);
+    utils::release_vector_memory(noop_sets_);
+    utils::release_vector_memory(mutexes_);
+    utils::release_vector_memory(noop_landmarks_);
+    utils::release_vector_memory(noop_necessary_);
+    utils::release_vector_memory(union_buffer_);
+
+    utils::HashMap<uint64_t, int>().swap(set_indices_);
     lm_node_table_.clear();
 }
 
@@ -704,27 +735,31 @@ void LandmarkFactoryHM::propagate_pm_fact(int factindex, bool newly_discovered,
         // a pc for the action itself
         if (info.value == -1) {
             if (newly_discovered) {
-                --unsat_pc_count_[info.var].first;
+                --unsat_pc_count_[info.var];
             }
             // add to queue if unsatcount at 0
-            if (unsat_pc_count_[info.var].first == 0) {
+            if (unsat_pc_count_[info.var] == 0) {
                 // create empty set or clear prev entries -- signals do all possible noop effects
                 trigger[info.var].clear();
             }
         }
         // a pc for a conditional noop
         else {
+            int &noop_unsat_pc_count =
+                noop_unsat_pc_count_[pm_ops_[info.var].first_noop + info.value];
             if (newly_discovered) {
-                --unsat_pc_count_[info.var].second[info.value];
+                --noop_unsat_pc_count;
             }
             // if associated action is applicable, and effect has become applicable
             // (if associated action is not applicable, all noops will be used when it first does)
-            if ((unsat_pc_count_[info.var].first == 0) &&
-                (unsat_pc_count_[info.var].second[info.value] == 0)) {
+            if ((unsat_pc_count_[info.var] == 0) &&
+                (noop_unsat_pc_count == 0)) {
                 // if not already triggering all noops, add this one
-                if ((trigger.find(info.var) == trigger.end()) ||
-                    (!trigger[info.var].empty())) {
-                    trigger[info.var].insert(info.value);
+                auto it = trigger.find(info.var);
+                if (it == trigger.end()) {
+                    trigger[info.var].push_back(info.value);
+                } else if (!it->second.empty()) {
+                    insert_into(it->second, info.value);
                 }
             }
         }
@@ -733,15 +768,14 @@ void LandmarkFactoryHM::propagate_pm_fact(int factindex, bool newly_discovered,
 
 void LandmarkFactoryHM::compute_h_m_landmarks(const TaskProxy &task_proxy) {
     // get subsets of initial state
-    vector<FluentSet> init_subsets;
-    get_m_sets(task_proxy.get_variables(), m_, init_subsets, task_proxy.get_initial_state());
+    vector<int> init_subsets;
+    get_m_sets(init_subsets, task_proxy.get_initial_state());
 
     TriggerSet current_trigger, next_trigger;
 
-    // for all of the initial state <= m subsets, mark level = 0
-    for (size_t i = 0; i < init_subsets.size(); ++i) {
-        int index = set_indices_[init_subsets[i]];
-        h_m_table_[index].level = 0;
+    // for all of the initial state <= m subsets, mark them as reached
+    for (int index : init_subsets) {
+        reached_fluents_[index] = true;
 
         // set actions to be applied
         propagate_pm_fact(index, true, current_trigger);
@@ -749,17 +783,14 @@ void LandmarkFactoryHM::compute_h_m_landmarks(const TaskProxy &task_proxy) {
 
     // mark actions with no precondition to be applied
     for (size_t i = 0; i < pm_ops_.size(); ++i) {
-        if (unsat_pc_count_[i].first == 0) {
+        if (unsat_pc_count_[i] == 0) {
             // create empty set or clear prev entries
             current_trigger[i].clear();
         }
     }
 
-    vector<int>::iterator it;
-    TriggerSet::iterator op_it;
-
-    list<int> local_landmarks;
-    list<int> local_necessary;
+    vector<int> local_landmarks;
+    vector<int> local_necessary;
 
     size_t prev_size;
 
@@ -767,79 +798,80 @@ void LandmarkFactoryHM::compute_h_m_landmarks(const TaskProxy &task_proxy) {
 
     // while we have actions to apply
     while (!current_trigger.empty()) {
-        for (op_it = current_trigger.begin(); op_it != current_trigger.end(); ++op_it) {
+        for (TriggerSet::iterator op_it = current_trigger.begin();
+             op_it != current_trigger.end(); ++op_it) {
             local_landmarks.clear();
             local_necessary.clear();
 
             int op_index = op_it->first;
-            PMOp &action = pm_ops_[op_index];
+            const PMOp &action = pm_ops_[op_index];
 
             // gather landmarks for pcs
             // in the set of landmarks for each fact, the fact itself is not stored
             // (only landmarks preceding it)
-            for (it = action.pc.begin(); it != action.pc.end(); ++it) {
-                union_with(local_landmarks, h_m_table_[*it].landmarks);
-                insert_into(local_landmarks, *it);
+            for (int pc : action.pc) {
+                union_with(local_landmarks, h_m_table_[pc].landmarks, union_buffer_);
+                insert_into(local_landmarks, pc);
 
                 if (use_orders) {
-                    insert_into(local_necessary, *it);
+                    insert_into(local_necessary, pc);
                 }
             }
 
-            for (it = action.eff.begin(); it != action.eff.end(); ++it) {
-                if (h_m_table_[*it].level != -1) {
-                    prev_size = h_m_table_[*it].landmarks.size();
-                    intersect_with(h_m_table_[*it].landmarks, local_landmarks);
+            for (int eff : action.eff) {
+                HMEntry &entry = h_m_table_[eff];
+                if (reached_fluents_[eff]) {
+                    prev_size = entry.landmarks.size();
+                    intersect_with(entry.landmarks, local_landmarks);
 
                     // if the add effect appears in local landmarks,
                     // fact is being achieved for >1st time
                     // no need to intersect for gn orderings
                     // or add op to first achievers
-                    if (!contains(local_landmarks, *it)) {
-                        insert_into(h_m_table_[*it].first_achievers, op_index);
+                    if (!contains(local_landmarks, eff)) {
+                        insert_into(entry.first_achievers, op_index);
                         if (use_orders) {
-                            intersect_with(h_m_table_[*it].necessary, local_necessary);
+                            intersect_with(entry.necessary, local_necessary);
                         }
                     }
 
-                    if (h_m_table_[*it].landmarks.size() != prev_size)
-                        propagate_pm_fact(*it, false, next_trigger);
+                    if (entry.landmarks.size() != prev_size)
+                        propagate_pm_fact(eff, false, next_trigger);
                 } else {
-                    h_m_table_[*it].level = level;
-                    h_m_table_[*it].landmarks = local_landmarks;
+                    reached_fluents_[eff] = true;
+                    entry.landmarks = local_landmarks;
                     if (use_orders) {
-                        h_m_table_[*it].necessary = local_necessary;
+                        entry.necessary = local_necessary;
                     }
-                    insert_into(h_m_table_[*it].first_achievers, op_index);
-                    propagate_pm_fact(*it, true, next_trigger);
+                    insert_into(entry.first_achievers, op_index);
+                    propagate_pm_fact(eff, true, next_trigger);
                 }
             }
 
             // landmarks changed for action itself, have to recompute
             // landmarks for all noop effects
             if (op_it->second.empty()) {
-                for (size_t i = 0; i < action.cond_noops.size(); ++i) {
+                for (int i = 0; i < action.num_noops; ++i) {
                     // actions pcs are satisfied, but cond. effects may still have
                     // unsatisfied pcs
-                    if (unsat_pc_count_[op_index].second[i] == 0) {
+                    if (noop_unsat_pc_count_[action.first_noop + i] == 0) {
                         compute_noop_landmarks(op_index, i,
                                                local_landmarks,
                                                local_necessary,
-                                               level, next_trigger);
+                                               next_trigger);
                     }
                 }
             }
             // only recompute landmarks for conditions whose
             // landmarks have changed
             else {
-                for (set<int>::iterator noop_it = op_it->second.begin();
-                     noop_it != op_it->second.end(); ++noop_it) {
-                    assert(unsat_pc_count_[op_index].second[*noop_it] == 0);
+                for (int noop_index : op_it->second) {
+                    assert(noop_unsat_pc_count_[action.first_noop + noop_index] == 0);
 
-                    compute_noop_landmarks(op_index, *noop_it,
+                    compute_noop_landmarks(op_index, noop_index,
                                            local_landmarks,
                                            local_necessary,
-                                           level, next_trigger);
+                                           next_trigger);
                 }
             }
         }
@@ -858,29 +890,21 @@ void LandmarkFactoryHM::compute_h_m_landmarks(const TaskProxy &task_proxy) {
 
 void LandmarkFactoryHM::compute_noop_landmarks(
     int op_index, int noop_index,
-    list<int> const &local_landmarks,
-    list<int> const &local_necessary,
-    int level,
+    const vector<int> &local_landmarks,
+    const vector<int> &local_necessary,
     TriggerSet &next_trigger) {
-    list<int> cn_necessary, cn_landmarks;
-    size_t prev_size;
-    int pm_fluent;
-
-    PMOp &action = pm_ops_[op_index];
-    vector<int> &pc_eff_pair = action.cond_noops[noop_index];
-
-    cn_landmarks.clear();
+    int noop = pm_ops_[op_index].first_noop + noop_index;
 
+    vector<int> &cn_landmarks = noop_landmarks_;
+    vector<int> &cn_necessary = noop_necessary_;
     cn_landmarks = local_landmarks;
-
     if (use_orders) {
-        cn_necessary.clear();
         cn_necessary = local_necessary;
     }
 
-    size_t i;
-    for (i = 0; (pm_fluent = pc_eff_pair[i]) != -1; ++i) {
-        union_with(cn_landmarks, h_m_table_[pm_fluent].landmarks);
+    for (int i = noop_begin_[noop]; i < noop_separator_[noop]; ++i) {
+        int pm_fluent = noop_facts_[i];
+        union_with(cn_landmarks, h_m_table_[pm_fluent].landmarks, union_buffer_);
         insert_into(cn_landmarks, pm_fluent);
 
         if (use_orders) {
@@ -888,35 +912,33 @@ void LandmarkFactoryHM::compute_noop_landmarks(
         }
     }
 
-    // go to the beginning of the effects section
-    ++i;
-
-    for (; i < pc_eff_pair.size(); ++i) {
-        pm_fluent = pc_eff_pair[i];
-        if (h_m_table_[pm_fluent].level != -1) {
-            prev_size = h_m_table_[pm_fluent].landmarks.size();
-            intersect_with(h_m_table_[pm_fluent].landmarks, cn_landmarks);
+    for (int i = noop_separator_[noop]; i < noop_begin_[noop + 1]; ++i) {
+        int pm_fluent = noop_facts_[i];
+        HMEntry &entry = h_m_table_[pm_fluent];
+        if (reached_fluents_[pm_fluent]) {
+            size_t prev_size = entry.landmarks.size();
+            intersect_with(entry.landmarks, cn_landmarks);
 
             // if the add effect appears in cn_landmarks,
             // fact is being achieved for >1st time
             // no need to intersect for gn orderings
             // or add op to first achievers
             if (!contains(cn_landmarks, pm_fluent)) {
-                insert_into(h_m_table_[pm_fluent].first_achievers, op_index);
+                insert_into(entry.first_achievers, op_index);
                 if (use_orders) {
-                    intersect_with(h_m_table_[pm_fluent].necessary, cn_necessary);
+                    intersect_with(entry.necessary, cn_necessary);
                 }
             }
 
-            if (h_m_table_[pm_fluent].landmarks.size() != prev_size)
+            if (entry.landmarks.size() != prev_size)
                 propagate_pm_fact(pm_fluent, false, next_trigger);
         } else {
-            h_m_table_[pm_fluent].level = level;
-            h_m_table_[pm_fluent].landmarks = cn_landmarks;
+            reached_fluents_[pm_fluent] = true;
+            entry.landmarks = cn_landmarks;
             if (use_orders) {
-                h_m_table_[pm_fluent].necessary = cn_necessary;
+                entry.necessary = cn_necessary;
             }
-            insert_into(h_m_table_[pm_fluent].first_achievers, op_index);
+            insert_into(entry.first_achievers, op_index);
             propagate_pm_fact(pm_fluent, true, next_trigger);
         }
     }
@@ -925,8 +947,10 @@ void LandmarkFactoryHM::compute_noop_landmarks(
 void LandmarkFactoryHM::add_lm_node(int set_index, bool goal) {
     if (lm_node_table_.find(set_index) == lm_node_table_.end()) {
         const HMEntry &hm_entry = h_m_table_[set_index];
-        vector<FactPair> facts(hm_entry.fluents);
-        utils::sort_unique(facts);
+        vector<FactPair> facts;
+        for (int i = fluent_begin_[set_index]; i < fluent_begin_[set_index + 1]; ++i) {
+            facts.push_back(facts_[fluent_facts_[i]]);
+        }
         assert(!facts.empty());
         Landmark landmark(facts, false, (facts.size() > 1), goal);
         landmark.first_achievers.insert(
@@ -942,27 +966,25 @@ void LandmarkFactoryHM::generate_landmarks(
     initialize(task_proxy);
     compute_h_m_landmarks(task_proxy);
     // now construct landmarks graph
-    vector<FluentSet> goal_subsets;
-    FluentSet goals = task_properties::get_fact_pairs(task_proxy.get_goals());
+    vector<int> goal_subsets;
+    vector<int> goals = get_fact_indices(
+        task_properties::get_fact_pairs(task_proxy.get_goals()));
+    sort(goals.begin(), goals.end());
     VariablesProxy variables = task_proxy.get_variables();
-    get_m_sets(variables, m_, goal_subsets, goals);
-    list<int> all_lms;
-    for (const FluentSet &goal_subset : goal_subsets) {
-        assert(set_indices_.find(goal_subset) != set_indices_.end());
-
-        int set_index = set_indices_[goal_subset];
-
-        if (h_m_table_[set_index].level == -1) {
+    get_m_sets(goal_subsets, goals);
+    vector<int> all_lms;
+    for (int set_index : goal_subsets) {
+        if (!reached_fluents_[set_index]) {
             if (log.is_at_least_verbose()) {
                 log << endl << endl << "Subset of goal not reachable !!." << endl << endl << endl;
                 log << "Subset is: ";
-                print_fluentset(variables, h_m_table_[set_index].fluents);
+                print_fluentset(variables, set_index);
                 log << endl;
             }
         }
 
         // set up goals landmarks for processing
-        union_with(all_lms, h_m_table_[set_index].landmarks);
+        union_with(all_lms, h_m_table_[set_index].landmarks, union_buffer_);
 
         // the goal itself is also a lm
         insert_into(all_lms, set_index);
@@ -978,9 +1000,9 @@ void LandmarkFactoryHM::generate_landmarks(
         // do reduction of graph
         // if f2 is landmark for f1, subtract landmark set of f2 from that of f1
         for (int f1 : all_lms) {
-            list<int> everything_to_remove;
+            vector<int> everything_to_remove;
             for (int f2 : h_m_table_[f1].landmarks) {
-                union_with(everything_to_remove, h_m_table_[f2].landmarks);
+                union_with(everything_to_remove, h_m_table_[f2].landmarks, union_buffer_);
             }
             set_minus(h_m_table_[f1].landmarks, everything_to_remove);
             // remove necessaries here, otherwise they will be overwritten
@@ -3,81 +3,72 @@
 
 #include "landmark_factory.h"
 
+#include "../utils/hash.h"
+
+#include <cstdint>
+
 namespace landmarks {
 using FluentSet = std::vector<FactPair>;
 
 std::ostream &
 operator<<(std::ostream &os, const FluentSet &fs);
 
-struct FluentSetComparer {
-    bool operator()(const FluentSet &fs1, const FluentSet &fs2) const {
-        if (fs1.size() != fs2.size()) {
-            return fs1.size() < fs2.size();
-        }
-        for (size_t i = 0; i < fs1.size(); ++i) {
-            if (fs1[i] != fs2[i])
-                return fs1[i] < fs2[i];
-        }
-        return false;
-    }
-};
-
 // an operator in P_m. Corresponds to an operator from the original problem,
 // as well as a set of conditional effects that correspond to noops
 struct PMOp {
     std::vector<int> pc;
     std::vector<int> eff;
-    // pc separated from effect by a value of -1
-    std::vector<std::vector<int>> cond_noops;
-    int index;
+    // the conditional noops of the operator are stored consecutively in the
+    // noop arrays of the factory, starting at first_noop
+    int first_noop;
+    int num_noops;
+
+    PMOp()
+        : first_noop(0),
+          num_noops(0) {
+    }
 };
 
 // represents a fluent in the P_m problem
 struct HMEntry {
-    // propositions that belong to this set
-    FluentSet fluents;
-    // -1 -> current cost infinite
-    // 0 -> present in initial state
-    int level;
-
-    std::list<int> landmarks;
-    std::list<int> necessary; // greedy necessary landmarks, disjoint from landmarks
+    // sorted sets of P_m fluent indices
+    std::vector<int> landmarks;
+    std::vector<int> necessary; // greedy necessary landmarks, disjoint from landmarks
 
-    std::list<int> first_achievers;
+    // sorted set of operator indices
+    std::vector<int> first_achievers;
 
     // first int = op index, second int conditional noop effect
     // -1 for op itself
     std::vector<FactPair> pc_for;
-
-    HMEntry()
-        : level(-1) {
-    }
 };
 
-using FluentSetToIntMap = std::map<FluentSet, int, FluentSetComparer>;
-
 class LandmarkFactoryHM : public LandmarkFactory {
-    using TriggerSet = std::unordered_map<int, std::set<int>>;
+    /*
+      Maps each triggered operator to the conditional noops that have to be
+      recomputed (sorted). An empty vector signals that all noops of the
+      operator have to be recomputed.
+    */
+    using TriggerSet = std::unordered_map<int, std::vector<int>>;
 
     virtual void generate_landmarks(const std::shared_ptr<AbstractTask> &task) override;
 
     void compute_h_m_landmarks(const TaskProxy &task_proxy);
     void compute_noop_landmarks(int op_index, int noop_index,
-                                std::list<int> const &local_landmarks,
-                                std::list<int> const &local_necessary,
-                                int level,
+                                const std::vector<int> &local_landmarks,
+                                const std::vector<int> &local_necessary,
                                 TriggerSet &next_trigger);
 
     void propagate_pm_fact(int factindex, bool newly_discovered,
                            TriggerSet &trigger);
 
-    bool possible_noop_set(const VariablesProxy &variables,
-                           const FluentSet &fs1,
-                           const FluentSet &fs2);
     void build_pm_ops(const TaskProxy &task_proxy);
-    bool interesting(const VariablesProxy &variables,
-                     const FactPair &fact1,
-                     const FactPair &fact2) const;
+    void compute_mutexes(const VariablesProxy &variables);
+    bool interesting(int fact1, int fact2) const {
+        // mutexes can always be safely pruned
+        return !(mutexes_[fact1 * mutex_words_per_fact_ + fact2 / 64] &
+                 (uint64_t(1) << (fact2 % 64)));
+    }
 
     void postprocess(const TaskProxy &task_proxy);
 
@@ -90,8 +81,8 @@ class LandmarkFactoryHM : public LandmarkFactory {
     void initialize(const TaskProxy &task_proxy);
     void free_unneeded_memory();
 
-    void print_fluentset(const VariablesProxy &variables, const FluentSet &fs) const;
-    void print_pm_op(const VariablesProxy &variables, const PMOp &op) const;
+    void print_fluentset(const VariablesProxy &variables, int set_index) const;
+    void print_pm_op(const VariablesProxy &variables, int op_index) const;
 
     const int m_;
     const bool conjunctive_landmarks;
@@ -99,42 +90,75 @@ class LandmarkFactoryHM : public LandmarkFactory {
 
     std::map<int, LandmarkNode *> lm_node_table_;
 
+    /*
+      Facts of the task are numbered consecutively, so that the order of the
+      fact indices matches the order of the FactPairs.
+    */
+    std::vector<int> fact_offsets_;
+    std::vector<FactPair> facts_;
+    // Bit matrix of mutex facts (one row of 64-bit words per fact).
+    int mutex_words_per_fact_;
+    std::vector<uint64_t> mutexes_;
+
     std::vector<HMEntry> h_m_table_;
+    /*
+      The facts of P_m fluent i are stored in ascending order in
+      fluent_facts_[fluent_begin_[i], fluent_begin_[i + 1]).
+    */
+    std::vector<int> fluent_begin_;
+    std::vector<int> fluent_facts_;
+    // reached_fluents_[i] is true iff fluent i has been reached by the fixpoint
+    std::vector<bool> reached_fluents_;
+    // maps the key of each <= m set (see get_fluent_key) to its index
+    utils::HashMap<uint64_t, int> set_indices_;
+    // <m sets in the order in which they induce noops (by size, then lexicographically)
+    std::vector<int> noop_sets_;
+
     std::vector<PMOp> pm_ops_;
-    // maps each <m set to an int
-    FluentSetToIntMap set_indices_;
-    // first is unsat pcs for operator
-    // second is unsat pcs for conditional noops
-    std::vector<std::pair<int, std::vector<int>>> unsat_pc_count_;
-
-    void get_m_sets_(const VariablesProxy &variables, int m, int num_included, int current_var,
-                     FluentSet &current,
-                     std::vector<FluentSet> &subsets);
-
-    void get_m_sets_of_set(const VariablesProxy &variables,
-                           int m, int num_included,
-                           int current_var_index,
-                           FluentSet &current,
-                           std::vector<FluentSet> &subsets,
-                           const FluentSet &superset);
-
-    void get_split_m_sets(const VariablesProxy &variables, int m,
-                          int ss1_num_included, int ss2_num_included,
+    /*
+      Conditional noop effects of all P_m operators. The preconditions of
+      noop i are noop_facts_[noop_begin_[i], noop_separator_[i]), its effects
+      noop_facts_[noop_separator_[i], noop_begin_[i + 1]).
+    */
+    std::vector<int> noop_begin_;
+    std::vector<int> noop_separator_;
+    std::vector<int> noop_facts_;
+    // unsatisfied pcs of operators and conditional noops
+    std::vector<int> unsat_pc_count_;
+    std::vector<int> noop_unsat_pc_count_;
+    // scratch space for the landmark set computations
+    std::vector<int> noop_landmarks_;
+    std::vector<int> noop_necessary_;
+    std::vector<int> union_buffer_;
+
+    uint64_t get_fluent_key(const std::vector<int> &facts) const;
+    int get_set_index(const std::vector<int> &facts) const;
+    std::vector<int> get_fact_indices(const std::vector<FactPair> &facts) const;
+
+    void get_m_sets_(const VariablesProxy &variables, int num_included,
+                     int current_var, std::vector<int> &current);
+
+    void get_m_sets_of_set(int num_included, int current_var_index,
+                           std::vector<int> &current,
+                           std::vector<int> &subsets,
+                           const std::vector<int> &superset);
+
+    void get_split_m_sets(int ss1_num_included, int ss2_num_included,
                           int ss1_var_index, int ss2_var_index,
-                          FluentSet &current,
-                          std::vector<FluentSet> &subsets,
-                          const FluentSet &superset1, const FluentSet &superset2);
+                          std::vector<int> &current,
+                          std::vector<int> &subsets,
+                          const std::vector<int> &superset1,
+                          const std::vector<int> &superset2);
 
-    void get_m_sets(const VariablesProxy &variables, int m, std::vector<FluentSet> &subsets);
+    void get_m_sets(const VariablesProxy &variables);
 
-    void get_m_sets(const VariablesProxy &variables, int m, std::vector<FluentSet> &subsets,
-                    const FluentSet &superset);
+    void get_m_sets(std::vector<int> &subsets, const std::vector<int> &superset);
 
-    void get_m_sets(const VariablesProxy &variables, int m, std::vector<FluentSet> &subsets,
-                    const State &state);
+    void get_m_sets(std::vector<int> &subsets, const State &state);
 
-    void get_split_m_sets(const VariablesProxy &variables, int m, std::vector<FluentSet> &subsets,
-                          const FluentSet &superset1, const FluentSet &superset2);
+    void get_split_m_sets(std::vector<int> &subsets,
+                          const std::vector<int> &superset1,
+                          const std::vector<int> &superset2);
     void print_proposition(const VariablesProxy &variables, const FactPair &fluent) const;
 
 public:
@@ -2,19 +2,87 @@
 
 #include "landmark.h"
 
+#include "../state_registry.h"
+
+#include "../utils/collections.h"
 #include "../utils/logging.h"
 
+#include <bitset>
+
 using namespace std;
 
 namespace landmarks {
+static const int BITS_PER_BLOCK = 64;
+
+// Return the index of the lowest set bit of a non-zero word.
+static int get_lowest_bit(uint64_t word) {
+    assert(word);
+    return bitset<64>((word & -word) - 1).count();
+}
+
 /*
   By default we mark all landmarks as reached, since we do an intersection when
   computing new landmark information.
 */
-LandmarkStatusManager::LandmarkStatusManager(LandmarkGraph &graph)
+LandmarkStatusManager::LandmarkStatusManager(
+    LandmarkGraph &graph, const TaskProxy &task_proxy)
     : lm_graph(graph),
       reached_lms(vector<bool>(graph.get_num_landmarks(), true)),
-      lm_status(graph.get_num_landmarks(), lm_not_reached) {
+      lm_status(graph.get_num_landmarks(), lm_not_reached),
+      last_parent_registry(nullptr),
+      last_parent_id(StateID::no_state) {
+    int num_landmarks = lm_graph.get_num_landmarks();
+    num_blocks = (num_landmarks + BITS_PER_BLOCK - 1) / BITS_PER_BLOCK;
+
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_facts = 0;
+    vector<int> derived_vars;
+    for (VariableProxy var : variables) {
+        fact_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
+        if (var.is_derived()) {
+            derived_vars.push_back(var.get_id());
+        }
+    }
+
+    landmarks_by_fact.resize(num_facts);
+    is_conjunctive.resize(num_landmarks);
+    num_landmark_facts.resize(num_landmarks);
+    parent_ids.resize(num_landmarks);
+    gn_child_ids.resize(num_landmarks);
+    goal_landmarks.assign(num_blocks, 0);
+    for (int id = 0; id < num_landmarks; ++id) {
+        const LandmarkNode *node = lm_graph.get_node(id);
+        const Landmark &landmark = node->get_landmark();
+        for (const FactPair &fact : landmark.facts) {
+            landmarks_by_fact[fact_offsets[fact.var] + fact.value].push_back(id);
+        }
+        is_conjunctive[id] = landmark.conjunctive;
+        num_landmark_facts[id] = landmark.facts.size();
+        if (landmark.is_true_in_goal) {
+            goal_landmarks[id / BITS_PER_BLOCK] |= uint64_t(1) << (id % BITS_PER_BLOCK);
+        }
+        for (const auto &parent : node->parents) {
+            parent_ids[id].push_back(parent.first->get_id());
+        }
+        for (const auto &child : node->children) {
+            if (child.second >= EdgeType::GREEDY_NECESSARY) {
+                gn_child_ids[id].push_back(child.first->get_id());
+            }
+        }
+    }
+
+    OperatorsProxy operators = task_proxy.get_operators();
+    changed_vars_by_operator.resize(operators.size());
+    for (OperatorProxy op : operators) {
+        vector<int> &changed_vars = changed_vars_by_operator[op.get_id()];
+        for (EffectProxy effect : op.get_effects()) {
+            changed_vars.push_back(effect.get_fact().get_variable().get_id());
+        }
+        changed_vars.insert(changed_vars.end(), derived_vars.begin(), derived_vars.end());
+        utils::sort_unique(changed_vars);
+    }
+    num_true_facts.resize(num_landmarks, 0);
 }
 
 BitsetView LandmarkStatusManager::get_reached_landmarks(const State &state) {
@@ -73,7 +141,7 @@ void LandmarkStatusManager::set_reached_landmarks_for_initial_state(
 }
 
 bool LandmarkStatusManager::process_state_transition(
-    const State &parent_ancestor_state, OperatorID,
+    const State &parent_ancestor_state, OperatorID op_id,
     const State &ancestor_state) {
     if (ancestor_state == parent_ancestor_state) {
         // This can happen, e.g., in Satellite-01.
@@ -83,9 +151,9 @@ bool LandmarkStatusManager::process_state_transition(
     const BitsetView parent_reached = get_reached_landmarks(parent_ancestor_state);
     BitsetView reached = get_reached_landmarks(ancestor_state);
 
-    int num_landmarks = lm_graph.get_num_landmarks();
-    assert(reached.size() == num_landmarks);
-    assert(parent_reached.size() == num_landmarks);
+    assert(reached.size() == lm_graph.get_num_landmarks());
+    assert(parent_reached.size() == lm_graph.get_num_landmarks());
+    assert(reached.get_num_blocks() == num_blocks);
 
     /*
        Set all landmarks not reached by this parent as "not reached".
@@ -99,15 +167,21 @@ bool LandmarkStatusManager::process_state_transition(
     */
     reached.intersect(parent_reached);
 
+    compute_successor_true_landmarks(parent_ancestor_state, op_id, ancestor_state);
+    const vector<uint64_t> &true_lms = successor_true_lms.bits;
 
-    // Mark landmarks reached right now as "reached" (if they are "leaves").
-    for (int id = 0; id < num_landmarks; ++id) {
-        if (!reached.test(id)) {
-            LandmarkNode *node = lm_graph.get_node(id);
-            if (node->get_landmark().is_true_in_state(ancestor_state)) {
-                if (landmark_is_leaf(*node, reached)) {
-                    reached.set(id);
-                }
+    /*
+      Mark landmarks reached right now as "reached" (if they are "leaves").
+      Candidates are processed in order of increasing ID, so landmarks
+      reached earlier in the loop count as reached parents of later ones.
+    */
+    for (int block = 0; block < num_blocks; ++block) {
+        uint64_t candidates = true_lms[block] & ~reached.get_block(block);
+        while (candidates) {
+            int id = block * BITS_PER_BLOCK + get_lowest_bit(candidates);
+            candidates &= candidates - 1;
+            if (landmark_is_leaf(id, reached)) {
+                reached.set(id);
             }
         }
     }
@@ -115,30 +189,145 @@ bool LandmarkStatusManager::process_state_transition(
     return true;
 }
 
+void LandmarkStatusManager::subscribe_to_registry(const StateRegistry *registry) {
+    if (registry && subscribed_registries.insert(registry).second) {
+        registry->subscribe(this);
+    }
+}
+
+void LandmarkStatusManager::notify_service_destroyed(
+    const StateRegistry *registry) {
+    subscribed_registries.erase(registry);
+    if (parent_true_lms.registry == registry) {
+        parent_true_lms = TrueLandmarks();
+    }
+    if (successor_true_lms.registry == registry) {
+        successor_true_lms = TrueLandmarks();
+    }
+    if (last_parent_registry == registry) {
+        last_parent_registry = nullptr;
+        last_parent_id = StateID::no_state;
+    }
+}
+
+bool LandmarkStatusManager::is_cached(
+    const TrueLandmarks &true_lms, const State &state) {
+    return true_lms.state_id != StateID::no_state &&
+           true_lms.registry == state.get_registry() &&
+           true_lms.state_id == state.get_id();
+}
+
+void LandmarkStatusManager::compute_true_landmarks(
+    const State &state, TrueLandmarks &true_lms) {
+    subscribe_to_registry(state.get_registry());
+    true_lms.registry = state.get_registry();
+    true_lms.state_id = state.get_id();
+    true_lms.bits.assign(num_blocks, 0);
+    int num_variables = fact_offsets.size();
+    for (int var = 0; var < num_variables; ++var) {
+        int fact = fact_offsets[var] + state[var].get_value();
+        for (int id : landmarks_by_fact[fact]) {
+            if (is_conjunctive[id]) {
+                if (num_true_facts[id]++ == 0) {
+                    dirty_landmarks.push_back(id);
+                }
+                if (num_true_facts[id] != num_landmark_facts[id]) {
+                    continue;
+                }
+            }
+            true_lms.bits[id / BITS_PER_BLOCK] |=
+                uint64_t(1) << (id % BITS_PER_BLOCK);
+        }
+    }
+    for (int id : dirty_landmarks) {
+        num_true_facts[id] = 0;
+    }
+    dirty_landmarks.clear();
+}
+
+/*
+  Compute the landmarks that are true in the successor from those that are
+  true in the parent: only landmarks mentioning a variable that the operator
+  may change can differ. Computing the set for the parent only pays off if
+  it has several successors. We therefore compute it only when we see the
+  same parent for the second time in a row (as in eager search) and compute
+  the successor set from scratch otherwise (as in lazy search, where each
+  transition has a different parent).
+*/
+void LandmarkStatusManager::compute_successor_true_landmarks(
+    const State &parent_ancestor_state, OperatorID op_id,
+    const State &ancestor_state) {
+    if (!is_cached(parent_true_lms, parent_ancestor_state)) {
+        if (last_parent_id != parent_ancestor_state.get_id() ||
+            last_parent_registry != parent_ancestor_state.get_registry()) {
+            subscribe_to_registry(parent_ancestor_state.get_registry());
+            last_parent_registry = parent_ancestor_state.get_registry();
+            last_parent_id = parent_ancestor_state.get_id();
+            compute_true_landmarks(ancestor_state, successor_true_lms);
+            return;
+        }
+        compute_true_landmarks(parent_ancestor_state, parent_true_lms);
+    }
+    subscribe_to_registry(ancestor_state.get_registry());
+    successor_true_lms.registry = ancestor_state.get_registry();
+    successor_true_lms.state_id = ancestor_state.get_id();
+    successor_true_lms.bits = parent_true_lms.bits;
+    vector<uint64_t> &bits = successor_true_lms.bits;
+
+    dirty_landmarks.clear();
+    for (int var : changed_vars_by_operator[op_id.get_index()]) {
+        int old_value = parent_ancestor_state[var].get_value();
+        int new_value = ancestor_state[var].get_value();
+        if (old_value != new_value) {
+            for (int id : landmarks_by_fact[fact_offsets[var] + old_value]) {
+                dirty_landmarks.push_back(id);
+            }
+            for (int id : landmarks_by_fact[fact_offsets[var] + new_value]) {
+                dirty_landmarks.push_back(id);
+            }
+        }
+    }
+    for (int id : dirty_landmarks) {
+        uint64_t mask = uint64_t(1) << (id % BITS_PER_BLOCK);
+        if (lm_graph.get_node(id)->get_landmark().is_true_in_state(ancestor_state)) {
+            bits[id / BITS_PER_BLOCK] |= mask;
+        } else {
+            bits[id / BITS_PER_BLOCK] &= ~mask;
+        }
+    }
+}
+
 void LandmarkStatusManager::update_lm_status(const State &ancestor_state) {
     const BitsetView reached = get_reached_landmarks(ancestor_state);
 
     const int num_landmarks = lm_graph.get_num_landmarks();
-    /* This first loop is necessary as setup for the needed-again
-       check in the second loop. */
     for (int id = 0; id < num_landmarks; ++id) {
         lm_status[id] = reached.test(id) ? lm_reached : lm_not_reached;
     }
-    for (int id = 0; id < num_landmarks; ++id) {
-        if (lm_status[id] == lm_reached
-            && landmark_needed_again(id, ancestor_state)) {
-            lm_status[id] = lm_needed_again;
+
+    if (!is_cached(successor_true_lms, ancestor_state) &&
+        !is_cached(parent_true_lms, ancestor_state)) {
+        compute_true_landmarks(ancestor_state, successor_true_lms);
+    }
+    const vector<uint64_t> &true_lms = is_cached(successor_true_lms, ancestor_state) ?
+        successor_true_lms.bits : parent_true_lms.bits;
+
+    // Only reached landmarks that are false in the state can be needed again.
+    for (int block = 0; block < num_blocks; ++block) {
+        uint64_t candidates = reached.get_block(block) & ~true_lms[block];
+        while (candidates) {
+            int id = block * BITS_PER_BLOCK + get_lowest_bit(candidates);
+            candidates &= candidates - 1;
+            if (landmark_needed_again(id, reached)) {
+                lm_status[id] = lm_needed_again;
+            }
         }
     }
 }
 
 bool LandmarkStatusManager::landmark_needed_again(
-    int id, const State &state) {
-    LandmarkNode *node = lm_graph.get_node(id);
-    const Landmark &landmark = node->get_landmark();
-    if (landmark.is_true_in_state(state)) {
-        return false;
-    } else if (landmark.is_true_in_goal) {
+    int id, const BitsetView &reached) const {
+    if (goal_landmarks[id / BITS_PER_BLOCK] & (uint64_t(1) << (id % BITS_PER_BLOCK))) {
         return true;
     } else {
         /*
@@ -146,9 +335,8 @@ bool LandmarkStatusManager::landmark_needed_again(
           true, since A is a necessary precondition for actions
           achieving B for the first time, it must become true again.
         */
-        for (const auto &child : node->children) {
-            if (child.second >= EdgeType::GREEDY_NECESSARY
-                && lm_status[child.first->get_id()] == lm_not_reached) {
+        for (int child_id : gn_child_ids[id]) {
+            if (!reached.test(child_id)) {
                 return true;
             }
         }
@@ -156,13 +344,12 @@ bool LandmarkStatusManager::landmark_needed_again(
     }
 }
 
-bool LandmarkStatusManager::landmark_is_leaf(const LandmarkNode &node,
-                                             const BitsetView &reached) const {
+bool LandmarkStatusManager::landmark_is_leaf(
+    int id, const BitsetView &reached) const {
     //Note: this is the same as !check_node_orders_disobeyed
-    for (const auto &parent : node.parents) {
-        LandmarkNode *parent_node = parent.first;
+    for (int parent_id : parent_ids[id]) {
         // Note: no condition on edge type here
-        if (!reached.test(parent_node->get_id())) {
+        if (!reached.test(parent_id)) {
             return false;
         }
     }
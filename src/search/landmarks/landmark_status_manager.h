@@ -4,6 +4,16 @@
 #include "landmark_graph.h"
 
 #include "../per_state_bitset.h"
+#include "../state_id.h"
+#include "../task_proxy.h"
+
+#include "../algorithms/subscriber.h"
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+class StateRegistry;
 
 namespace landmarks {
 class LandmarkGraph;
@@ -11,19 +21,77 @@ class LandmarkNode;
 
 enum landmark_status {lm_reached = 0, lm_not_reached = 1, lm_needed_again = 2};
 
-class LandmarkStatusManager {
+class LandmarkStatusManager : public subscriber::Subscriber<StateRegistry> {
+    /*
+      Bitset over landmark IDs of the landmarks that are true in the given
+      state. We cache it for the last parent and the last successor passed
+      to process_state_transition(), so that the successors of a parent only
+      have to recheck the landmarks mentioning changed variables and so that
+      update_lm_status() can reuse the set of a freshly generated state.
+
+      A new registry can be allocated at the address of a destroyed one
+      (e.g., in the next phase of an iterated search), so we subscribe to
+      the registries of cached states and forget the cached information
+      when they are destroyed.
+    */
+    struct TrueLandmarks {
+        const StateRegistry *registry;
+        StateID state_id;
+        std::vector<std::uint64_t> bits;
+
+        TrueLandmarks()
+            : registry(nullptr),
+              state_id(StateID::no_state) {
+        }
+    };
+
     LandmarkGraph &lm_graph;
 
     PerStateBitset reached_lms;
     std::vector<landmark_status> lm_status;
 
-    bool landmark_is_leaf(const LandmarkNode &node, const BitsetView &reached) const;
-    bool landmark_needed_again(int id, const State &state);
+    int num_blocks;
+    std::vector<int> fact_offsets;
+    // IDs of the landmarks that contain a given fact (indexed by fact_offsets).
+    std::vector<std::vector<int>> landmarks_by_fact;
+    std::vector<bool> is_conjunctive;
+    std::vector<int> num_landmark_facts;
+    std::vector<std::vector<int>> parent_ids;
+    // Children reached via greedy-necessary (or stronger) orderings.
+    std::vector<std::vector<int>> gn_child_ids;
+    std::vector<std::uint64_t> goal_landmarks;
+    /*
+      Variables whose values can differ between the parent and the successor
+      of an operator: the effect variables plus all derived variables.
+    */
+    std::vector<std::vector<int>> changed_vars_by_operator;
+
+    TrueLandmarks parent_true_lms;
+    TrueLandmarks successor_true_lms;
+    // Parent of the last transition for which we had no cached information.
+    const StateRegistry *last_parent_registry;
+    StateID last_parent_id;
+    std::unordered_set<const StateRegistry *> subscribed_registries;
+    // Scratch space for computing the sets of true landmarks.
+    std::vector<int> num_true_facts;
+    std::vector<int> dirty_landmarks;
+
+    bool landmark_is_leaf(int id, const BitsetView &reached) const;
+    bool landmark_needed_again(int id, const BitsetView &reached) const;
+
+    void subscribe_to_registry(const StateRegistry *registry);
+    virtual void notify_service_destroyed(const StateRegistry *registry) override;
+
+    static bool is_cached(const TrueLandmarks &true_lms, const State &state);
+    void compute_true_landmarks(const State &state, TrueLandmarks &true_lms);
+    void compute_successor_true_landmarks(
+        const State &parent_ancestor_state, OperatorID op_id,
+        const State &ancestor_state);
 
     void set_reached_landmarks_for_initial_state(
         const State &initial_state, utils::LogProxy &log);
 public:
-    explicit LandmarkStatusManager(LandmarkGraph &graph);
+    LandmarkStatusManager(LandmarkGraph &graph, const TaskProxy &task_proxy);
 
     BitsetView get_reached_landmarks(const State &state);
 
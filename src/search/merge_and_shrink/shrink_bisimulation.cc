@@ -11,6 +11,7 @@
 #include "../utils/collections.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 
 #include <algorithm>
@@ -56,9 +57,9 @@ struct Signature {
     int state;
 
     Signature(int h, bool is_goal, int group_,
-              const SuccessorSignature &succ_signature_,
+              SuccessorSignature succ_signature_,
               int state_)
-        : group(group_), succ_signature(succ_signature_), state(state_) {
+        : group(group_), succ_signature(move(succ_signature_)), state(state_) {
         if (is_goal) {
             assert(h == 0);
             h_and_goal = -1;
@@ -95,10 +96,23 @@ struct Signature {
     }
 };
 
+/*
+  The transitions relevant for bisimulation in compressed sparse row format:
+  the pairs (label group ID, target state) of all transitions starting in
+  state s are stored in entries[offsets[s]] to entries[offsets[s + 1] - 1].
+  For greedy bisimulation, the transitions that are skipped in
+  compute_signatures() are omitted.
+*/
+struct BisimulationTransitions {
+    vector<int> offsets;
+    vector<pair<int, int>> entries;
+};
+
 
 ShrinkBisimulation::ShrinkBisimulation(const Options &opts)
     : greedy(opts.get<bool>("greedy")),
-      at_limit(opts.get<AtLimit>("at_limit")) {
+      at_limit(opts.get<AtLimit>("at_limit")),
+      num_threads(utils::parse_num_threads(opts)) {
 }
 
 int ShrinkBisimulation::initialize_groups(
@@ -239,6 +253,98 @@ void ShrinkBisimulation::compute_signatures(
     ::sort(signatures.begin(), signatures.end());
 }
 
+BisimulationTransitions ShrinkBisimulation::compute_transitions(
+    const TransitionSystem &ts,
+    const Distances &distances) const {
+    int num_states = ts.get_size();
+    auto is_skipped = [&](const Transition &transition, int cost) {
+            if (!greedy) {
+                return false;
+            }
+            int src_h = distances.get_goal_distance(transition.src);
+            int target_h = distances.get_goal_distance(transition.target);
+            if (src_h == INF || target_h == INF) {
+                return true;
+            }
+            assert(target_h + cost >= src_h);
+            return target_h + cost != src_h;
+        };
+
+    BisimulationTransitions result;
+    result.offsets.assign(num_states + 1, 0);
+    for (GroupAndTransitions gat : ts) {
+        int cost = gat.label_group.get_cost();
+        for (const Transition &transition : gat.transitions) {
+            if (!is_skipped(transition, cost)) {
+                ++result.offsets[transition.src + 1];
+            }
+        }
+    }
+    for (int state = 0; state < num_states; ++state) {
+        result.offsets[state + 1] += result.offsets[state];
+    }
+
+    result.entries.resize(result.offsets[num_states]);
+    vector<int> next_entry(result.offsets.begin(), result.offsets.end() - 1);
+    int label_group_counter = 0;
+    for (GroupAndTransitions gat : ts) {
+        int cost = gat.label_group.get_cost();
+        for (const Transition &transition : gat.transitions) {
+            if (!is_skipped(transition, cost)) {
+                result.entries[next_entry[transition.src]++] =
+                    make_pair(label_group_counter, transition.target);
+            }
+        }
+        ++label_group_counter;
+    }
+    return result;
+}
+
+void ShrinkBisimulation::compute_signatures_in_parallel(
+    const TransitionSystem &ts,
+    const Distances &distances,
+    const BisimulationTransitions &transitions,
+    vector<Signature> &signatures,
+    const vector<int> &state_to_group) const {
+    /*
+      Compute the same signatures as compute_signatures(), but let each
+      thread handle a contiguous range of states. Since Signature::operator<
+      is a total order, the sorted result is identical.
+    */
+    int num_states = ts.get_size();
+    signatures.assign(
+        num_states + 2, Signature(-2, false, -1, SuccessorSignature(), -1));
+    signatures[num_states + 1] =
+        Signature(SENTINEL, false, -1, SuccessorSignature(), -1);
+
+    utils::parallel_for(
+        num_threads, 0, num_states,
+        [&](int, int begin, int end) {
+            for (int state = begin; state < end; ++state) {
+                int h = distances.get_goal_distance(state);
+                if (h == INF) {
+                    h = IRRELEVANT;
+                }
+                SuccessorSignature succ_sig;
+                succ_sig.reserve(
+                    transitions.offsets[state + 1] - transitions.offsets[state]);
+                for (int i = transitions.offsets[state];
+                     i < transitions.offsets[state + 1]; ++i) {
+                    const pair<int, int> &entry = transitions.entries[i];
+                    int target_group = state_to_group[entry.second];
+                    assert(target_group != -1 && target_group != SENTINEL);
+                    succ_sig.emplace_back(entry.first, target_group);
+                }
+                utils::sort_unique(succ_sig);
+                signatures[state + 1] = Signature(
+                    h, ts.is_goal_state(state), state_to_group[state],
+                    move(succ_sig), state);
+            }
+        });
+
+    utils::parallel_sort(signatures, num_threads);
+}
+
 StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
     const TransitionSystem &ts,
     const Distances &distances,
@@ -254,6 +360,13 @@ StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
     int num_groups = initialize_groups(ts, distances, state_to_group);
     // log << "number of initial groups: " << num_groups << endl;
 
+    /* The parallel variant precomputes the relevant transitions once
+       instead of iterating over all label groups in every round. */
+    BisimulationTransitions transitions;
+    if (num_threads > 1) {
+        transitions = compute_transitions(ts, distances);
+    }
+
     // TODO: We currently violate this; see issue250
     // assert(num_groups <= target_size);
 
@@ -263,7 +376,12 @@ StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
         stable = true;
 
         signatures.clear();
-        compute_signatures(ts, distances, signatures, state_to_group);
+        if (num_threads > 1) {
+            compute_signatures_in_parallel(
+                ts, distances, transitions, signatures, state_to_group);
+        } else {
+            compute_signatures(ts, distances, signatures, state_to_group);
+        }
 
         // Verify size of signatures and presence of sentinels.
         assert(static_cast<int>(signatures.size()) == num_states + 2);
@@ -346,6 +464,8 @@ StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
        relation since this is one of the code parts relevant to peak
        memory. */
     utils::release_vector_memory(signatures);
+    utils::release_vector_memory(transitions.offsets);
+    utils::release_vector_memory(transitions.entries);
 
     // Generate final result.
     StateEquivalenceRelation equivalence_relation;
@@ -377,6 +497,7 @@ void ShrinkBisimulation::dump_strategy_specific_options(utils::LogProxy &log) co
             ABORT("Unknown setting for at_limit.");
         }
         log << endl;
+        log << "Threads: " << num_threads << endl;
     }
 }
 
@@ -424,6 +545,15 @@ static shared_ptr<ShrinkStrategy>_parse(OptionParser &parser) {
     parser.add_enum_option<AtLimit>(
         "at_limit", at_limit,
         "what to do when the size limit is hit", "RETURN");
+    utils::add_threads_option(parser);
+    parser.document_note(
+        "Parallel computation",
+        "With threads > 1, the transitions relevant for bisimulation are "
+        "stored in a compressed sparse row format before the refinement "
+        "starts. In each refinement round, the state signatures are then "
+        "computed and sorted in parallel. The resulting abstraction is the "
+        "same as for threads=1, but the additional transition copy "
+        "increases peak memory usage.");
 
     Options opts = parser.parse();
 
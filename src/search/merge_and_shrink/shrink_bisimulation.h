@@ -8,6 +8,7 @@ class Options;
 }
 
 namespace merge_and_shrink {
+struct BisimulationTransitions;
 struct Signature;
 
 enum class AtLimit {
@@ -18,6 +19,7 @@ enum class AtLimit {
 class ShrinkBisimulation : public ShrinkStrategy {
     const bool greedy;
     const AtLimit at_limit;
+    const int num_threads;
 
     void compute_abstraction(
         const TransitionSystem &ts,
@@ -35,6 +37,17 @@ class ShrinkBisimulation : public ShrinkStrategy {
         const Distances &distances,
         std::vector<Signature> &signatures,
         const std::vector<int> &state_to_group) const;
+
+    BisimulationTransitions compute_transitions(
+        const TransitionSystem &ts,
+        const Distances &distances) const;
+
+    void compute_signatures_in_parallel(
+        const TransitionSystem &ts,
+        const Distances &distances,
+        const BisimulationTransitions &transitions,
+        std::vector<Signature> &signatures,
+        const std::vector<int> &state_to_group) const;
 protected:
     virtual void dump_strategy_specific_options(utils::LogProxy &log) const override;
     virtual std::string name() const override;
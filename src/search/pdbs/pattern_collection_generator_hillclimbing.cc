@@ -18,11 +18,13 @@
 #include "../utils/markup.h"
 #include "../utils/math.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <limits>
@@ -123,6 +125,7 @@ PatternCollectionGeneratorHillclimbing::PatternCollectionGeneratorHillclimbing(c
       min_improvement(opts.get<int>("min_improvement")),
       max_time(opts.get<double>("max_time")),
       max_generated_patterns(opts.get<int>("max_generated_patterns")),
+      num_threads(utils::parse_num_threads(opts)),
       rng(utils::parse_rng_from_options(opts)),
       num_rejected(0),
       hill_climbing_timer(0) {
@@ -136,7 +139,8 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
     PDBCollection &candidate_pdbs) {
     const Pattern &pattern = pdb.get_pattern();
     int pdb_size = pdb.get_size();
-    int max_pdb_size = 0;
+    PatternCollection new_patterns;
+    bool max_patterns_generated = false;
     for (int pattern_var : pattern) {
         assert(utils::in_bounds(pattern_var, relevant_neighbours));
         const vector<int> &connected_vars = relevant_neighbours[pattern_var];
@@ -166,21 +170,51 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
                       surpass the size limit.
                     */
                     generated_patterns.insert(new_pattern);
-                    candidate_pdbs.push_back(
-                        make_shared<PatternDatabase>(task_proxy, new_pattern));
-                    max_pdb_size = max(max_pdb_size,
-                                       candidate_pdbs.back()->get_size());
-                    if (static_cast<int>(generated_patterns.size()) >= max_generated_patterns)
-                        throw HillClimbingMaxPDBsGenerated();
+                    new_patterns.push_back(move(new_pattern));
+                    if (static_cast<int>(generated_patterns.size()) >= max_generated_patterns) {
+                        max_patterns_generated = true;
+                        break;
+                    }
                 }
             } else {
                 ++num_rejected;
             }
         }
+        if (max_patterns_generated)
+            break;
+    }
+
+    int max_pdb_size = 0;
+    for (shared_ptr<PatternDatabase> &new_pdb : build_pdbs(task_proxy, new_patterns)) {
+        max_pdb_size = max(max_pdb_size, new_pdb->get_size());
+        candidate_pdbs.push_back(move(new_pdb));
     }
+    if (max_patterns_generated)
+        throw HillClimbingMaxPDBsGenerated();
     return max_pdb_size;
 }
 
+PDBCollection PatternCollectionGeneratorHillclimbing::build_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns) const {
+    int num_patterns = patterns.size();
+    PDBCollection pdbs(num_patterns);
+    atomic<bool> timeout(false);
+    utils::parallel_for(
+        num_threads, 0, num_patterns,
+        [&](int, int begin, int end) {
+            for (int i = begin; i < end && !timeout; ++i) {
+                if (hill_climbing_timer->is_expired()) {
+                    timeout = true;
+                    break;
+                }
+                pdbs[i] = make_shared<PatternDatabase>(task_proxy, patterns[i]);
+            }
+        });
+    if (timeout)
+        throw HillClimbingTimeout();
+    return pdbs;
+}
+
 void PatternCollectionGeneratorHillclimbing::sample_states(
     const sampling::RandomWalkSampler &sampler,
     int init_h,
@@ -214,11 +248,8 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     int improvement = 0;
     int best_pdb_index = -1;
 
-    // Iterate over all candidates and search for the best improving pattern/pdb
+    vector<int> candidate_ids;
     for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
-        if (hill_climbing_timer->is_expired())
-            throw HillClimbingTimeout();
-
         const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
         if (!pdb) {
             /* candidate pattern is too large or has already been added to
@@ -234,30 +265,57 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
             candidate_pdbs[i] = nullptr;
             continue;
         }
+        candidate_ids.push_back(i);
+    }
 
-        /*
-          Calculate the "counting approximation" for all sample states: count
-          the number of samples for which the current pattern collection
-          heuristic would be improved if the new pattern was included into it.
-        */
-        /*
-          TODO: The original implementation by Haslum et al. uses m/t as a
-          statistical confidence interval to stop the A*-search (which they use,
-          see above) earlier.
-        */
-        int count = 0;
-        vector<PatternClique> pattern_cliques =
-            current_pdbs->get_pattern_cliques(pdb->get_pattern());
-        for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
-            const State &sample = samples[sample_id];
-            assert(utils::in_bounds(sample_id, samples_h_values));
-            int h_collection = samples_h_values[sample_id];
-            if (is_heuristic_improved(
-                    *pdb, sample, h_collection,
-                    *current_pdbs->get_pattern_databases(), pattern_cliques)) {
-                ++count;
+    /*
+      Calculate the "counting approximation" for all sample states: count
+      the number of samples for which the current pattern collection
+      heuristic would be improved if the new pattern was included into it.
+      The candidates are distributed among the threads and each count is
+      stored at the candidate's position, so the evaluation order doesn't
+      matter.
+    */
+    /*
+      TODO: The original implementation by Haslum et al. uses m/t as a
+      statistical confidence interval to stop the A*-search (which they use,
+      see above) earlier.
+    */
+    int num_candidates = candidate_ids.size();
+    vector<int> counts(num_candidates, 0);
+    atomic<bool> timeout(false);
+    utils::parallel_for(
+        num_threads, 0, num_candidates,
+        [&](int, int begin, int end) {
+            for (int j = begin; j < end && !timeout; ++j) {
+                if (hill_climbing_timer->is_expired()) {
+                    timeout = true;
+                    break;
+                }
+                const PatternDatabase &pdb = *candidate_pdbs[candidate_ids[j]];
+                vector<PatternClique> pattern_cliques =
+                    current_pdbs->get_pattern_cliques(pdb.get_pattern());
+                int count = 0;
+                for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
+                    const State &sample = samples[sample_id];
+                    assert(utils::in_bounds(sample_id, samples_h_values));
+                    int h_collection = samples_h_values[sample_id];
+                    if (is_heuristic_improved(
+                            pdb, sample, h_collection,
+                            *current_pdbs->get_pattern_databases(), pattern_cliques)) {
+                        ++count;
+                    }
+                }
+                counts[j] = count;
             }
-        }
+        });
+    if (timeout)
+        throw HillClimbingTimeout();
+
+    // Select the best improving pattern/pdb in candidate order.
+    for (int j = 0; j < num_candidates; ++j) {
+        int i = candidate_ids[j];
+        int count = counts[j];
         if (count > improvement) {
             improvement = count;
             best_pdb_index = i;
@@ -273,7 +331,7 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
 
 bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
     const PatternDatabase &pdb, const State &sample, int h_collection,
-    const PDBCollection &pdbs, const vector<PatternClique> &pattern_cliques) {
+    const PDBCollection &pdbs, const vector<PatternClique> &pattern_cliques) const {
     const vector<int> &sample_data = sample.get_unpacked_values();
     // h_pattern: h-value of the new pattern
     int h_pattern = pdb.get_value(sample_data);
@@ -530,7 +588,14 @@ void add_hillclimbing_options(OptionParser &parser) {
         "improvement is smaller than the minimal improvement which can be set "
         "as an option), however there is no limit of iterations of the local "
         "search. This is similar to the techniques used in the original "
-        "implementation as described in the paper.",
+        "implementation as described in the paper.\n\n"
+        "With threads > 1, the PDBs for new candidate patterns are built in "
+        "parallel and the candidates are evaluated on the samples in "
+        "parallel. Sampling and the selection of the best candidate remain "
+        "sequential, so the resulting pattern collection does not depend on "
+        "the number of threads unless a time limit is hit. Note that up to "
+        "threads PDBs of size pdb_max_size can be under construction "
+        "simultaneously.",
         true);
 
     parser.add_option<int>(
@@ -570,6 +635,7 @@ void add_hillclimbing_options(OptionParser &parser) {
         "maximum number of generated patterns",
         "infinity",
         Bounds("0", "infinity"));
+    utils::add_threads_option(parser);
     utils::add_rng_options(parser);
     add_generator_options_to_parser(parser);
 }
@@ -36,6 +36,8 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     const int min_improvement;
     const double max_time;
     const int max_generated_patterns;
+    // number of threads for building and evaluating candidate PDBs
+    const int num_threads;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
     std::unique_ptr<IncrementalCanonicalPDBs> current_pdbs;
@@ -49,7 +51,9 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       relevant variable are considered as candidate patterns. If the candidate
       pattern has not been previously considered (not contained in
       generated_patterns) and if building a PDB for it does not surpass the
-      size limit, then the PDB is built and added to candidate_pdbs.
+      size limit, then the PDB is built and added to candidate_pdbs. The
+      candidate patterns are determined first, then their PDBs are built in
+      parallel (see build_pdbs) and added in the original order.
 
       The method returns the size of the largest PDB added to candidate_pdbs.
     */
@@ -60,6 +64,15 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
         std::set<Pattern> &generated_patterns,
         PDBCollection &candidate_pdbs);
 
+    /*
+      Builds the PDBs for the given patterns using num_threads threads. Each
+      thread builds one PDB at a time, so at most num_threads PDBs of size
+      pdb_max_size are under construction simultaneously. Throws
+      HillClimbingTimeout if the time limit is reached.
+    */
+    PDBCollection build_pdbs(
+        const TaskProxy &task_proxy, const PatternCollection &patterns) const;
+
     /*
       Performs num_samples random walks with a length (different for each
       random walk) chosen according to a binomial distribution with
@@ -78,7 +91,9 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     /*
       Searches for the best improving pdb in candidate_pdbs according to the
       counting approximation and the given samples. Returns the improvement and
-      the index of the best pdb in candidate_pdbs.
+      the index of the best pdb in candidate_pdbs. The candidates are evaluated
+      in parallel, but ties are broken in favor of the candidate with the
+      lowest index, so the result does not depend on the number of threads.
     */
     std::pair<int, int> find_best_improving_pdb(
         const std::vector<State> &samples,
@@ -96,7 +111,7 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
         const State &sample,
         int h_collection,
         const PDBCollection &pdbs,
-        const std::vector<PatternClique> &pattern_cliques);
+        const std::vector<PatternClique> &pattern_cliques) const;
 
     /*
       This is the core algorithm of this class. The initial PDB collection
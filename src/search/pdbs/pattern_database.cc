@@ -234,7 +234,8 @@ void PatternDatabase::create_pdb(
         }
     }
 
-    distances.reserve(num_states);
+    vector<int> goal_distances;
+    goal_distances.reserve(num_states);
     // first implicit entry: priority, second entry: index for an abstract state
     priority_queues::AdaptiveQueue<int> pq;
 
@@ -242,9 +243,9 @@ void PatternDatabase::create_pdb(
     for (int state_index = 0; state_index < num_states; ++state_index) {
         if (is_goal_state(state_index, abstract_goals, variables)) {
             pq.push(0, state_index);
-            distances.push_back(0);
+            goal_distances.push_back(0);
         } else {
-            distances.push_back(numeric_limits<int>::max());
+            goal_distances.push_back(numeric_limits<int>::max());
         }
     }
 
@@ -267,7 +268,7 @@ void PatternDatabase::create_pdb(
         pair<int, int> node = pq.pop();
         int distance = node.first;
         int state_index = node.second;
-        if (distance > distances[state_index]) {
+        if (distance > goal_distances[state_index]) {
             continue;
         }
 
@@ -277,9 +278,9 @@ void PatternDatabase::create_pdb(
         for (int op_id : applicable_operator_ids) {
             const AbstractOperator &op = operators[op_id];
             int predecessor = state_index + op.get_hash_effect();
-            int alternative_cost = distances[state_index] + op.get_cost();
-            if (alternative_cost < distances[predecessor]) {
-                distances[predecessor] = alternative_cost;
+            int alternative_cost = goal_distances[state_index] + op.get_cost();
+            if (alternative_cost < goal_distances[predecessor]) {
+                goal_distances[predecessor] = alternative_cost;
                 pq.push(alternative_cost, predecessor);
                 if (compute_plan) {
                     generating_op_ids[predecessor] = op_id;
@@ -306,7 +307,7 @@ void PatternDatabase::create_pdb(
         initial_state.unpack();
         int current_state =
             hash_index(initial_state.get_unpacked_values());
-        if (distances[current_state] != numeric_limits<int>::max()) {
+        if (goal_distances[current_state] != numeric_limits<int>::max()) {
             while (!is_goal_state(current_state, abstract_goals, variables)) {
                 int op_id = generating_op_ids[current_state];
                 assert(op_id != -1);
@@ -338,6 +339,8 @@ void PatternDatabase::create_pdb(
         }
         utils::release_vector_memory(generating_op_ids);
     }
+
+    distances = compact_int_table::CompactIntTable(goal_distances);
 }
 
 bool PatternDatabase::is_goal_state(
@@ -372,9 +375,10 @@ int PatternDatabase::get_value(const vector<int> &state) const {
 double PatternDatabase::compute_mean_finite_h() const {
     double sum = 0;
     int size = 0;
-    for (size_t i = 0; i < distances.size(); ++i) {
-        if (distances[i] != numeric_limits<int>::max()) {
-            sum += distances[i];
+    for (int i = 0; i < distances.size(); ++i) {
+        int h = distances[i];
+        if (h != numeric_limits<int>::max()) {
+            sum += h;
             ++size;
         }
     }
@@ -5,6 +5,8 @@
 
 #include "../task_proxy.h"
 
+#include "../algorithms/compact_int_table.h"
+
 #include <utility>
 #include <vector>
 
@@ -89,10 +91,11 @@ class PatternDatabase {
     int num_states;
 
     /*
-      final h-values for abstract-states.
+      final h-values for abstract-states, stored with the narrowest
+      sufficient integer width.
       dead-ends are represented by numeric_limits<int>::max()
     */
-    std::vector<int> distances;
+    compact_int_table::CompactIntTable distances;
 
     std::vector<int> generating_op_ids;
     std::vector<std::vector<OperatorID>> wildcard_plan;
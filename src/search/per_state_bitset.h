@@ -3,12 +3,13 @@
 
 #include "per_state_array.h"
 
+#include <cstdint>
 #include <vector>
 
 
 class BitsetMath {
 public:
-    using Block = unsigned int;
+    using Block = std::uint64_t;
     static_assert(
         !std::numeric_limits<Block>::is_signed,
         "Block type must be unsigned");
@@ -40,6 +41,14 @@ public:
     bool test(int index) const;
     void intersect(const BitsetView &other);
     int size() const;
+
+    // Word-level access for operations on whole blocks of bits.
+    int get_num_blocks() const {
+        return data.size();
+    }
+    BitsetMath::Block get_block(int block_index) const {
+        return data[block_index];
+    }
 };
 
 
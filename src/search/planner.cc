@@ -6,6 +6,7 @@
 #include "tasks/root_task.h"
 #include "task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "utils/profiling.h"
 #include "utils/system.h"
 #include "utils/timer.h"
 
@@ -59,6 +60,7 @@ int main(int argc, const char **argv) {
 
     engine->save_plan_if_necessary();
     engine->print_statistics();
+    utils::write_profile();
     utils::g_log << "Search time: " << search_timer << endl;
     utils::g_log << "Total time: " << utils::g_timer << endl;
 
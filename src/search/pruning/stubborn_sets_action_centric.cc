@@ -1,5 +1,9 @@
 #include "stubborn_sets_action_centric.h"
 
+#include "../option_parser.h"
+
+#include <algorithm>
+
 using namespace std;
 
 namespace stubborn_sets {
@@ -24,7 +28,9 @@ static bool contain_conflicting_fact(const vector<FactPair> &facts1,
 }
 
 StubbornSetsActionCentric::StubbornSetsActionCentric(const options::Options &opts)
-    : StubbornSets(opts) {
+    : StubbornSets(opts),
+      max_interference_memory(opts.get<int>("max_interference_memory")),
+      num_precomputed_entries(0) {
 }
 
 void StubbornSetsActionCentric::compute_stubborn_set(const State &state) {
@@ -60,4 +66,74 @@ bool StubbornSetsActionCentric::enqueue_stubborn_operator(int op_no) {
     }
     return false;
 }
+
+bool StubbornSetsActionCentric::precompute_relation(
+    const TaskProxy &task_proxy, int relations, OperatorRelation &result) {
+    // Store operators and the values they require or set by variable.
+    int num_variables = task_proxy.get_variables().size();
+    vector<vector<pair<int, int>>> preconditions_by_var(num_variables);
+    vector<vector<pair<int, int>>> effects_by_var(num_variables);
+    for (int op_no = 0; op_no < num_operators; ++op_no) {
+        for (const FactPair &pre : sorted_op_preconditions[op_no]) {
+            preconditions_by_var[pre.var].emplace_back(op_no, pre.value);
+        }
+        for (const FactPair &eff : sorted_op_effects[op_no]) {
+            effects_by_var[eff.var].emplace_back(op_no, eff.value);
+        }
+    }
+
+    size_t max_entries = static_cast<size_t>(max_interference_memory) * 1024 * 1024
+        / sizeof(int);
+    size_t num_entries = num_precomputed_entries;
+    vector<int> marks(num_operators, -1);
+    vector<int> row;
+    auto add_contradicting = [&](
+        int op1_no, const FactPair &fact, const vector<pair<int, int>> &ops) {
+            for (const pair<int, int> &op_and_value : ops) {
+                int op2_no = op_and_value.first;
+                if (op_and_value.second != fact.value && op2_no != op1_no &&
+                    marks[op2_no] != op1_no) {
+                    marks[op2_no] = op1_no;
+                    row.push_back(op2_no);
+                }
+            }
+        };
+    OperatorRelation relation;
+    for (int op1_no = 0; op1_no < num_operators; ++op1_no) {
+        row.clear();
+        for (const FactPair &eff : sorted_op_effects[op1_no]) {
+            if (relations & CONFLICT) {
+                add_contradicting(op1_no, eff, effects_by_var[eff.var]);
+            }
+            if (relations & DISABLES) {
+                add_contradicting(op1_no, eff, preconditions_by_var[eff.var]);
+            }
+        }
+        if (relations & DISABLED_BY) {
+            for (const FactPair &pre : sorted_op_preconditions[op1_no]) {
+                add_contradicting(op1_no, pre, effects_by_var[pre.var]);
+            }
+        }
+        num_entries += row.size() + 1;
+        if (num_entries > max_entries) {
+            return false;
+        }
+        sort(row.begin(), row.end());
+        relation.push_back(move(row));
+    }
+    result = move(relation);
+    num_precomputed_entries = num_entries;
+    return true;
+}
+
+void add_interference_options_to_parser(options::OptionParser &parser) {
+    parser.add_option<int>(
+        "max_interference_memory",
+        "maximum memory in MiB for precomputing the interference relations "
+        "between operators before the search. If the relation needs more "
+        "memory, it is computed on demand for each operator by testing all "
+        "other operators (set to 0 to always do this).",
+        "100",
+        Bounds("0", "2047"));
+}
 }
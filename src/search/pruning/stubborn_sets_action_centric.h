@@ -3,7 +3,25 @@
 
 #include "stubborn_sets.h"
 
+#include "../algorithms/array_pool.h"
+
+namespace options {
+class OptionParser;
+}
+
 namespace stubborn_sets {
+// Basic relations between operators op1 and op2 that can be combined.
+enum Interference {
+    // op1 and op2 have conflicting effects.
+    CONFLICT = 1,
+    // An effect of op1 contradicts a precondition of op2.
+    DISABLES = 2,
+    // An effect of op2 contradicts a precondition of op1.
+    DISABLED_BY = 4
+};
+
+using OperatorRelation = array_pool_template::ArrayPool<int>;
+
 class StubbornSetsActionCentric : public stubborn_sets::StubbornSets {
     /*
       stubborn_queue contains the operator indices of operators that
@@ -12,6 +30,8 @@ class StubbornSetsActionCentric : public stubborn_sets::StubbornSets {
       of the operators in the queue).
     */
     std::vector<int> stubborn_queue;
+    const int max_interference_memory;
+    std::size_t num_precomputed_entries;
 
     virtual void initialize_stubborn_set(const State &state) = 0;
     virtual void handle_stubborn_operator(const State &state, int op_no) = 0;
@@ -21,6 +41,18 @@ protected:
     bool can_disable(int op1_no, int op2_no) const;
     bool can_conflict(int op1_no, int op2_no) const;
 
+    /*
+      Compute the sorted lists of operators op2 != op1 for all operators
+      op1 such that op1 and op2 are in one of the given Interference
+      relations. Instead of testing all pairs of operators, we only look
+      at operators with preconditions or effects on the variables touched
+      by op1. Return false if all precomputed relations together would use
+      more than max_interference_memory. Then the caller has to compute the
+      relation on demand.
+    */
+    bool precompute_relation(
+        const TaskProxy &task_proxy, int relations, OperatorRelation &result);
+
     /*
       Return the first unsatified goal pair,
       or FactPair::no_fact if there is none.
@@ -35,6 +67,8 @@ protected:
     // Return true iff the operator was enqueued.
     bool enqueue_stubborn_operator(int op_no);
 };
+
+extern void add_interference_options_to_parser(options::OptionParser &parser);
 }
 
 #endif
@@ -3,7 +3,9 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/timer.h"
 
 #include <cassert>
 #include <unordered_map>
@@ -104,7 +106,8 @@ static void get_conflicting_vars(const vector<FactPair> &facts1,
 }
 
 StubbornSetsEC::StubbornSetsEC(const options::Options &opts)
-    : StubbornSetsActionCentric(opts) {
+    : StubbornSetsActionCentric(opts),
+      use_precomputed_relations(false) {
 }
 
 void StubbornSetsEC::initialize(const shared_ptr<AbstractTask> &task) {
@@ -120,10 +123,24 @@ void StubbornSetsEC::initialize(const shared_ptr<AbstractTask> &task) {
     compute_operator_preconditions(task_proxy);
     build_reachability_map(task_proxy);
 
-    conflicting_and_disabling.resize(num_operators);
-    conflicting_and_disabling_computed.resize(num_operators, false);
-    disabled.resize(num_operators);
-    disabled_computed.resize(num_operators, false);
+    utils::Timer timer;
+    use_precomputed_relations =
+        precompute_relation(
+            task_proxy, stubborn_sets::CONFLICT | stubborn_sets::DISABLED_BY,
+            precomputed_conflicting_and_disabling) &&
+        precompute_relation(
+            task_proxy, stubborn_sets::DISABLES, precomputed_disabled);
+    if (use_precomputed_relations) {
+        log << "Time for precomputing interference relations: " << timer << endl;
+    } else {
+        log << "Interference relations exceed memory limit, computing them "
+            << "on demand." << endl;
+        precomputed_conflicting_and_disabling = stubborn_sets::OperatorRelation();
+        conflicting_and_disabling.resize(num_operators);
+        conflicting_and_disabling_computed.resize(num_operators, false);
+        disabled.resize(num_operators);
+        disabled_computed.resize(num_operators, false);
+    }
 
     log << "pruning method: stubborn sets ec" << endl;
 }
@@ -241,9 +258,17 @@ void StubbornSetsEC::add_nes_for_fact(const FactPair &fact, const State &state)
 
 void StubbornSetsEC::add_conflicting_and_disabling(int op_no,
                                                    const State &state) {
-    for (int conflict : get_conflicting_and_disabling(op_no)) {
-        if (active_ops[conflict]) {
-            enqueue_stubborn_operator_and_remember_written_vars(conflict, state);
+    if (use_precomputed_relations) {
+        for (int conflict : precomputed_conflicting_and_disabling[op_no]) {
+            if (active_ops[conflict]) {
+                enqueue_stubborn_operator_and_remember_written_vars(conflict, state);
+            }
+        }
+    } else {
+        for (int conflict : get_conflicting_and_disabling(op_no)) {
+            if (active_ops[conflict]) {
+                enqueue_stubborn_operator_and_remember_written_vars(conflict, state);
+            }
         }
     }
 }
@@ -288,35 +313,46 @@ void StubbornSetsEC::initialize_stubborn_set(const State &state) {
     add_nes_for_fact(unsatisfied_goal, state);     // active operators used
 }
 
+void StubbornSetsEC::handle_disabled_operator(
+    int op_no, int disabled_op_no, const State &state, vector<int> &disabled_vars) {
+    if (active_ops[disabled_op_no]) {
+        get_disabled_vars(op_no, disabled_op_no, disabled_vars);
+        if (!disabled_vars.empty()) {     // == can_disable(op1_no, op2_no)
+            bool v_applicable_op_found = false;
+            for (int disabled_var : disabled_vars) {
+                //First case: add o'
+                if (is_v_applicable(disabled_var,
+                                    disabled_op_no,
+                                    state,
+                                    op_preconditions_on_var)) {
+                    enqueue_stubborn_operator_and_remember_written_vars(
+                        disabled_op_no, state);
+                    v_applicable_op_found = true;
+                    break;
+                }
+            }
+
+            //Second case: add a necessary enabling set for o' following S5
+            if (!v_applicable_op_found) {
+                apply_s5(disabled_op_no, state);
+            }
+        }
+    }
+}
+
 void StubbornSetsEC::handle_stubborn_operator(const State &state, int op_no) {
     if (is_applicable(op_no, state)) {
         //Rule S2 & S3
         add_conflicting_and_disabling(op_no, state);     // active operators used
         //Rule S4'
         vector<int> disabled_vars;
-        for (int disabled_op_no : get_disabled(op_no)) {
-            if (active_ops[disabled_op_no]) {
-                get_disabled_vars(op_no, disabled_op_no, disabled_vars);
-                if (!disabled_vars.empty()) {     // == can_disable(op1_no, op2_no)
-                    bool v_applicable_op_found = false;
-                    for (int disabled_var : disabled_vars) {
-                        //First case: add o'
-                        if (is_v_applicable(disabled_var,
-                                            disabled_op_no,
-                                            state,
-                                            op_preconditions_on_var)) {
-                            enqueue_stubborn_operator_and_remember_written_vars(
-                                disabled_op_no, state);
-                            v_applicable_op_found = true;
-                            break;
-                        }
-                    }
-
-                    //Second case: add a necessary enabling set for o' following S5
-                    if (!v_applicable_op_found) {
-                        apply_s5(disabled_op_no, state);
-                    }
-                }
+        if (use_precomputed_relations) {
+            for (int disabled_op_no : precomputed_disabled[op_no]) {
+                handle_disabled_operator(op_no, disabled_op_no, state, disabled_vars);
+            }
+        } else {
+            for (int disabled_op_no : get_disabled(op_no)) {
+                handle_disabled_operator(op_no, disabled_op_no, state, disabled_vars);
             }
         }
     } else {     // op is inapplicable
@@ -343,6 +379,7 @@ static shared_ptr<PruningMethod> _parse(OptionParser &parser) {
             "251-259",
             "AAAI Press",
             "2013"));
+    stubborn_sets::add_interference_options_to_parser(parser);
     add_pruning_options_to_parser(parser);
 
     Options opts = parser.parse();
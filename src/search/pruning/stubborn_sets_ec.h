@@ -15,6 +15,10 @@ private:
     std::vector<bool> disabled_computed;
     std::vector<bool> written_vars;
     std::vector<std::vector<bool>> nes_computed;
+    // Used instead of the lazily computed relations if they fit into memory.
+    stubborn_sets::OperatorRelation precomputed_conflicting_and_disabling;
+    stubborn_sets::OperatorRelation precomputed_disabled;
+    bool use_precomputed_relations;
 
     bool is_applicable(int op_no, const State &state) const;
     void get_disabled_vars(int op1_no, int op2_no,
@@ -28,6 +32,9 @@ private:
     void enqueue_stubborn_operator_and_remember_written_vars(int op_no, const State &state);
     void add_nes_for_fact(const FactPair &fact, const State &state);
     void apply_s5(int op_no, const State &state);
+    void handle_disabled_operator(int op_no, int disabled_op_no,
+                                  const State &state,
+                                  std::vector<int> &disabled_vars);
 protected:
     virtual void initialize_stubborn_set(const State &state) override;
     virtual void handle_stubborn_operator(const State &state, int op_no) override;
@@ -3,19 +3,32 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/timer.h"
 
 using namespace std;
 
 namespace stubborn_sets_simple {
 StubbornSetsSimple::StubbornSetsSimple(const options::Options &opts)
-    : StubbornSetsActionCentric(opts) {
+    : StubbornSetsActionCentric(opts),
+      use_precomputed_interference_relation(false) {
 }
 
 void StubbornSetsSimple::initialize(const shared_ptr<AbstractTask> &task) {
     StubbornSets::initialize(task);
-    interference_relation.resize(num_operators);
-    interference_relation_computed.resize(num_operators, false);
+    utils::Timer timer;
+    use_precomputed_interference_relation = precompute_relation(
+        TaskProxy(*task), stubborn_sets::CONFLICT | stubborn_sets::DISABLES |
+        stubborn_sets::DISABLED_BY, precomputed_interference_relation);
+    if (use_precomputed_interference_relation) {
+        log << "Time for precomputing interference relation: " << timer << endl;
+    } else {
+        log << "Interference relation exceeds memory limit, computing it "
+            << "on demand." << endl;
+        interference_relation.resize(num_operators);
+        interference_relation_computed.resize(num_operators, false);
+    }
     log << "pruning method: stubborn sets simple" << endl;
 }
 
@@ -47,8 +60,14 @@ void StubbornSetsSimple::add_necessary_enabling_set(const FactPair &fact) {
 
 // Add all operators that interfere with op.
 void StubbornSetsSimple::add_interfering(int op_no) {
-    for (int interferer_no : get_interfering_operators(op_no)) {
-        enqueue_stubborn_operator(interferer_no);
+    if (use_precomputed_interference_relation) {
+        for (int interferer_no : precomputed_interference_relation[op_no]) {
+            enqueue_stubborn_operator(interferer_no);
+        }
+    } else {
+        for (int interferer_no : get_interfering_operators(op_no)) {
+            enqueue_stubborn_operator(interferer_no);
+        }
     }
 }
 
@@ -101,6 +120,7 @@ static shared_ptr<PruningMethod> _parse(OptionParser &parser) {
             "323-331",
             "AAAI Press",
             "2014"));
+    stubborn_sets::add_interference_options_to_parser(parser);
     add_pruning_options_to_parser(parser);
 
     Options opts = parser.parse();
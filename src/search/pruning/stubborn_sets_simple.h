@@ -11,6 +11,9 @@ class StubbornSetsSimple : public stubborn_sets::StubbornSetsActionCentric {
        of operators that interfere with op1. */
     std::vector<std::vector<int>> interference_relation;
     std::vector<bool> interference_relation_computed;
+    // Used instead of the two members above if it fits into memory.
+    stubborn_sets::OperatorRelation precomputed_interference_relation;
+    bool use_precomputed_interference_relation;
 
     void add_necessary_enabling_set(const FactPair &fact);
     void add_interfering(int op_no);
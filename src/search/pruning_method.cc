@@ -13,6 +13,11 @@ using namespace std;
 
 PruningMethod::PruningMethod(const options::Options &opts)
     : timer(false),
+      prune_profile(
+          utils::register_profile_entry(opts.get_unparsed_config(), "prune")),
+      pruned_operators_profile(
+          utils::register_profile_entry(
+              opts.get_unparsed_config(), "pruned_operators")),
       log(utils::get_log_from_options(opts)),
       task(nullptr) {
 }
@@ -36,7 +41,12 @@ void PruningMethod::prune_operators(
         timer.resume();
     }
     int num_ops_before_pruning = op_ids.size();
-    prune(state, op_ids);
+    {
+        utils::ScopedProfileTimer profile_timer(prune_profile);
+        prune(state, op_ids);
+    }
+    utils::add_profile_count(
+        pruned_operators_profile, num_ops_before_pruning - op_ids.size());
     num_successors_before_pruning += num_ops_before_pruning;
     num_successors_after_pruning += op_ids.size();
     if (log.is_at_least_verbose()) {
@@ -4,6 +4,7 @@
 #include "operator_id.h"
 
 #include "../utils/logging.h"
+#include "../utils/profiling.h"
 #include "../utils/timer.h"
 
 #include <memory>
@@ -23,6 +24,8 @@ class Options;
 
 class PruningMethod {
     utils::Timer timer;
+    utils::ProfileEntry *prune_profile;
+    utils::ProfileEntry *pruned_operators_profile;
     friend class limited_pruning::LimitedPruning;
 
     virtual void prune(
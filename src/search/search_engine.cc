@@ -10,6 +10,7 @@
 #include "task_utils/task_properties.h"
 #include "tasks/root_task.h"
 #include "utils/countdown_timer.h"
+#include "utils/memory.h"
 #include "utils/rng_options.h"
 #include "utils/system.h"
 #include "utils/timer.h"
@@ -23,6 +24,33 @@ using utils::ExitCode;
 
 class PruningMethod;
 
+static shared_ptr<StateRegistry> g_shared_state_registry;
+
+SharedStateRegistryScope::SharedStateRegistryScope(
+    const shared_ptr<StateRegistry> &state_registry)
+    : previous_registry(g_shared_state_registry) {
+    state_registry->mark_as_shared();
+    g_shared_state_registry = state_registry;
+}
+
+SharedStateRegistryScope::~SharedStateRegistryScope() {
+    g_shared_state_registry = previous_registry;
+}
+
+static shared_ptr<StateRegistry> get_state_registry(const TaskProxy &task_proxy) {
+    if (g_shared_state_registry) {
+        return g_shared_state_registry;
+    }
+    return make_shared<StateRegistry>(task_proxy);
+}
+
+static shared_ptr<utils::SegmentMemory> install_segment_memory(
+    const Options &opts) {
+    shared_ptr<utils::SegmentMemory> memory = utils::parse_segment_memory(opts);
+    utils::set_default_segment_memory(memory);
+    return memory;
+}
+
 successor_generator::SuccessorGenerator &get_successor_generator(
     const TaskProxy &task_proxy, utils::LogProxy &log) {
     log << "Building successor generator..." << flush;
@@ -47,13 +75,28 @@ SearchEngine::SearchEngine(const Options &opts)
       task(tasks::g_root_task),
       task_proxy(*task),
       log(utils::get_log_from_options(opts)),
-      state_registry(task_proxy),
+      previous_segment_memory(utils::get_default_segment_memory()),
+      segment_memory(install_segment_memory(opts)),
+      mapped_segments(opts.get<bool>("mapped_segments")),
+      shared_state_registry(get_state_registry(task_proxy)),
+      state_registry(*shared_state_registry),
       successor_generator(get_successor_generator(task_proxy, log)),
-      search_space(state_registry, log),
+      search_space(state_registry, task_proxy, log,
+                   opts.get<bool>("compact_search_nodes"),
+                   opts.get<OperatorCost>("cost_type")),
       statistics(log),
       cost_type(opts.get<OperatorCost>("cost_type")),
       is_unit_cost(task_properties::is_unit_cost(task_proxy)),
-      max_time(opts.get<double>("max_time")) {
+      max_time(opts.get<double>("max_time")),
+      successor_generation_profile(
+          utils::register_profile_entry(
+              opts.get_unparsed_config(), "successor_generation")),
+      open_list_insert_profile(
+          utils::register_profile_entry(
+              opts.get_unparsed_config(), "open_list_insert")),
+      open_list_remove_min_profile(
+          utils::register_profile_entry(
+              opts.get_unparsed_config(), "open_list_remove_min")) {
     if (opts.get<int>("bound") < 0) {
         cerr << "error: negative cost bound " << opts.get<int>("bound") << endl;
         utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
@@ -63,6 +106,7 @@ SearchEngine::SearchEngine(const Options &opts)
 }
 
 SearchEngine::~SearchEngine() {
+    utils::set_default_segment_memory(previous_segment_memory);
 }
 
 bool SearchEngine::found_solution() const {
@@ -88,6 +132,8 @@ void SearchEngine::search() {
     utils::CountdownTimer timer(max_time);
     while (status == IN_PROGRESS) {
         status = step();
+        utils::check_memory_pressure();
+        utils::write_profile_snapshot_if_due();
         if (timer.is_expired()) {
             log << "Time limit reached. Abort search." << endl;
             status = TIMEOUT;
@@ -96,6 +142,9 @@ void SearchEngine::search() {
     }
     // TODO: Revise when and which search times are logged.
     log << "Actual search time: " << timer.get_elapsed_time() << endl;
+    if (mapped_segments || log.is_at_least_verbose()) {
+        segment_memory->print_statistics(log);
+    }
 }
 
 bool SearchEngine::check_goal_and_set_plan(const State &state) {
@@ -148,6 +197,15 @@ void SearchEngine::add_options_to_parser(OptionParser &parser) {
         "experiments. Timed-out searches are treated as failed searches, "
         "just like incomplete search algorithms that exhaust their search space.",
         "infinity");
+    parser.add_option<bool>(
+        "compact_search_nodes",
+        "store 8 instead of 16 bytes per search node by not storing the "
+        "creating operators and, if real and adjusted costs coincide, the "
+        "real g values. Plans are traced with the cheapest operator between "
+        "each state and its parent, which is never more expensive than the "
+        "operator that reached the state.",
+        "false");
+    utils::add_segment_memory_options_to_parser(parser);
     utils::add_log_options_to_parser(parser);
 }
 
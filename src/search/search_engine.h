@@ -11,7 +11,10 @@
 #include "task_proxy.h"
 
 #include "utils/logging.h"
+#include "utils/profiling.h"
+#include "utils/segment_allocator.h"
 
+#include <memory>
 #include <vector>
 
 namespace options {
@@ -42,7 +45,17 @@ protected:
 
     mutable utils::LogProxy log;
     PlanManager plan_manager;
-    StateRegistry state_registry;
+    /*
+      segment_memory is the source of the segments for the state registry
+      and per-state information. It is the default segment memory while
+      the engine exists. The destructor restores previous_segment_memory.
+    */
+    const std::shared_ptr<utils::SegmentMemory> previous_segment_memory;
+    const std::shared_ptr<utils::SegmentMemory> segment_memory;
+    const bool mapped_segments;
+    // The registry is shared with other engines inside a SharedStateRegistryScope.
+    const std::shared_ptr<StateRegistry> shared_state_registry;
+    StateRegistry &state_registry;
     const successor_generator::SuccessorGenerator &successor_generator;
     SearchSpace search_space;
     SearchProgress search_progress;
@@ -51,6 +64,10 @@ protected:
     OperatorCost cost_type;
     bool is_unit_cost;
     double max_time;
+    // Profile entries for the search engine's configuration string.
+    utils::ProfileEntry *successor_generation_profile;
+    utils::ProfileEntry *open_list_insert_profile;
+    utils::ProfileEntry *open_list_remove_min_profile;
 
     virtual void initialize() {}
     virtual SearchStatus step() = 0;
@@ -79,6 +96,21 @@ public:
     static void add_succ_order_options(options::OptionParser &parser);
 };
 
+/*
+  Search engines that are created while an object of this class exists use
+  the given state registry instead of creating their own one. Since
+  per-state data lives as long as its registry, this allows IteratedSearch
+  to keep the states and the cached heuristic values of previous phases.
+  Scopes may be nested.
+*/
+class SharedStateRegistryScope {
+    std::shared_ptr<StateRegistry> previous_registry;
+public:
+    explicit SharedStateRegistryScope(
+        const std::shared_ptr<StateRegistry> &state_registry);
+    ~SharedStateRegistryScope();
+};
+
 /*
   Print evaluator values of all evaluators evaluated in the evaluation context.
 */
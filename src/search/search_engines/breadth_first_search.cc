@@ -1,5 +1,6 @@
 #include "breadth_first_search.h"
 
+#include "parallel_breadth_first_search.h"
 #include "search_common.h"
 
 #include "../option_parser.h"
@@ -9,6 +10,9 @@
 #include "../task_utils/successor_generator.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "../utils/parallel.h"
+#include "../utils/segment_allocator.h"
+#include "../utils/system.h"
 
 #include <cassert>
 #include <cstdlib>
@@ -23,6 +27,11 @@ BreadthFirstSearch::BreadthFirstSearch(const Options &opts)
       last_plan_cost(-1),
       pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")) {
     assert(cost_type == ONE);
+    // We visit the states in the order of their IDs, starting with 0.
+    if (state_registry.size() > 0) {
+        cerr << "Breadth-first search can't use a shared state registry." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
 }
 
 void BreadthFirstSearch::initialize() {
@@ -141,18 +150,32 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
         "true");
 
     add_pruning_option(parser);
+    utils::add_threads_option(parser);
+    utils::add_segment_memory_options_to_parser(parser);
     utils::add_log_options_to_parser(parser);
+    parser.document_note(
+        "Parallel search",
+        "With threads > 1, each layer is expanded in parallel and the "
+        "successors are deduplicated in parallel (see "
+        "search_engines/parallel_breadth_first_search.h). The layers contain "
+        "the same states as with one thread, but the goal test is applied to "
+        "a whole layer before expanding it. Calls to the pruning method are "
+        "serialized.");
 
     Options opts = parser.parse();
 
     opts.set<OperatorCost>("cost_type", ONE);
     opts.set<int>("bound", numeric_limits<int>::max());
     opts.set<double>("max_time", numeric_limits<double>::infinity());
+    opts.set<bool>("compact_search_nodes", false);
 
     if (parser.dry_run()) {
         return nullptr;
     }
 
+    if (utils::parse_num_threads(opts) > 1) {
+        return make_shared<ParallelBreadthFirstSearch>(opts);
+    }
     return make_shared<BreadthFirstSearch>(opts);
 }
 
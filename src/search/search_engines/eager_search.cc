@@ -33,6 +33,17 @@ EagerSearch::EagerSearch(const Options &opts)
         cerr << "lazy_evaluator must cache its estimates" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
     }
+    if (opts.get<bool>("incremental_successors")) {
+        if (opts.get<bool>("compact_search_nodes")) {
+            cerr << "incremental_successors needs the creating operators, "
+                 << "which compact_search_nodes doesn't store" << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+        applicable_operators_cache =
+            applicable_operators_cache::create_applicable_operators_cache(
+                task_proxy, state_registry,
+                opts.get<int>("max_successor_cache_memory"), log);
+    }
 }
 
 void EagerSearch::initialize() {
@@ -106,6 +117,9 @@ void EagerSearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
     pruning_method->print_statistics();
+    if (applicable_operators_cache) {
+        applicable_operators_cache->print_statistics(log);
+    }
 }
 
 SearchStatus EagerSearch::step() {
@@ -115,7 +129,11 @@ SearchStatus EagerSearch::step() {
             log << "Completely explored state space -- no solution!" << endl;
             return FAILED;
         }
-        StateID id = open_list->remove_min();
+        StateID id = StateID::no_state;
+        {
+            utils::ScopedProfileTimer profile_timer(open_list_remove_min_profile);
+            id = open_list->remove_min();
+        }
         State s = state_registry.lookup_state(id);
         node.emplace(search_space.get_node(s));
 
@@ -173,7 +191,16 @@ SearchStatus EagerSearch::step() {
         return SOLVED;
 
     vector<OperatorID> applicable_ops;
-    successor_generator.generate_applicable_ops(s, applicable_ops);
+    {
+        utils::ScopedProfileTimer profile_timer(successor_generation_profile);
+        if (applicable_operators_cache) {
+            applicable_operators_cache->generate_applicable_ops(
+                s, node->get_parent_state_id(), node->get_creating_operator(),
+                applicable_ops);
+        } else {
+            successor_generator.generate_applicable_ops(s, applicable_ops);
+        }
+    }
 
     /*
       TODO: When preferred operators are in use, a preferred operator will be
@@ -229,7 +256,10 @@ SearchStatus EagerSearch::step() {
             }
             succ_node.open(*node, op, get_adjusted_cost(op));
 
-            open_list->insert(succ_eval_context, succ_state.get_id());
+            {
+                utils::ScopedProfileTimer profile_timer(open_list_insert_profile);
+                open_list->insert(succ_eval_context, succ_state.get_id());
+            }
             if (search_progress.check_progress(succ_eval_context)) {
                 statistics.print_checkpoint_line(succ_node.get_g());
                 reward_progress();
@@ -269,6 +299,7 @@ SearchStatus EagerSearch::step() {
                   rather than a recomputation of the evaluator value
                   from scratch.
                 */
+                utils::ScopedProfileTimer profile_timer(open_list_insert_profile);
                 open_list->insert(succ_eval_context, succ_state.get_id());
             } else {
                 // If we do not reopen closed nodes, we just update the parent pointers.
@@ -310,6 +341,7 @@ void EagerSearch::update_f_value_statistics(EvaluationContext &eval_context) {
 
 void add_options_to_parser(OptionParser &parser) {
     SearchEngine::add_pruning_option(parser);
+    applicable_operators_cache::add_options_to_parser(parser);
     SearchEngine::add_options_to_parser(parser);
 }
 }
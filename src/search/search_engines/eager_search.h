@@ -4,6 +4,8 @@
 #include "../open_list.h"
 #include "../search_engine.h"
 
+#include "../task_utils/applicable_operators_cache.h"
+
 #include <memory>
 #include <vector>
 
@@ -28,6 +30,9 @@ class EagerSearch : public SearchEngine {
 
     std::shared_ptr<PruningMethod> pruning_method;
 
+    std::unique_ptr<applicable_operators_cache::ApplicableOperatorsCache>
+    applicable_operators_cache;
+
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(EvaluationContext &eval_context);
     void reward_progress();
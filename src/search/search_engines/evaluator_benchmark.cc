@@ -0,0 +1,139 @@
+#include "evaluator_benchmark.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/sampling.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/rng.h"
+#include "../utils/rng_options.h"
+#include "../utils/timer.h"
+
+#include <set>
+
+using namespace std;
+
+namespace evaluator_benchmark {
+EvaluatorBenchmark::EvaluatorBenchmark(const Options &opts)
+    : SearchEngine(opts),
+      evaluators(opts.get_list<shared_ptr<Evaluator>>("evals")),
+      num_states(opts.get<int>("num_states")),
+      max_walk_length(opts.get<int>("max_walk_length")),
+      repetitions(opts.get<int>("repetitions")),
+      rng(utils::parse_rng_from_options(opts)) {
+}
+
+void EvaluatorBenchmark::initialize() {
+    set<Evaluator *> path_dependent_evaluators;
+    for (const shared_ptr<Evaluator> &evaluator : evaluators) {
+        evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    }
+    if (!path_dependent_evaluators.empty()) {
+        if (log.is_warning()) {
+            log << "Warning: replaying states is not meaningful for "
+                << "path-dependent evaluators." << endl;
+        }
+        State initial_state = state_registry.get_initial_state();
+        for (Evaluator *evaluator : path_dependent_evaluators) {
+            evaluator->notify_initial_state(initial_state);
+        }
+    }
+    record_states();
+}
+
+void EvaluatorBenchmark::record_states() {
+    utils::Timer timer;
+    int num_generated = 0;
+    recorded_states = sampling::record_random_walk_states(
+        state_registry, successor_generator, num_states, max_walk_length,
+        *rng, num_generated);
+    statistics.inc_generated(num_generated);
+    log << "Recorded " << recorded_states.size() << " states ("
+        << state_registry.size() << " distinct) in " << timer << endl;
+}
+
+void EvaluatorBenchmark::replay_states(Evaluator &evaluator) {
+    utils::Timer timer;
+    long long checksum = 0;
+    long long num_preferred_operators = 0;
+    int num_dead_ends = 0;
+    for (int rep = 0; rep < repetitions; ++rep) {
+        for (StateID id : recorded_states) {
+            State state = state_registry.lookup_state(id);
+            /*
+              Asking for preferred operators bypasses the heuristic cache,
+              so every repetition measures a full evaluation.
+            */
+            EvaluationContext eval_context(state, nullptr, true);
+            const EvaluationResult &result = eval_context.get_result(&evaluator);
+            if (result.is_infinite()) {
+                ++num_dead_ends;
+            } else {
+                checksum += result.get_evaluator_value();
+            }
+            num_preferred_operators += result.get_preferred_operators().size();
+        }
+    }
+    double time = timer();
+    int num_evaluations = repetitions * recorded_states.size();
+    statistics.inc_evaluations(num_evaluations);
+    log << "Evaluator " << evaluator.get_description() << ": "
+        << num_evaluations << " evaluations in " << time << "s ("
+        << time / num_evaluations * 1e6 << "us per state), "
+        << num_dead_ends / repetitions << " dead ends, checksum "
+        << checksum / repetitions << ", "
+        << num_preferred_operators / repetitions
+        << " preferred operators" << endl;
+}
+
+SearchStatus EvaluatorBenchmark::step() {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators) {
+        replay_states(*evaluator);
+    }
+    return FAILED;
+}
+
+void EvaluatorBenchmark::print_statistics() const {
+    statistics.print_detailed_statistics();
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Evaluator benchmark",
+        "Record states with random walks from the initial state and "
+        "evaluate each of them with the given evaluators. For each "
+        "evaluator, the time per state, the sum of all finite values "
+        "(checksum) and the number of preferred operators are reported. The search never finds a plan.");
+    parser.add_list_option<shared_ptr<Evaluator>>(
+        "evals", "evaluators to benchmark");
+    parser.add_option<int>(
+        "num_states",
+        "number of states to record",
+        "1000",
+        Bounds("1", "infinity"));
+    parser.add_option<int>(
+        "max_walk_length",
+        "restart random walks from the initial state after this many steps",
+        "100",
+        Bounds("0", "infinity"));
+    parser.add_option<int>(
+        "repetitions",
+        "number of times each state is evaluated",
+        "1",
+        Bounds("1", "infinity"));
+    utils::add_rng_options(parser);
+    SearchEngine::add_options_to_parser(parser);
+
+    Options opts = parser.parse();
+    if (parser.dry_run()) {
+        return nullptr;
+    }
+    return make_shared<EvaluatorBenchmark>(opts);
+}
+
+static Plugin<SearchEngine> _plugin("benchmark_evaluators", _parse);
+}
@@ -0,0 +1,49 @@
+#ifndef SEARCH_ENGINES_EVALUATOR_BENCHMARK_H
+#define SEARCH_ENGINES_EVALUATOR_BENCHMARK_H
+
+#include "../search_engine.h"
+
+#include <memory>
+#include <vector>
+
+class Evaluator;
+
+namespace options {
+class Options;
+}
+
+namespace utils {
+class RandomNumberGenerator;
+}
+
+namespace evaluator_benchmark {
+/*
+  Record a fixed set of states with random walks and measure how long the
+  given evaluators take to evaluate them. The states only depend on the
+  random seed, so the reported checksums can be used to compare the
+  values of different implementations.
+*/
+class EvaluatorBenchmark : public SearchEngine {
+    const std::vector<std::shared_ptr<Evaluator>> evaluators;
+    const int num_states;
+    const int max_walk_length;
+    const int repetitions;
+    std::shared_ptr<utils::RandomNumberGenerator> rng;
+
+    std::vector<StateID> recorded_states;
+
+    void record_states();
+    void replay_states(Evaluator &evaluator);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit EvaluatorBenchmark(const options::Options &opts);
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
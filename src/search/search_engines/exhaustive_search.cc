@@ -1,11 +1,16 @@
 #include "exhaustive_search.h"
 
+#include "state_space_dump.h"
+
 #include "../option_parser.h"
 #include "../plugin.h"
 
 #include "../task_utils/successor_generator.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/segment_allocator.h"
+#include "../utils/system.h"
 
 #include <cassert>
 
@@ -17,43 +22,63 @@ static bool is_strips_fact(const string &fact_name) {
            fact_name.rfind("NegatedAtom", 0) == string::npos;
 }
 
-static vector<vector<int>> construct_and_dump_fact_mapping(
-    const TaskProxy &task_proxy) {
+ExhaustiveSearch::ExhaustiveSearch(const Options &opts)
+    : SearchEngine(opts),
+      format(opts.get<DumpFormat>("format")),
+      filename(opts.get<string>("filename")),
+      compress(opts.get<bool>("compress")),
+      current_state_id(0) {
+    assert(cost_type == ONE);
+    // We visit the states in the order of their IDs, starting with 0.
+    if (state_registry.size() > 0) {
+        cerr << "Exhaustive search can't use a shared state registry." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+ExhaustiveSearch::~ExhaustiveSearch() {
+}
+
+void ExhaustiveSearch::construct_and_dump_fact_mapping() {
     string atom_prefix = "Atom ";
     int num_variables = task_proxy.get_variables().size();
-    vector<vector<int>> mapping(num_variables);
+    fact_mapping.resize(num_variables);
     int next_atom_index = 0;
     for (int var = 0; var < num_variables; ++var) {
         int domain_size = task_proxy.get_variables()[var].get_domain_size();
-        mapping[var].resize(domain_size);
+        fact_mapping[var].resize(domain_size);
         for (int val = 0; val < domain_size; ++val) {
             string fact_name = task_proxy.get_variables()[var].get_fact(val).get_name();
             if (is_strips_fact(fact_name)) {
-                mapping[var][val] = next_atom_index;
-                cout << "F " << next_atom_index << " "
-                     << fact_name.substr(atom_prefix.size()) << endl;
+                fact_mapping[var][val] = next_atom_index;
+                string atom_name = fact_name.substr(atom_prefix.size());
+                if (writer) {
+                    writer->add_fact(next_atom_index, atom_name);
+                } else {
+                    cout << "F " << next_atom_index << " " << atom_name << endl;
+                }
                 ++next_atom_index;
             } else {
-                mapping[var][val] = -1;
+                fact_mapping[var][val] = -1;
             }
         }
     }
-    return mapping;
-}
-
-ExhaustiveSearch::ExhaustiveSearch(const Options &opts)
-    : SearchEngine(opts) {
-    assert(cost_type == ONE);
 }
 
 void ExhaustiveSearch::initialize() {
     utils::g_log << "Dumping the reachable state space..." << endl;
-    cout << "# F (fact): [fact ID] [name]" << endl;
-    cout << "# G (goal state): [goal state ID] [fact ID 1] [fact ID 2] ..." << endl;
-    cout << "# N (non-goal state): [non-goal state ID] [fact ID 1] [fact ID 2] ..." << endl;
-    cout << "# T (transition): [source state ID] [target state ID]" << endl;
-    cout << "# The initial state has ID 0." << endl;
-    fact_mapping = construct_and_dump_fact_mapping(task_proxy);
+    if (format == DumpFormat::BINARY) {
+        utils::g_log << "Writing binary dump to " << filename << endl;
+        writer = utils::make_unique_ptr<state_space_dump::StateSpaceWriter>(
+            filename, compress);
+    } else {
+        cout << "# F (fact): [fact ID] [name]" << endl;
+        cout << "# G (goal state): [goal state ID] [fact ID 1] [fact ID 2] ..." << endl;
+        cout << "# N (non-goal state): [non-goal state ID] [fact ID 1] [fact ID 2] ..." << endl;
+        cout << "# T (transition): [source state ID] [target state ID]" << endl;
+        cout << "# The initial state has ID 0." << endl;
+    }
+    construct_and_dump_fact_mapping();
     assert(state_registry.size() <= 1);
     State initial_state = state_registry.get_initial_state();
     statistics.inc_generated();
@@ -66,28 +91,64 @@ void ExhaustiveSearch::print_statistics() const {
     search_space.print_statistics();
 }
 
-void ExhaustiveSearch::dump_state(const State &state) const {
-    char state_type = (task_properties::is_goal_state(task_proxy, state)) ? 'G' : 'N';
-    cout << state_type << " " << state.get_id().value;
+void ExhaustiveSearch::dump_state(const State &state) {
+    bool is_goal = task_properties::is_goal_state(task_proxy, state);
+    fact_ids.clear();
     for (FactProxy fact_proxy : state) {
         FactPair fact = fact_proxy.get_pair();
         int fact_id = fact_mapping[fact.var][fact.value];
         if (fact_id != -1) {
-            cout << " " << fact_id;
+            fact_ids.push_back(fact_id);
         }
     }
-    cout << endl;
+
+    if (writer) {
+        writer->add_state(is_goal, fact_ids, successor_ids);
+        return;
+    }
+
+    // Write all lines of the state at once and without flushing.
+    string state_id = to_string(state.get_id().value);
+    text.clear();
+    text += is_goal ? 'G' : 'N';
+    text += ' ';
+    text += state_id;
+    for (int fact_id : fact_ids) {
+        text += ' ';
+        text += to_string(fact_id);
+    }
+    text += '\n';
+    for (int succ_id : successor_ids) {
+        text += "T ";
+        text += state_id;
+        text += ' ';
+        text += to_string(succ_id);
+        text += '\n';
+    }
+    cout << text;
+}
+
+void ExhaustiveSearch::finish_dump() {
+    if (writer) {
+        writer->finish();
+        utils::g_log << "Wrote " << writer->get_num_states() << " states to "
+                     << filename << ": " << writer->get_written_bytes() / 1024
+                     << " KB (" << writer->get_uncompressed_bytes() / 1024
+                     << " KB uncompressed)" << endl;
+    } else {
+        cout.flush();
+    }
 }
 
 SearchStatus ExhaustiveSearch::step() {
     if (current_state_id == static_cast<int>(state_registry.size())) {
+        finish_dump();
         utils::g_log << "Finished dumping the reachable state space." << endl;
         return FAILED;
     }
 
     State s = state_registry.lookup_state(StateID(current_state_id));
     statistics.inc_expanded();
-    dump_state(s);
 
     /* Next time we'll look at the next state that was created in the registry.
        This results in a breadth-first order. */
@@ -97,12 +158,14 @@ SearchStatus ExhaustiveSearch::step() {
     successor_generator.generate_applicable_ops(s, applicable_op_ids);
 
     OperatorsProxy operators = task_proxy.get_operators();
+    successor_ids.clear();
     for (OperatorID op_id : applicable_op_ids) {
         // Add successor states to registry.
         State succ_state = state_registry.get_successor_state(s, operators[op_id]);
         statistics.inc_generated();
-        cout << "T " << s.get_id().value << " " << succ_state.get_id().value << endl;
+        successor_ids.push_back(succ_state.get_id().value);
     }
+    dump_state(s);
     return IN_PROGRESS;
 }
 
@@ -110,6 +173,23 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "Exhaustive search",
         "Dump the reachable state space.");
+    parser.add_enum_option<DumpFormat>(
+        "format",
+        {"text", "binary"},
+        "output format",
+        "text",
+        {"one line per fact, state and transition on stdout",
+         "compact binary file written by a separate I/O thread (see "
+         "search_engines/state_space_dump.h for the format and a reader)"});
+    parser.add_option<string>(
+        "filename",
+        "file for the binary format",
+        "state_space.bin");
+    parser.add_option<bool>(
+        "compress",
+        "compress the blocks of the binary format",
+        "true");
+    utils::add_segment_memory_options_to_parser(parser);
     utils::add_log_options_to_parser(parser);
 
     Options opts = parser.parse();
@@ -117,6 +197,7 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     opts.set<OperatorCost>("cost_type", ONE);
     opts.set<int>("bound", numeric_limits<int>::max());
     opts.set<double>("max_time", numeric_limits<double>::infinity());
+    opts.set<bool>("compact_search_nodes", false);
 
     if (parser.dry_run()) {
         return nullptr;
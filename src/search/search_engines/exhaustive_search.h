@@ -3,16 +3,40 @@
 
 #include "../search_engine.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace options {
 class Options;
 }
 
+namespace state_space_dump {
+class StateSpaceWriter;
+}
+
 namespace exhaustive_search {
+enum class DumpFormat {
+    TEXT,
+    BINARY
+};
+
 class ExhaustiveSearch : public SearchEngine {
+    const DumpFormat format;
+    const std::string filename;
+    const bool compress;
     int current_state_id;
     std::vector<std::vector<int>> fact_mapping;
+    std::unique_ptr<state_space_dump::StateSpaceWriter> writer;
+
+    // Buffers for dumping a state.
+    std::vector<int> fact_ids;
+    std::vector<int> successor_ids;
+    std::string text;
 
-    void dump_state(const State &state) const;
+    void construct_and_dump_fact_mapping();
+    void dump_state(const State &state);
+    void finish_dump();
 
 protected:
     virtual void initialize() override;
@@ -20,6 +44,7 @@ protected:
 
 public:
     explicit ExhaustiveSearch(const options::Options &opts);
+    virtual ~ExhaustiveSearch() override;
 
     virtual void print_statistics() const override;
 };
@@ -0,0 +1,538 @@
+#include "external_breadth_first_search.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <numeric>
+
+using namespace std;
+using utils::ExitCode;
+
+namespace external_breadth_first_search {
+static const size_t STATES_PER_CHUNK = 1 << 16;
+// Maximum number of run files that are merged at the same time.
+static const size_t MAX_MERGE_FAN_IN = 16;
+// Merge runs while expanding a layer once there are this many of them.
+static const size_t MAX_NUM_RUNS = MAX_MERGE_FAN_IN * MAX_MERGE_FAN_IN;
+
+static bool less_state(const PackedStateBin *lhs, const PackedStateBin *rhs,
+                       int num_bins) {
+    return lexicographical_compare(lhs, lhs + num_bins, rhs, rhs + num_bins);
+}
+
+static bool equal_state(const PackedStateBin *lhs, const PackedStateBin *rhs,
+                        int num_bins) {
+    return equal(lhs, lhs + num_bins, rhs);
+}
+
+StateFileWriter::StateFileWriter(
+    const string &filename, int num_bins, IOStatistics &statistics, bool append)
+    : file(filename, append ? ios::binary | ios::app : ios::binary),
+      num_bins(num_bins),
+      statistics(statistics),
+      num_states(0) {
+    if (!file) {
+        cerr << "Could not open " << filename << " for writing." << endl;
+        utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    buffer.reserve(STATES_PER_CHUNK * num_bins);
+}
+
+StateFileWriter::~StateFileWriter() {
+    if (file.is_open()) {
+        close();
+    }
+}
+
+void StateFileWriter::flush() {
+    statistics.timer.resume();
+    size_t num_bytes = buffer.size() * sizeof(PackedStateBin);
+    file.write(reinterpret_cast<const char *>(buffer.data()), num_bytes);
+    statistics.timer.stop();
+    if (!file) {
+        cerr << "Failed to write state file." << endl;
+        utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    statistics.bytes_written += num_bytes;
+    buffer.clear();
+}
+
+void StateFileWriter::write(const PackedStateBin *state) {
+    buffer.insert(buffer.end(), state, state + num_bins);
+    ++num_states;
+    if (buffer.size() >= STATES_PER_CHUNK * num_bins) {
+        flush();
+    }
+}
+
+void StateFileWriter::close() {
+    flush();
+    file.close();
+}
+
+StateFileReader::StateFileReader(
+    const string &filename, int num_bins, IOStatistics &statistics,
+    long long first_state, long long num_states)
+    : file(filename, ios::binary),
+      num_bins(num_bins),
+      buffer(STATES_PER_CHUNK * num_bins),
+      statistics(statistics),
+      position(0),
+      size(0),
+      num_unread_states(num_states) {
+    if (!file) {
+        cerr << "Could not open " << filename << " for reading." << endl;
+        utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    if (first_state > 0) {
+        file.seekg(first_state * num_bins * sizeof(PackedStateBin));
+    }
+    fill_buffer();
+}
+
+void StateFileReader::fill_buffer() {
+    size_t num_states = STATES_PER_CHUNK;
+    if (num_unread_states != -1) {
+        num_states = min<long long>(num_states, num_unread_states);
+    }
+    statistics.timer.resume();
+    file.read(reinterpret_cast<char *>(buffer.data()),
+              num_states * num_bins * sizeof(PackedStateBin));
+    statistics.timer.stop();
+    size_t num_bytes = file.gcount();
+    statistics.bytes_read += num_bytes;
+    assert(num_bytes % (num_bins * sizeof(PackedStateBin)) == 0);
+    size = num_bytes / sizeof(PackedStateBin);
+    position = 0;
+    if (num_unread_states != -1) {
+        num_unread_states -= size / num_bins;
+    }
+}
+
+void StateFileReader::advance() {
+    assert(has_state());
+    position += num_bins;
+    if (position == size && file && num_unread_states != 0) {
+        fill_buffer();
+    }
+}
+
+
+/*
+  Merge sorted state files and return each distinct state once, in
+  increasing order.
+*/
+class SortedStateMerger {
+    const int num_bins;
+    vector<unique_ptr<StateFileReader>> readers;
+    vector<int> queue;
+    vector<PackedStateBin> current;
+    vector<PackedStateBin> last;
+    bool has_last;
+
+    bool greater_reader(int lhs, int rhs) const {
+        return less_state(readers[rhs]->get_state(), readers[lhs]->get_state(),
+                          num_bins);
+    }
+public:
+    SortedStateMerger(const vector<string> &filenames, int num_bins,
+                      IOStatistics &statistics)
+        : num_bins(num_bins),
+          current(num_bins),
+          last(num_bins),
+          has_last(false) {
+        assert(filenames.size() <= MAX_MERGE_FAN_IN);
+        for (const string &filename : filenames) {
+            readers.push_back(utils::make_unique_ptr<StateFileReader>(
+                                  filename, num_bins, statistics));
+            if (readers.back()->has_state()) {
+                queue.push_back(readers.size() - 1);
+            }
+        }
+        make_heap(queue.begin(), queue.end(), [this](int lhs, int rhs) {
+                      return greater_reader(lhs, rhs);
+                  });
+    }
+
+    // Return the next distinct state or nullptr if there is none.
+    const PackedStateBin *next() {
+        auto compare = [this](int lhs, int rhs) {
+                return greater_reader(lhs, rhs);
+            };
+        while (!queue.empty()) {
+            pop_heap(queue.begin(), queue.end(), compare);
+            int reader_id = queue.back();
+            StateFileReader &reader = *readers[reader_id];
+            const PackedStateBin *state = reader.get_state();
+            current.assign(state, state + num_bins);
+            reader.advance();
+            if (reader.has_state()) {
+                push_heap(queue.begin(), queue.end(), compare);
+            } else {
+                queue.pop_back();
+            }
+            if (!has_last || !equal_state(last.data(), current.data(), num_bins)) {
+                last.swap(current);
+                has_last = true;
+                return last.data();
+            }
+        }
+        return nullptr;
+    }
+};
+
+
+ExternalBreadthFirstSearch::ExternalBreadthFirstSearch(const Options &opts)
+    : SearchEngine(opts),
+      directory(opts.get<string>("directory")),
+      /*
+        Each buffered state needs its packed representation plus one entry
+        in the index array that we sort in write_run().
+      */
+      max_buffered_states(max(
+          static_cast<size_t>(opts.get<int>("max_buffer_memory")) * 1024 * 1024 /
+          (task_properties::g_state_packers[task_proxy].get_num_bins() *
+           sizeof(PackedStateBin) + sizeof(size_t)),
+          static_cast<size_t>(1))),
+      state_packer(task_properties::g_state_packers[task_proxy]),
+      num_bins(state_packer.get_num_bins()),
+      file_prefix(directory + "/brfs-" + to_string(utils::get_process_id()) + "-"),
+      layers_file(file_prefix + "layers"),
+      num_created_files(0) {
+    assert(cost_type == ONE);
+}
+
+ExternalBreadthFirstSearch::~ExternalBreadthFirstSearch() {
+    remove_files();
+}
+
+string ExternalBreadthFirstSearch::create_temporary_file(const string &name) {
+    string filename = file_prefix + name + "-" + to_string(num_created_files++);
+    utils::register_temporary_file(filename);
+    return filename;
+}
+
+void ExternalBreadthFirstSearch::remove_temporary_file(const string &filename) {
+    remove(filename.c_str());
+    utils::unregister_temporary_file(filename);
+}
+
+void ExternalBreadthFirstSearch::remove_files() {
+    if (!layer_offsets.empty()) {
+        remove_temporary_file(layers_file);
+        layer_offsets.clear();
+    }
+    if (!visited_file.empty()) {
+        remove_temporary_file(visited_file);
+        visited_file.clear();
+    }
+    for (const string &filename : run_files) {
+        remove_temporary_file(filename);
+    }
+    run_files.clear();
+}
+
+State ExternalBreadthFirstSearch::unpack(const PackedStateBin *buffer) const {
+    int num_variables = task_proxy.get_variables().size();
+    vector<int> values(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        values[var] = state_packer.get(buffer, var);
+    }
+    return State(*task, move(values));
+}
+
+void ExternalBreadthFirstSearch::pack(
+    const State &state, PackedStateBin *buffer) const {
+    fill(buffer, buffer + num_bins, 0);
+    int num_variables = state.size();
+    for (int var = 0; var < num_variables; ++var) {
+        state_packer.set(buffer, var, state[var].get_value());
+    }
+}
+
+bool ExternalBreadthFirstSearch::is_goal(const PackedStateBin *buffer) const {
+    for (FactProxy goal : task_proxy.get_goals()) {
+        FactPair fact = goal.get_pair();
+        if (state_packer.get(buffer, fact.var) != fact.value)
+            return false;
+    }
+    return true;
+}
+
+void ExternalBreadthFirstSearch::generate_successors(
+    const PackedStateBin *buffer, vector<OperatorID> &ops,
+    vector<PackedStateBin> &successor_buffers) const {
+    ops.clear();
+    successor_generator.generate_applicable_ops(buffer, ops);
+    State state = unpack(buffer);
+    OperatorsProxy operators = task_proxy.get_operators();
+    for (OperatorID op_id : ops) {
+        State succ_state = state.get_unregistered_successor(operators[op_id]);
+        size_t offset = successor_buffers.size();
+        successor_buffers.resize(offset + num_bins);
+        pack(succ_state, &successor_buffers[offset]);
+    }
+}
+
+void ExternalBreadthFirstSearch::initialize() {
+    log << "Conducting external-memory breadth-first search in "
+        << directory << endl;
+    log << "Successors buffered in memory: " << max_buffered_states << endl;
+    // Allocate the buffers once, so that they never grow beyond the limit.
+    successors.reserve(max_buffered_states * num_bins);
+    order.reserve(max_buffered_states);
+    vector<PackedStateBin> buffer(num_bins);
+    pack(task_proxy.get_initial_state(), buffer.data());
+    utils::register_temporary_file(layers_file);
+    visited_file = create_temporary_file("visited");
+    for (const string &filename : {layers_file, visited_file}) {
+        StateFileWriter writer(filename, num_bins, io_statistics);
+        writer.write(buffer.data());
+    }
+    layer_offsets.push_back(0);
+    layer_sizes.push_back(1);
+    statistics.inc_generated();
+}
+
+void ExternalBreadthFirstSearch::write_run() {
+    size_t num_states = successors.size() / num_bins;
+    order.resize(num_states);
+    iota(order.begin(), order.end(), 0);
+    const PackedStateBin *data = successors.data();
+    sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+             return less_state(data + lhs * num_bins, data + rhs * num_bins, num_bins);
+         });
+    run_files.push_back(create_temporary_file("run"));
+    StateFileWriter writer(run_files.back(), num_bins, io_statistics);
+    const PackedStateBin *last = nullptr;
+    for (size_t index : order) {
+        const PackedStateBin *state = data + index * num_bins;
+        if (!last || !equal_state(last, state, num_bins)) {
+            writer.write(state);
+            last = state;
+        }
+    }
+    writer.close();
+    successors.clear();
+    order.clear();
+    if (run_files.size() >= MAX_NUM_RUNS) {
+        reduce_runs(MAX_MERGE_FAN_IN);
+    }
+}
+
+void ExternalBreadthFirstSearch::merge_runs(
+    const vector<string> &input_files, const string &output_file) {
+    {
+        SortedStateMerger merger(input_files, num_bins, io_statistics);
+        StateFileWriter writer(output_file, num_bins, io_statistics);
+        while (const PackedStateBin *state = merger.next()) {
+            writer.write(state);
+        }
+    }
+    for (const string &filename : input_files) {
+        remove_temporary_file(filename);
+    }
+}
+
+void ExternalBreadthFirstSearch::reduce_runs(size_t max_num_runs) {
+    while (run_files.size() > max_num_runs) {
+        vector<string> merged_files;
+        for (size_t begin = 0; begin < run_files.size(); begin += MAX_MERGE_FAN_IN) {
+            size_t end = min(begin + MAX_MERGE_FAN_IN, run_files.size());
+            vector<string> group(run_files.begin() + begin, run_files.begin() + end);
+            if (group.size() == 1) {
+                merged_files.push_back(group[0]);
+            } else {
+                merged_files.push_back(create_temporary_file("run"));
+                merge_runs(group, merged_files.back());
+            }
+        }
+        run_files.swap(merged_files);
+    }
+}
+
+long long ExternalBreadthFirstSearch::merge_into_next_layer() {
+    reduce_runs(MAX_MERGE_FAN_IN);
+
+    /*
+      Merge the remaining runs with the visited states. New states go to
+      the next layer and, like all visited states, to the new visited file.
+    */
+    string new_visited_file = create_temporary_file("visited");
+    long long num_new_states;
+    {
+        SortedStateMerger successor_merger(run_files, num_bins, io_statistics);
+        StateFileReader visited(visited_file, num_bins, io_statistics);
+        StateFileWriter visited_writer(new_visited_file, num_bins, io_statistics);
+        StateFileWriter layer_writer(layers_file, num_bins, io_statistics, true);
+        while (const PackedStateBin *state = successor_merger.next()) {
+            while (visited.has_state() &&
+                   less_state(visited.get_state(), state, num_bins)) {
+                visited_writer.write(visited.get_state());
+                visited.advance();
+            }
+            if (visited.has_state() &&
+                equal_state(visited.get_state(), state, num_bins)) {
+                continue;
+            }
+            layer_writer.write(state);
+            visited_writer.write(state);
+        }
+        for (; visited.has_state(); visited.advance()) {
+            visited_writer.write(visited.get_state());
+        }
+        layer_writer.close();
+        num_new_states = layer_writer.get_num_states();
+    }
+    for (const string &filename : run_files) {
+        remove_temporary_file(filename);
+    }
+    run_files.clear();
+    remove_temporary_file(visited_file);
+    visited_file = new_visited_file;
+    return num_new_states;
+}
+
+vector<OperatorID> ExternalBreadthFirstSearch::extract_plan(
+    const PackedStateBin *goal_state, int goal_layer) {
+    vector<OperatorID> plan;
+    vector<PackedStateBin> target(goal_state, goal_state + num_bins);
+    vector<OperatorID> ops;
+    vector<PackedStateBin> successor_buffers;
+    for (int layer = goal_layer - 1; layer >= 0; --layer) {
+        StateFileReader reader(layers_file, num_bins, io_statistics,
+                               layer_offsets[layer], layer_sizes[layer]);
+        bool found = false;
+        for (; reader.has_state() && !found; reader.advance()) {
+            successor_buffers.clear();
+            generate_successors(reader.get_state(), ops, successor_buffers);
+            for (size_t i = 0; i < ops.size(); ++i) {
+                if (equal_state(&successor_buffers[i * num_bins], target.data(),
+                                num_bins)) {
+                    plan.push_back(ops[i]);
+                    target.assign(reader.get_state(), reader.get_state() + num_bins);
+                    found = true;
+                    break;
+                }
+            }
+        }
+        assert(found);
+    }
+    reverse(plan.begin(), plan.end());
+    return plan;
+}
+
+SearchStatus ExternalBreadthFirstSearch::step() {
+    int layer = layer_sizes.size() - 1;
+    if (layer_sizes[layer] == 0) {
+        log << "Completely explored state space -- no solution!" << endl;
+        remove_files();
+        return UNSOLVABLE;
+    }
+
+    {
+        vector<OperatorID> ops;
+        OperatorsProxy operators = task_proxy.get_operators();
+        StateFileReader reader(layers_file, num_bins, io_statistics,
+                               layer_offsets[layer], layer_sizes[layer]);
+        for (; reader.has_state(); reader.advance()) {
+            const PackedStateBin *state = reader.get_state();
+            if (is_goal(state)) {
+                log << "Solution found!" << endl;
+                Plan plan = extract_plan(state, layer);
+                set_plan(plan);
+                remove_files();
+                return SOLVED;
+            }
+            statistics.inc_expanded();
+            ops.clear();
+            successor_generator.generate_applicable_ops(state, ops);
+            statistics.inc_generated(ops.size());
+            State parent = unpack(state);
+            for (OperatorID op_id : ops) {
+                if (successors.size() == max_buffered_states * num_bins) {
+                    write_run();
+                }
+                State succ_state = parent.get_unregistered_successor(operators[op_id]);
+                size_t offset = successors.size();
+                successors.resize(offset + num_bins);
+                pack(succ_state, &successors[offset]);
+            }
+        }
+    }
+    if (!successors.empty() || run_files.empty()) {
+        write_run();
+    }
+
+    long long num_states = merge_into_next_layer();
+    layer_offsets.push_back(layer_offsets[layer] + layer_sizes[layer]);
+    layer_sizes.push_back(num_states);
+    if (log.is_at_least_normal()) {
+        log << "Layer " << layer + 1 << ": " << num_states << " states, "
+            << io_statistics.bytes_written / (1024 * 1024) << " MB written, "
+            << io_statistics.bytes_read / (1024 * 1024) << " MB read" << endl;
+    }
+    return IN_PROGRESS;
+}
+
+void ExternalBreadthFirstSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    if (log.is_at_least_normal()) {
+        long long num_states = accumulate(layer_sizes.begin(), layer_sizes.end(), 0LL);
+        log << "Stored states: " << num_states << endl;
+        double io_time = io_statistics.timer();
+        double megabytes = (io_statistics.bytes_read + io_statistics.bytes_written) /
+            (1024.0 * 1024.0);
+        log << "Bytes written: " << io_statistics.bytes_written << endl;
+        log << "Bytes read: " << io_statistics.bytes_read << endl;
+        log << "I/O time: " << io_time << "s" << endl;
+        log << "I/O throughput: " << (io_time > 0 ? megabytes / io_time : 0)
+            << " MB/s" << endl;
+    }
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "External-memory breadth-first search",
+        "Breadth-first graph search that stores the layers on disk and "
+        "removes duplicates with delayed duplicate detection. It finds a "
+        "shortest plan or proves the task unsolvable.");
+    parser.add_option<string>(
+        "directory",
+        "directory for the temporary layer and run files",
+        ".");
+    parser.add_option<int>(
+        "max_buffer_memory",
+        "maximum memory in MiB for buffering successor states (and the "
+        "index array used for sorting them) before writing them to disk",
+        "1024",
+        Bounds("1", "infinity"));
+    utils::add_log_options_to_parser(parser);
+
+    Options opts = parser.parse();
+
+    opts.set<OperatorCost>("cost_type", ONE);
+    opts.set<int>("bound", numeric_limits<int>::max());
+    opts.set<double>("max_time", numeric_limits<double>::infinity());
+    opts.set<bool>("compact_search_nodes", false);
+    // States are kept on disk, so we don't need mapped segments.
+    opts.set<bool>("mapped_segments", false);
+
+    if (parser.dry_run()) {
+        return nullptr;
+    }
+
+    return make_shared<ExternalBreadthFirstSearch>(opts);
+}
+
+static Plugin<SearchEngine> _plugin("external_brfs", _parse);
+}
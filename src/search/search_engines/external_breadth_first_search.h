@@ -0,0 +1,154 @@
+#ifndef SEARCH_ENGINES_EXTERNAL_BREADTH_FIRST_SEARCH_H
+#define SEARCH_ENGINES_EXTERNAL_BREADTH_FIRST_SEARCH_H
+
+#include "../search_engine.h"
+
+#include "../utils/timer.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace options {
+class Options;
+}
+
+namespace external_breadth_first_search {
+/*
+  Statistics about the volume and duration of file operations, shared by
+  all files of a search.
+*/
+struct IOStatistics {
+    long long bytes_read = 0;
+    long long bytes_written = 0;
+    utils::Timer timer = utils::Timer(false);
+};
+
+// Write packed states to a file in chunks.
+class StateFileWriter {
+    std::ofstream file;
+    const int num_bins;
+    std::vector<PackedStateBin> buffer;
+    IOStatistics &statistics;
+    long long num_states;
+
+    void flush();
+public:
+    // With append=true, the states are appended to an existing file.
+    StateFileWriter(const std::string &filename, int num_bins,
+                    IOStatistics &statistics, bool append = false);
+    ~StateFileWriter();
+
+    void write(const PackedStateBin *state);
+    void close();
+
+    long long get_num_states() const {
+        return num_states;
+    }
+};
+
+// Read packed states from a file in chunks.
+class StateFileReader {
+    std::ifstream file;
+    const int num_bins;
+    std::vector<PackedStateBin> buffer;
+    IOStatistics &statistics;
+    std::size_t position;
+    std::size_t size;
+    long long num_unread_states;
+
+    void fill_buffer();
+public:
+    /*
+      Read num_states states starting with the state at index first_state,
+      or all states if num_states is -1.
+    */
+    StateFileReader(const std::string &filename, int num_bins,
+                    IOStatistics &statistics, long long first_state = 0,
+                    long long num_states = -1);
+
+    bool has_state() const {
+        return position < size;
+    }
+
+    // Only valid if has_state() holds.
+    const PackedStateBin *get_state() const {
+        return &buffer[position];
+    }
+
+    void advance();
+};
+
+/*
+  Breadth-first search with delayed duplicate detection (Korf 2003), which
+  keeps the layers of the search on disk.
+
+  All layers are stored one after the other in a single file. Each layer
+  consists of packed states sorted lexicographically. When expanding a
+  layer, we collect the successors in memory. Whenever the successors
+  exceed the memory limit, we sort them, remove duplicates and write them
+  to a run file. We merge the runs with a fan-in of at most
+  MAX_MERGE_FAN_IN files per pass, both when too many runs accumulate
+  while expanding a layer and after the layer is expanded. Planning tasks have directed state
+  spaces, so duplicates can be in any earlier layer. Therefore, we also
+  keep a sorted file of all visited states. The last merge pass removes
+  the visited states from the successors, which yields the next layer,
+  and writes the new visited file at the same time.
+
+  Memory usage only depends on the memory limit and the fan-in, not on the
+  size of the state space or the number of layers. The disk usage is
+  about twice the size of the state space. When a goal state is found, we
+  reconstruct the plan by scanning the layers backwards for predecessors,
+  so we don't need to store parent pointers.
+*/
+class ExternalBreadthFirstSearch : public SearchEngine {
+    const std::string directory;
+    const std::size_t max_buffered_states;
+    const int_packer::IntPacker &state_packer;
+    const int num_bins;
+    const std::string file_prefix;
+
+    const std::string layers_file;
+    std::string visited_file;
+    // Index of the first state of each layer in the layers file.
+    std::vector<long long> layer_offsets;
+    std::vector<long long> layer_sizes;
+    std::vector<std::string> run_files;
+    int num_created_files;
+    std::vector<PackedStateBin> successors;
+    // Indices into successors, sorted by write_run().
+    std::vector<std::size_t> order;
+    IOStatistics io_statistics;
+
+    State unpack(const PackedStateBin *buffer) const;
+    void pack(const State &state, PackedStateBin *buffer) const;
+    bool is_goal(const PackedStateBin *buffer) const;
+    void generate_successors(
+        const PackedStateBin *buffer, std::vector<OperatorID> &ops,
+        std::vector<PackedStateBin> &successor_buffers) const;
+    std::string create_temporary_file(const std::string &name);
+    void remove_temporary_file(const std::string &filename);
+    void write_run();
+    // Merge groups of runs until at most max_num_runs runs are left.
+    void reduce_runs(std::size_t max_num_runs);
+    void merge_runs(const std::vector<std::string> &input_files,
+                    const std::string &output_file);
+    long long merge_into_next_layer();
+    std::vector<OperatorID> extract_plan(
+        const PackedStateBin *goal_state, int goal_layer);
+    void remove_files();
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit ExternalBreadthFirstSearch(const options::Options &opts);
+    virtual ~ExternalBreadthFirstSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -8,64 +8,116 @@
 #include "../task_utils/successor_generator.h"
 #include "../task_utils/task_properties.h"
 
+#include "../utils/hash.h"
 #include "../utils/logging.h"
 #include "../utils/memory.h"
 #include "../utils/timer.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
+#include <limits>
 
 using namespace std;
 
 namespace idastar_search {
 static const int INF = numeric_limits<int>::max();
-static const int MEMORY_PADDING_MB = 512;
 
-FifoCache::FifoCache(int max_size)
-    : max_size(max_size) {
-    if (max_size == INF) {
-        utils::reserve_extra_memory_padding(MEMORY_PADDING_MB);
-    }
+TranspositionTable::TranspositionTable(int num_bins, int memory_in_mb)
+    : num_bins(num_bins),
+      num_used_entries(0) {
+    size_t bytes_per_bucket =
+        SLOTS_PER_BUCKET * (sizeof(Entry) + num_bins * sizeof(PackedStateBin));
+    num_buckets = max(
+        static_cast<size_t>(1),
+        static_cast<size_t>(memory_in_mb) * 1024 * 1024 / bytes_per_bucket);
+    entries.resize(num_buckets * SLOTS_PER_BUCKET);
+    keys.resize(entries.size() * num_bins);
 }
 
-void FifoCache::add(const State &state, int g, int iteration) {
-    assert(state_to_g_and_iteration.size() == states.size());
-    if (max_size == 0) {
-        return;
-    }
-    if (max_size == INF && !utils::extra_memory_padding_is_reserved()) {
-        max_size = states.size();
-    }
-    if (!state_to_g_and_iteration.count(state)) {
-        states.push(state);
+int TranspositionTable::get_memory_in_mb_for_entries(int num_bins, int num_entries) {
+    uint64_t bytes_per_bucket =
+        SLOTS_PER_BUCKET * (sizeof(Entry) + num_bins * sizeof(PackedStateBin));
+    uint64_t num_buckets =
+        (static_cast<uint64_t>(num_entries) + SLOTS_PER_BUCKET - 1) / SLOTS_PER_BUCKET;
+    const uint64_t bytes_per_mb = 1024 * 1024;
+    return static_cast<int>(min<uint64_t>(
+        (num_buckets * bytes_per_bucket + bytes_per_mb - 1) / bytes_per_mb,
+        numeric_limits<int>::max()));
+}
+
+size_t TranspositionTable::get_bucket(const PackedStateBin *buffer) const {
+    utils::HashState hash_state;
+    for (int i = 0; i < num_bins; ++i) {
+        hash_state.feed(buffer[i]);
     }
-    state_to_g_and_iteration[state] = make_pair(g, iteration);
-    assert(state_to_g_and_iteration.size() == states.size());
-    if (static_cast<int>(state_to_g_and_iteration.size()) > max_size) {
-        State &oldest_state = states.front();
-        state_to_g_and_iteration.erase(oldest_state);
-        states.pop();
+    return hash_state.get_hash64() % num_buckets;
+}
+
+bool TranspositionTable::has_key(size_t index, const PackedStateBin *buffer) const {
+    return entries[index].iteration != 0 &&
+           equal(buffer, buffer + num_bins, &keys[index * num_bins]);
+}
+
+void TranspositionTable::set_entry(
+    size_t index, const PackedStateBin *buffer, int g, int iteration) {
+    if (entries[index].iteration == 0) {
+        ++num_used_entries;
     }
+    entries[index].g = g;
+    entries[index].iteration = iteration;
+    copy(buffer, buffer + num_bins, &keys[index * num_bins]);
+}
+
+void TranspositionTable::move_entry(size_t from, size_t to) {
+    const PackedStateBin *buffer = &keys[from * num_bins];
+    set_entry(to, buffer, entries[from].g, entries[from].iteration);
 }
 
-CacheValue FifoCache::lookup(const State &state) const {
-    auto iter = state_to_g_and_iteration.find(state);
-    if (iter == state_to_g_and_iteration.end()) {
-        return make_pair(INF, -1);
+void TranspositionTable::add(const PackedStateBin *buffer, int g, int iteration) {
+    size_t first = get_bucket(buffer) * SLOTS_PER_BUCKET;
+    size_t second = first + 1;
+    if (has_key(first, buffer)) {
+        set_entry(first, buffer, g, iteration);
+    } else if (entries[first].iteration == 0 || g <= entries[first].g) {
+        /*
+          The new entry takes over the depth-preferred slot. The previous
+          entry replaces the entry in the second slot, unless it belongs
+          to the new state.
+        */
+        if (entries[first].iteration != 0) {
+            move_entry(first, second);
+        } else if (has_key(second, buffer)) {
+            entries[second].iteration = 0;
+            --num_used_entries;
+        }
+        set_entry(first, buffer, g, iteration);
     } else {
-        return iter->second;
+        set_entry(second, buffer, g, iteration);
     }
 }
 
-void FifoCache::clear() {
-    state_to_g_and_iteration.clear();
-    queue<State>().swap(states);
+CacheValue TranspositionTable::lookup(const PackedStateBin *buffer) const {
+    size_t first = get_bucket(buffer) * SLOTS_PER_BUCKET;
+    for (size_t index = first; index < first + SLOTS_PER_BUCKET; ++index) {
+        if (has_key(index, buffer)) {
+            return make_pair(entries[index].g, entries[index].iteration);
+        }
+    }
+    return make_pair(INF, -1);
+}
+
+void TranspositionTable::print_statistics() const {
+    cout << "IDA* cache entries: " << num_used_entries << "/" << entries.size()
+         << endl;
 }
 
 IDAstarSearch::IDAstarSearch(const Options &opts)
     : SearchEngine(opts),
       h_evaluator(opts.get<shared_ptr<Evaluator>>("eval")),
       single_plan(opts.get<bool>("single_plan")),
+      state_packer(task_properties::g_state_packers[task_proxy]),
       iteration(0),
       f_limit(opts.get<int>("initial_f_limit")),
       cheapest_plan_cost(numeric_limits<int>::max()),
@@ -76,9 +128,36 @@ IDAstarSearch::IDAstarSearch(const Options &opts)
         cerr << "Error: set cache_estimates=false for IDA* heuristics." << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
     }
+    int max_cache_memory = opts.get<int>("max_cache_memory");
     int cache_size = opts.get<int>("cache_size");
-    if (cache_size > 0) {
-        cache = utils::make_unique_ptr<FifoCache>(cache_size);
+    if (cache_size == INF) {
+        cerr << "Error: cache_size=infinity is not supported anymore, "
+             << "use max_cache_memory instead." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    } else if (cache_size >= 0) {
+        max_cache_memory = (cache_size == 0) ? 0 :
+            TranspositionTable::get_memory_in_mb_for_entries(
+                state_packer.get_num_bins(), cache_size);
+        if (log.is_warning()) {
+            log << "Warning: cache_size is deprecated, use "
+                << "max_cache_memory=" << max_cache_memory << " instead." << endl;
+        }
+    }
+    if (max_cache_memory > 0) {
+        cache = utils::make_unique_ptr<TranspositionTable>(
+            state_packer.get_num_bins(), max_cache_memory);
+    }
+    if (!task_properties::has_axioms(task_proxy) &&
+        !task_properties::has_conditional_effects(task_proxy)) {
+        incremental_successor_generator = utils::make_unique_ptr<
+            incremental_successor_generator::IncrementalSuccessorGenerator>(task_proxy);
+        for (OperatorProxy op : task_proxy.get_operators()) {
+            vector<FactPair> effects;
+            for (EffectProxy effect : op.get_effects()) {
+                effects.push_back(effect.get_fact().get_pair());
+            }
+            effects_by_operator.push_back(move(effects));
+        }
     }
 }
 
@@ -90,6 +169,9 @@ void IDAstarSearch::print_statistics() const {
     cout << "Expansions: " << num_expansions << endl;
     cout << "Evaluations: " << num_evaluations << endl;
     cout << "IDA* cache hits: " << num_cache_hits << endl;
+    if (cache) {
+        cache->print_statistics();
+    }
     cout << "IDA* iterations: " << iteration << endl;
 }
 
@@ -98,12 +180,61 @@ int IDAstarSearch::compute_h_value(const State &state) const {
     return eval_context.get_evaluator_value_or_infinity(h_evaluator.get());
 }
 
-int IDAstarSearch::recursive_search(const IDAstarNode &node) {
-    int f = node.g + node.h;
+void IDAstarSearch::set_value(int var, int value) {
+    undo_stack.emplace_back(var, current_values[var]);
+    current_values[var] = value;
+    state_packer.set(current_buffer.data(), var, value);
+}
+
+void IDAstarSearch::apply_operator(const State &state, OperatorProxy op) {
+    if (incremental_successor_generator) {
+        for (const FactPair &effect : effects_by_operator[op.get_id()]) {
+            if (current_values[effect.var] != effect.value) {
+                set_value(effect.var, effect.value);
+            }
+        }
+    } else {
+        // Let the task evaluate conditional effects and axioms.
+        State succ_state = state.get_unregistered_successor(op);
+        const vector<int> &succ_values = succ_state.get_unpacked_values();
+        for (size_t var = 0; var < succ_values.size(); ++var) {
+            if (current_values[var] != succ_values[var]) {
+                set_value(var, succ_values[var]);
+            }
+        }
+    }
+}
+
+void IDAstarSearch::undo_changes(size_t num_remaining_changes) {
+    while (undo_stack.size() > num_remaining_changes) {
+        const FactPair &change = undo_stack.back();
+        current_values[change.var] = change.value;
+        state_packer.set(current_buffer.data(), change.var, change.value);
+        undo_stack.pop_back();
+    }
+}
+
+void IDAstarSearch::get_applicable_operators(
+    const State &state, vector<OperatorID> &applicable_ops) const {
+    if (incremental_successor_generator) {
+        // Copy the operators since the generator changes them while we recurse.
+        vector<int> op_ids = incremental_successor_generator->get_applicable_operators();
+        sort(op_ids.begin(), op_ids.end());
+        applicable_ops.reserve(op_ids.size());
+        for (int op_id : op_ids) {
+            applicable_ops.emplace_back(op_id);
+        }
+    } else {
+        successor_generator.generate_applicable_ops(state, applicable_ops);
+    }
+}
+
+int IDAstarSearch::recursive_search(const State &state, int g, int h) {
+    int f = g + h;
     if (f > f_limit) {
         return f;
     }
-    if (task_properties::is_goal_state(task_proxy, node.state)) {
+    if (task_properties::is_goal_state(task_proxy, state)) {
         int plan_cost = calculate_plan_cost(operator_sequence, task_proxy);
         cout << "Found solution with cost " << plan_cost << endl;
         if (plan_cost < cheapest_plan_cost) {
@@ -118,35 +249,44 @@ int IDAstarSearch::recursive_search(const IDAstarNode &node) {
     ++num_expansions;
     int next_limit = INF;
     vector<OperatorID> applicable_ops;
-    successor_generator.generate_applicable_ops(node.state, applicable_ops);
+    get_applicable_operators(state, applicable_ops);
     OperatorsProxy operators = task_proxy.get_operators();
     for (OperatorID op_id : applicable_ops) {
         OperatorProxy op = operators[op_id];
-        State succ_state = node.state.get_unregistered_successor(op);
-        int succ_g = node.g + get_adjusted_cost(op);
+        int succ_g = g + get_adjusted_cost(op);
+        size_t num_changes = undo_stack.size();
+        apply_operator(state, op);
         if (cache) {
-            CacheValue pair = cache->lookup(succ_state);
+            CacheValue pair = cache->lookup(current_buffer.data());
             int old_succ_g = pair.first;
             int old_iteration = pair.second;
             if (succ_g > old_succ_g || (succ_g == old_succ_g && iteration == old_iteration)) {
                 ++num_cache_hits;
+                undo_changes(num_changes);
                 continue;
             } else {
-                cache->add(succ_state, succ_g, iteration);
+                cache->add(current_buffer.data(), succ_g, iteration);
             }
         }
+        State succ_state(*task, vector<int>(current_values));
         int succ_h = compute_h_value(succ_state);
         ++num_evaluations;
         if (succ_h != INF) {
             operator_sequence.push_back(op_id);
-            IDAstarNode succ_node(move(succ_state), succ_g, succ_h);
-            int rec_limit = recursive_search(succ_node);
+            if (incremental_successor_generator) {
+                incremental_successor_generator->push_transition(state, op.get_id());
+            }
+            int rec_limit = recursive_search(succ_state, succ_g, succ_h);
             if (found_solution() && single_plan) {
                 return -1;
             }
+            if (incremental_successor_generator) {
+                incremental_successor_generator->pop_transition(state, op.get_id());
+            }
             operator_sequence.pop_back();
             next_limit = min(next_limit, rec_limit);
         }
+        undo_changes(num_changes);
     }
     return next_limit;
 }
@@ -154,16 +294,21 @@ int IDAstarSearch::recursive_search(const IDAstarNode &node) {
 SearchStatus IDAstarSearch::step() {
     cout << "IDA* search start time: " << utils::g_timer() << endl;
     State initial_state = task_proxy.get_initial_state();
+    initial_state.unpack();
+    current_values = initial_state.get_unpacked_values();
+    current_buffer.assign(state_packer.get_num_bins(), 0);
+    for (size_t var = 0; var < current_values.size(); ++var) {
+        state_packer.set(current_buffer.data(), var, current_values[var]);
+    }
     int init_h = compute_h_value(initial_state);
     utils::g_log << "Initial h value: " << init_h << endl;
-    IDAstarNode node(initial_state, 0, init_h);
     while (f_limit != INF && f_limit != -1 && (!single_plan || !found_solution())) {
         utils::g_log << "f limit: " << f_limit << endl;
         ++iteration;
-        f_limit = recursive_search(node);
-    }
-    if (utils::extra_memory_padding_is_reserved()) {
-        utils::release_extra_memory_padding();
+        if (incremental_successor_generator) {
+            incremental_successor_generator->reset_to_state(initial_state);
+        }
+        f_limit = recursive_search(initial_state, 0, init_h);
     }
     if (found_solution()) {
         return SOLVED;
@@ -178,7 +323,9 @@ void IDAstarSearch::save_plan_if_necessary() {
 static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "IDA* search",
-        "IDA* search with an optional g-value cache.");
+        "IDA* search with an optional g-value cache. For tasks without axioms "
+        "and conditional effects, the applicable operators are computed "
+        "incrementally.");
     parser.add_option<shared_ptr<Evaluator>>(
         "eval",
         "evaluator for h-value. Make sure to use cache_estimates=false.");
@@ -188,12 +335,22 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
         "0",
         Bounds("0", "infinity"));
     parser.add_option<int>(
-        "cache_size",
-        "maximum number of states to cache. For cache_size=infinity the cache "
-        "fills up until approaching the memory limit, at which point the "
-        "current number of states becomes the maximum cache size.",
+        "max_cache_memory",
+        "maximum memory in MiB for the transposition table that stores the "
+        "lowest g value of each cached state (set to 0 to disable the "
+        "cache). Each hash bucket keeps the entry with the lowest g value "
+        "and the most recently added other entry.",
         "0",
         Bounds("0", "infinity"));
+    parser.add_option<int>(
+        "cache_size",
+        "deprecated, use max_cache_memory instead. If set, this overrides "
+        "max_cache_memory with the memory needed for the given number of "
+        "entries (0 disables the cache). Since entries are evicted on hash "
+        "collisions, the table may hold fewer states. cache_size=infinity "
+        "is not supported anymore.",
+        "-1",
+        Bounds("-1", "infinity"));
     parser.add_option<bool>(
         "single_plan",
         "stop after finding the first plan",
@@ -3,10 +3,9 @@
 
 #include "../search_engine.h"
 
-#include "../utils/hash.h"
+#include "../task_utils/incremental_successor_generator.h"
 
 #include <memory>
-#include <queue>
 #include <vector>
 
 class Evaluator;
@@ -16,50 +15,87 @@ class Options;
 }
 
 namespace idastar_search {
-struct IDAstarNode {
-    State state;
-    int g;
-    int h;
-
-    IDAstarNode(const State &state, int g, int h)
-        : state(state),
-          g(g),
-          h(h) {
-    }
-};
-
 using CacheValue = std::pair<int, int>;
-class FifoCache {
-    int max_size;
-    utils::HashMap<State, CacheValue> state_to_g_and_iteration;
-    std::queue<State> states;
+
+/*
+  Fixed-size hash table that maps packed states to the lowest g value
+  with which they were reached and the iteration in which this happened.
+
+  Each bucket has two slots. The first slot keeps the entry with the
+  lowest g value (i.e., the root of the largest subtree) and the second
+  slot holds the most recently inserted entry that did not make it into
+  the first slot. We store the full packed states, so there are no
+  false positives.
+*/
+class TranspositionTable {
+    static const int SLOTS_PER_BUCKET = 2;
+
+    struct Entry {
+        // Iteration 0 marks empty entries.
+        int g = 0;
+        int iteration = 0;
+    };
+
+    const int num_bins;
+    std::size_t num_buckets;
+    std::vector<Entry> entries;
+    std::vector<PackedStateBin> keys;
+    int num_used_entries;
+
+    std::size_t get_bucket(const PackedStateBin *buffer) const;
+    bool has_key(std::size_t index, const PackedStateBin *buffer) const;
+    void set_entry(std::size_t index, const PackedStateBin *buffer, int g,
+                   int iteration);
+    void move_entry(std::size_t from, std::size_t to);
 
 public:
-    explicit FifoCache(int max_size);
+    TranspositionTable(int num_bins, int memory_in_mb);
 
-    void add(const State &state, int g, int iteration);
-    CacheValue lookup(const State &state) const;
-    void clear();
+    void add(const PackedStateBin *buffer, int g, int iteration);
+    CacheValue lookup(const PackedStateBin *buffer) const;
+    void print_statistics() const;
+
+    // Return the memory limit that yields at least num_entries entries.
+    static int get_memory_in_mb_for_entries(int num_bins, int num_entries);
 };
 
 class IDAstarSearch : public SearchEngine {
     const std::shared_ptr<Evaluator> h_evaluator;
     const bool single_plan;
+    const int_packer::IntPacker &state_packer;
 
     int iteration;
     int f_limit;
     Plan operator_sequence;
     int cheapest_plan_cost;
 
-    // Store last seen states and their g values in FIFO queue.
-    std::unique_ptr<FifoCache> cache;
+    std::unique_ptr<TranspositionTable> cache;
     int num_cache_hits;
 
+    /*
+      We update the values and the packed buffer of the current state in
+      place and undo the changes when backtracking. For tasks without
+      axioms and conditional effects, we also compute the applicable
+      operators incrementally.
+    */
+    std::unique_ptr<incremental_successor_generator::IncrementalSuccessorGenerator>
+    incremental_successor_generator;
+    std::vector<std::vector<FactPair>> effects_by_operator;
+    std::vector<int> current_values;
+    std::vector<PackedStateBin> current_buffer;
+    // Variables and their previous values.
+    std::vector<FactPair> undo_stack;
+
     uint64_t num_expansions;
     uint64_t num_evaluations;
 
     int compute_h_value(const State &state) const;
-    int recursive_search(const IDAstarNode &node);
+    void set_value(int var, int value);
+    void apply_operator(const State &state, OperatorProxy op);
+    void undo_changes(std::size_t num_remaining_changes);
+    void get_applicable_operators(
+        const State &state, std::vector<OperatorID> &applicable_ops) const;
+    int recursive_search(const State &state, int g, int h);
 
 protected:
     virtual void initialize() override;
@@ -20,6 +20,7 @@ IteratedSearch::IteratedSearch(const Options &opts, options::Registry &registry,
       repeat_last_phase(opts.get<bool>("repeat_last")),
       continue_on_fail(opts.get<bool>("continue_on_fail")),
       continue_on_solve(opts.get<bool>("continue_on_solve")),
+      share_state_registry(opts.get<bool>("share_state_registry")),
       phase(0),
       last_phase_found_solution(false),
       best_bound(bound),
@@ -29,7 +30,13 @@ IteratedSearch::IteratedSearch(const Options &opts, options::Registry &registry,
 shared_ptr<SearchEngine> IteratedSearch::get_search_engine(
     int engine_configs_index) {
     OptionParser parser(engine_configs[engine_configs_index], registry, predefinitions, false);
-    shared_ptr<SearchEngine> engine(parser.start_parsing<shared_ptr<SearchEngine>>());
+    shared_ptr<SearchEngine> engine;
+    if (share_state_registry) {
+        SharedStateRegistryScope scope(shared_state_registry);
+        engine = parser.start_parsing<shared_ptr<SearchEngine>>();
+    } else {
+        engine = parser.start_parsing<shared_ptr<SearchEngine>>();
+    }
 
     ostringstream stream;
     kptree::print_tree_bracketed(engine_configs[engine_configs_index], stream);
@@ -122,6 +129,10 @@ SearchStatus IteratedSearch::step_return_value() {
 void IteratedSearch::print_statistics() const {
     log << "Cumulative statistics:" << endl;
     statistics.print_detailed_statistics();
+    if (share_state_registry) {
+        log << "Number of shared registered states: " << state_registry.size()
+            << endl;
+    }
 }
 
 void IteratedSearch::save_plan_if_necessary() {
@@ -133,9 +144,14 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.document_synopsis("Iterated search", "");
     parser.document_note(
         "Note 1",
-        "We don't cache heuristic values between search iterations at"
-        " the moment. If you perform a LAMA-style iterative search,"
-        " heuristic values will be computed multiple times.");
+        "By default, each phase uses its own state registry, so heuristic "
+        "values are not cached between search iterations and a LAMA-style "
+        "iterative search computes them multiple times. With "
+        "share_state_registry=true, all phases register their states in "
+        "the same registry and predefined heuristics (see Note 2) that "
+        "cache their estimates reuse the values computed in previous "
+        "phases. The states and their cached values are kept in memory "
+        "until the iterated search ends.");
     parser.document_note(
         "Note 2",
         "The configuration\n```\n"
@@ -172,6 +188,12 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.add_option<bool>("continue_on_solve",
                             "continue search after solution found",
                             "true");
+    parser.add_option<bool>(
+        "share_state_registry",
+        "let all phases share one state registry (see Note 1). Search "
+        "engines that explore the registry in the order of the state IDs "
+        "(brfs and dump_reachable_search_space) don't support this.",
+        "false");
     SearchEngine::add_options_to_parser(parser);
     Options opts = parser.parse();
 
@@ -35,6 +35,12 @@ LazySearch::LazySearch(const Options &opts)
       We initialize current_eval_context in such a way that the initial node
       counts as "preferred".
     */
+    if (opts.get<bool>("incremental_successors")) {
+        applicable_operators_cache =
+            applicable_operators_cache::create_applicable_operators_cache(
+                task_proxy, state_registry,
+                opts.get<int>("max_successor_cache_memory"), log);
+    }
 }
 
 void LazySearch::set_preferred_operator_evaluators(
@@ -65,8 +71,15 @@ void LazySearch::initialize() {
 vector<OperatorID> LazySearch::get_successor_operators(
     const ordered_set::OrderedSet<OperatorID> &preferred_operators) const {
     vector<OperatorID> applicable_operators;
-    successor_generator.generate_applicable_ops(
-        current_state, applicable_operators);
+    utils::ScopedProfileTimer profile_timer(successor_generation_profile);
+    if (applicable_operators_cache) {
+        applicable_operators_cache->generate_applicable_ops(
+            current_state, current_predecessor_id, current_operator_id,
+            applicable_operators);
+    } else {
+        successor_generator.generate_applicable_ops(
+            current_state, applicable_operators);
+    }
 
     if (randomize_successors) {
         rng->shuffle(applicable_operators);
@@ -110,6 +123,7 @@ void LazySearch::generate_successors() {
         if (new_real_g < bound) {
             EvaluationContext new_eval_context(
                 current_eval_context, new_g, is_preferred, nullptr);
+            utils::ScopedProfileTimer profile_timer(open_list_insert_profile);
             open_list->insert(new_eval_context, make_pair(current_state.get_id(), op_id));
         }
     }
@@ -121,7 +135,11 @@ SearchStatus LazySearch::fetch_next_state() {
         return FAILED;
     }
 
-    EdgeOpenListEntry next = open_list->remove_min();
+    EdgeOpenListEntry next = make_pair(StateID::no_state, OperatorID::no_operator);
+    {
+        utils::ScopedProfileTimer profile_timer(open_list_remove_min_profile);
+        next = open_list->remove_min();
+    }
 
     current_predecessor_id = next.first;
     current_operator_id = next.second;
@@ -215,5 +233,8 @@ void LazySearch::reward_progress() {
 void LazySearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
+    if (applicable_operators_cache) {
+        applicable_operators_cache->print_statistics(log);
+    }
 }
 }
@@ -9,6 +9,7 @@
 #include "../search_progress.h"
 #include "../search_space.h"
 
+#include "../task_utils/applicable_operators_cache.h"
 #include "../utils/rng.h"
 
 #include <memory>
@@ -28,6 +29,8 @@ protected:
     bool randomize_successors;
     bool preferred_successors_first;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
+    std::unique_ptr<applicable_operators_cache::ApplicableOperatorsCache>
+    applicable_operators_cache;
 
     std::vector<Evaluator *> path_dependent_evaluators;
     std::vector<std::shared_ptr<Evaluator>> preferred_operator_evaluators;
@@ -0,0 +1,348 @@
+#include "parallel_breadth_first_search.h"
+
+#include "../axioms.h"
+#include "../option_parser.h"
+#include "../pruning_method.h"
+
+#include "../pruning/null_pruning_method.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/parallel.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace breadth_first_search {
+// Number of states per thread that are expanded before deduplicating.
+static const int BATCH_SIZE_PER_THREAD = 1 << 14;
+static const int SHARDS_PER_THREAD = 8;
+
+static uint64_t hash_state(const PackedStateBin *buffer, int num_bins) {
+    utils::HashState hash_state;
+    for (int i = 0; i < num_bins; ++i) {
+        hash_state.feed(buffer[i]);
+    }
+    return hash_state.get_hash64();
+}
+
+uint64_t ParallelBreadthFirstSearch::StateHash::operator()(int index) const {
+    return hash_state(pool[index], num_bins);
+}
+
+ParallelBreadthFirstSearch::Shard::Shard(int num_bins)
+    : states(num_bins),
+      indices(0, StateHash(states, num_bins), StateEqual(states, num_bins)) {
+}
+
+ParallelBreadthFirstSearch::ParallelBreadthFirstSearch(const Options &opts)
+    : SearchEngine(opts),
+      single_plan(opts.get<bool>("single_plan")),
+      write_plan(opts.get<bool>("write_plan")),
+      num_threads(utils::parse_num_threads(opts)),
+      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")),
+      use_pruning(!dynamic_cast<null_pruning_method::NullPruningMethod *>(
+                      pruning_method.get())),
+      state_packer(task_properties::g_state_packers[task_proxy]),
+      num_bins(state_packer.get_num_bins()),
+      has_axioms(task_properties::has_axioms(task_proxy)),
+      last_plan_cost(-1) {
+    assert(cost_type == ONE);
+    for (FactProxy goal : task_proxy.get_goals()) {
+        goals.push_back(goal.get_pair());
+    }
+    OperatorsProxy operators = task_proxy.get_operators();
+    effects_by_operator.resize(operators.size());
+    for (OperatorProxy op : operators) {
+        for (EffectProxy effect : op.get_effects()) {
+            Effect eff;
+            FactPair fact = effect.get_fact().get_pair();
+            eff.var = fact.var;
+            eff.value = fact.value;
+            for (FactProxy condition : effect.get_conditions()) {
+                eff.conditions.push_back(condition.get_pair());
+            }
+            effects_by_operator[op.get_id()].push_back(move(eff));
+        }
+    }
+}
+
+ParallelBreadthFirstSearch::~ParallelBreadthFirstSearch() {
+}
+
+const PackedStateBin *ParallelBreadthFirstSearch::get_buffer(int id) const {
+    int num_shards = shards.size();
+    return shards[id % num_shards]->states[id / num_shards];
+}
+
+void ParallelBreadthFirstSearch::unpack(
+    const PackedStateBin *buffer, vector<int> &values) const {
+    int num_variables = values.size();
+    for (int var = 0; var < num_variables; ++var) {
+        values[var] = state_packer.get(buffer, var);
+    }
+}
+
+bool ParallelBreadthFirstSearch::is_goal(const PackedStateBin *buffer) const {
+    for (const FactPair &goal : goals) {
+        if (state_packer.get(buffer, goal.var) != goal.value)
+            return false;
+    }
+    return true;
+}
+
+int ParallelBreadthFirstSearch::insert_state(
+    int shard_id, const PackedStateBin *buffer, int parent_id, int op_id) {
+    Shard &shard = *shards[shard_id];
+    shard.states.push_back(buffer);
+    int index = shard.states.size() - 1;
+    if (!shard.indices.insert(index).second) {
+        shard.states.pop_back();
+        return -1;
+    }
+    if (write_plan) {
+        shard.parents.emplace_back(parent_id, op_id);
+    }
+    return index * shards.size() + shard_id;
+}
+
+void ParallelBreadthFirstSearch::initialize() {
+    log << "Conducting breadth-first search with " << num_threads
+        << " threads" << endl;
+    pruning_method->initialize(task);
+
+    int num_shards = SHARDS_PER_THREAD * num_threads;
+    for (int i = 0; i < num_shards; ++i) {
+        shards.push_back(utils::make_unique_ptr<Shard>(num_bins));
+    }
+    int num_variables = task_proxy.get_variables().size();
+    thread_data.resize(num_threads);
+    for (ThreadData &data : thread_data) {
+        data.successors_by_shard.resize(num_shards);
+        data.values.resize(num_variables);
+        data.successor_values.resize(num_variables);
+        data.num_expanded = 0;
+        if (has_axioms) {
+            data.axiom_evaluator =
+                utils::make_unique_ptr<AxiomEvaluator>(task_proxy);
+        }
+    }
+
+    vector<PackedStateBin> buffer(num_bins, 0);
+    State initial_state = task_proxy.get_initial_state();
+    for (int var = 0; var < num_variables; ++var) {
+        state_packer.set(buffer.data(), var, initial_state[var].get_value());
+    }
+    int shard_id = hash_state(buffer.data(), num_bins) % num_shards;
+    current_layer.push_back(insert_state(shard_id, buffer.data(), -1, -1));
+    statistics.inc_generated();
+}
+
+void ParallelBreadthFirstSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    log << "Stored states: " << get_num_stored_states() << endl;
+    pruning_method->print_statistics();
+}
+
+long long ParallelBreadthFirstSearch::get_num_stored_states() const {
+    long long num_states = 0;
+    for (const auto &shard : shards) {
+        num_states += shard->states.size();
+    }
+    return num_states;
+}
+
+vector<OperatorID> ParallelBreadthFirstSearch::trace_path(int goal_id) const {
+    assert(write_plan);
+    int num_shards = shards.size();
+    vector<OperatorID> path;
+    int id = goal_id;
+    for (;;) {
+        const pair<int, int> &parent =
+            shards[id % num_shards]->parents[id / num_shards];
+        if (parent.first == -1) {
+            break;
+        }
+        path.emplace_back(parent.second);
+        id = parent.first;
+    }
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+vector<int> ParallelBreadthFirstSearch::find_goals() {
+    for (ThreadData &data : thread_data) {
+        data.goals.clear();
+    }
+    utils::parallel_for(
+        num_threads, 0, current_layer.size(),
+        [this](int thread_id, int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                if (is_goal(get_buffer(current_layer[i]))) {
+                    thread_data[thread_id].goals.push_back(i);
+                }
+            }
+        });
+    vector<int> goal_positions;
+    for (const ThreadData &data : thread_data) {
+        goal_positions.insert(
+            goal_positions.end(), data.goals.begin(), data.goals.end());
+    }
+    sort(goal_positions.begin(), goal_positions.end());
+    vector<int> goals;
+    goals.reserve(goal_positions.size());
+    for (int pos : goal_positions) {
+        goals.push_back(current_layer[pos]);
+    }
+    return goals;
+}
+
+void ParallelBreadthFirstSearch::clear_successors(ThreadData &data) {
+    data.successors.clear();
+    data.successor_parents.clear();
+    data.successor_operators.clear();
+    for (vector<int> &successors : data.successors_by_shard) {
+        successors.clear();
+    }
+    data.new_state_ids.clear();
+    data.num_expanded = 0;
+}
+
+void ParallelBreadthFirstSearch::expand(int thread_id, int begin, int end) {
+    ThreadData &data = thread_data[thread_id];
+    int num_shards = shards.size();
+    for (int i = begin; i < end; ++i) {
+        int id = current_layer[i];
+        const PackedStateBin *buffer = get_buffer(id);
+        ++data.num_expanded;
+        data.applicable_ops.clear();
+        successor_generator.generate_applicable_ops(buffer, data.applicable_ops);
+        if (has_axioms || use_pruning) {
+            unpack(buffer, data.values);
+        }
+        if (use_pruning) {
+            State state(*task, vector<int>(data.values));
+            lock_guard<mutex> lock(pruning_mutex);
+            pruning_method->prune_operators(state, data.applicable_ops);
+        }
+
+        for (OperatorID op_id : data.applicable_ops) {
+            size_t offset = data.successors.size();
+            data.successors.insert(data.successors.end(), buffer, buffer + num_bins);
+            PackedStateBin *successor = &data.successors[offset];
+            for (const Effect &effect : effects_by_operator[op_id.get_index()]) {
+                bool fires = all_of(
+                    effect.conditions.begin(), effect.conditions.end(),
+                    [&](const FactPair &condition) {
+                        return state_packer.get(buffer, condition.var) == condition.value;
+                    });
+                if (fires) {
+                    state_packer.set(successor, effect.var, effect.value);
+                }
+            }
+            if (has_axioms) {
+                unpack(successor, data.successor_values);
+                data.axiom_evaluator->evaluate_incrementally(
+                    data.values, data.successor_values);
+                for (size_t var = 0; var < data.successor_values.size(); ++var) {
+                    state_packer.set(successor, var, data.successor_values[var]);
+                }
+            }
+            int shard_id = hash_state(successor, num_bins) % num_shards;
+            data.successors_by_shard[shard_id].push_back(
+                data.successor_parents.size());
+            data.successor_parents.push_back(id);
+            data.successor_operators.push_back(op_id.get_index());
+        }
+    }
+    data.new_state_ids.assign(data.successor_parents.size(), -1);
+}
+
+void ParallelBreadthFirstSearch::insert_successors(int shard_id) {
+    // Visit the successors in the order of generation.
+    for (ThreadData &data : thread_data) {
+        for (int index : data.successors_by_shard[shard_id]) {
+            data.new_state_ids[index] = insert_state(
+                shard_id, &data.successors[index * num_bins],
+                data.successor_parents[index], data.successor_operators[index]);
+        }
+    }
+}
+
+SearchStatus ParallelBreadthFirstSearch::step() {
+    if (current_layer.empty()) {
+        if (found_solution()) {
+            log << "Completely explored state space -- found solution." << endl;
+            return SOLVED;
+        } else {
+            log << "Completely explored state space -- no solution!" << endl;
+            return UNSOLVABLE;
+        }
+    }
+
+    /*
+      Like the sequential search, consider the goals in the order in which
+      they were generated and save each plan that is more expensive than
+      the previous one.
+    */
+    for (int goal_id : find_goals()) {
+        vector<OperatorID> plan;
+        if (write_plan) {
+            plan = trace_path(goal_id);
+        }
+        int plan_cost = calculate_plan_cost(plan, task_proxy);
+        if (plan_cost > last_plan_cost) {
+            plan_manager.save_plan(plan, task_proxy, !single_plan);
+            last_plan_cost = plan_cost;
+            set_plan(plan);
+        }
+        if (single_plan) {
+            return SOLVED;
+        }
+    }
+
+    next_layer.clear();
+    int batch_size = BATCH_SIZE_PER_THREAD * num_threads;
+    int layer_size = current_layer.size();
+    for (int batch_begin = 0; batch_begin < layer_size; batch_begin += batch_size) {
+        int batch_end = min(batch_begin + batch_size, layer_size);
+        utils::parallel_for(
+            num_threads, batch_begin, batch_end,
+            [this](int thread_id, int begin, int end) {
+                expand(thread_id, begin, end);
+            });
+        utils::parallel_for(
+            num_threads, 0, shards.size(),
+            [this](int, int begin, int end) {
+                for (int shard_id = begin; shard_id < end; ++shard_id) {
+                    insert_successors(shard_id);
+                }
+            });
+        for (ThreadData &data : thread_data) {
+            statistics.inc_expanded(data.num_expanded);
+            statistics.inc_generated(data.new_state_ids.size());
+            for (int id : data.new_state_ids) {
+                if (id != -1) {
+                    next_layer.push_back(id);
+                }
+            }
+            // Threads without work in the next batch must not keep this data.
+            clear_successors(data);
+        }
+    }
+    current_layer.swap(next_layer);
+    if (log.is_at_least_verbose()) {
+        log << "Expanded layer, next layer has " << current_layer.size()
+            << " states, " << get_num_stored_states() << " states stored"
+            << endl;
+    }
+    return IN_PROGRESS;
+}
+
+void ParallelBreadthFirstSearch::save_plan_if_necessary() {
+    // We don't need to save here, as we automatically save plans when we find them.
+}
+}
@@ -0,0 +1,149 @@
+#ifndef SEARCH_ENGINES_PARALLEL_BREADTH_FIRST_SEARCH_H
+#define SEARCH_ENGINES_PARALLEL_BREADTH_FIRST_SEARCH_H
+
+#include "../search_engine.h"
+
+#include "../algorithms/segmented_vector.h"
+
+#include <parallel_hashmap/phmap.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class AxiomEvaluator;
+class PruningMethod;
+
+namespace options {
+class Options;
+}
+
+namespace breadth_first_search {
+/*
+  Level-synchronous breadth-first search with multiple threads (used by
+  brfs() for threads > 1).
+
+  The states of a layer are expanded in batches. For each batch, the
+  threads expand disjoint slices of the batch into thread-local buffers
+  of packed successor states. Then each thread deduplicates the
+  successors of a disjoint set of shards. Each shard stores the packed
+  states whose hash maps to it together with a hash set for duplicate
+  detection, so shards can be modified in parallel without locks.
+
+  Successors are inserted in the order in which the sequential search
+  generates them, so the layers contain the same states in the same
+  order as with BreadthFirstSearch. The goal test is applied to a whole
+  layer before expanding it.
+
+  States are stored in the shards instead of the search engine's state
+  registry and can't be accessed through PerStateInformation. Pruning
+  methods are not thread-safe, so we serialize the calls to them.
+*/
+class ParallelBreadthFirstSearch : public SearchEngine {
+    struct Effect {
+        int var;
+        int value;
+        std::vector<FactPair> conditions;
+    };
+
+    using StatePool = segmented_vector::SegmentedArrayVector<PackedStateBin>;
+
+    struct StateHash {
+        const StatePool &pool;
+        int num_bins;
+        StateHash(const StatePool &pool, int num_bins)
+            : pool(pool), num_bins(num_bins) {
+        }
+        std::uint64_t operator()(int index) const;
+    };
+
+    struct StateEqual {
+        const StatePool &pool;
+        int num_bins;
+        StateEqual(const StatePool &pool, int num_bins)
+            : pool(pool), num_bins(num_bins) {
+        }
+        bool operator()(int lhs, int rhs) const {
+            const PackedStateBin *lhs_data = pool[lhs];
+            return std::equal(lhs_data, lhs_data + num_bins, pool[rhs]);
+        }
+    };
+
+    struct Shard {
+        StatePool states;
+        phmap::flat_hash_set<int, StateHash, StateEqual> indices;
+        // Parent state and creating operator (only used with write_plan).
+        std::vector<std::pair<int, int>> parents;
+
+        explicit Shard(int num_bins);
+    };
+
+    struct ThreadData {
+        // Packed successor states of the current batch.
+        std::vector<PackedStateBin> successors;
+        std::vector<int> successor_parents;
+        std::vector<int> successor_operators;
+        // Indices of the successors by shard in the order of generation.
+        std::vector<std::vector<int>> successors_by_shard;
+        // ID of each successor if it is a new state, or -1.
+        std::vector<int> new_state_ids;
+
+        std::vector<OperatorID> applicable_ops;
+        std::vector<int> values;
+        std::vector<int> successor_values;
+        std::unique_ptr<AxiomEvaluator> axiom_evaluator;
+        std::vector<int> goals;
+        int num_expanded;
+    };
+
+    const bool single_plan;
+    const bool write_plan;
+    const int num_threads;
+    const std::shared_ptr<PruningMethod> pruning_method;
+    const bool use_pruning;
+    const int_packer::IntPacker &state_packer;
+    const int num_bins;
+    const bool has_axioms;
+    int last_plan_cost;
+
+    std::vector<FactPair> goals;
+    std::vector<std::vector<Effect>> effects_by_operator;
+
+    /*
+      State IDs are local_index * num_shards + shard. They are independent
+      of the IDs in state_registry.
+    */
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<ThreadData> thread_data;
+    std::vector<int> current_layer;
+    std::vector<int> next_layer;
+    std::mutex pruning_mutex;
+
+    const PackedStateBin *get_buffer(int id) const;
+    void unpack(const PackedStateBin *buffer, std::vector<int> &values) const;
+    bool is_goal(const PackedStateBin *buffer) const;
+    int insert_state(int shard_id, const PackedStateBin *buffer,
+                     int parent_id, int op_id);
+    // Return the goal states of the current layer in layer order.
+    std::vector<int> find_goals();
+    void clear_successors(ThreadData &data);
+    void expand(int thread_id, int begin, int end);
+    void insert_successors(int shard_id);
+    std::vector<OperatorID> trace_path(int goal_id) const;
+    long long get_num_stored_states() const;
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit ParallelBreadthFirstSearch(const options::Options &opts);
+    virtual ~ParallelBreadthFirstSearch() override;
+
+    virtual void save_plan_if_necessary() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
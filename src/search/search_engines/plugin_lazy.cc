@@ -4,6 +4,8 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../task_utils/applicable_operators_cache.h"
+
 using namespace std;
 
 namespace plugin_lazy {
@@ -15,6 +17,7 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
         "preferred",
         "use preferred operators of these evaluators", "[]");
     SearchEngine::add_succ_order_options(parser);
+    applicable_operators_cache::add_options_to_parser(parser);
     SearchEngine::add_options_to_parser(parser);
     Options opts = parser.parse();
 
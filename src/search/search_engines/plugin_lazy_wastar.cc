@@ -4,6 +4,8 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../task_utils/applicable_operators_cache.h"
+
 using namespace std;
 
 namespace plugin_lazy_wastar {
@@ -65,6 +67,7 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
                            DEFAULT_LAZY_BOOST);
     parser.add_option<int>("w", "evaluator weight", "1");
     SearchEngine::add_succ_order_options(parser);
+    applicable_operators_cache::add_options_to_parser(parser);
     SearchEngine::add_options_to_parser(parser);
     Options opts = parser.parse();
 
@@ -12,6 +12,7 @@
 #include "../open_lists/tiebreaking_open_list.h"
 
 #include <memory>
+#include <string>
 
 using namespace std;
 
@@ -95,6 +96,8 @@ static shared_ptr<Evaluator> create_wastar_eval(const Options &options,
             "verbosity", options.get<utils::Verbosity>("verbosity"));
         weighted_evaluator_options.set<shared_ptr<Evaluator>>("eval", h_eval);
         weighted_evaluator_options.set<int>("weight", w);
+        weighted_evaluator_options.set_unparsed_config(
+            "weight(" + h_eval->get_description() + ", " + to_string(w) + ")");
         w_h_eval = make_shared<WeightedEval>(weighted_evaluator_options);
     }
     Options sum_evaluator_options;
@@ -102,6 +105,8 @@ static shared_ptr<Evaluator> create_wastar_eval(const Options &options,
         "verbosity", options.get<utils::Verbosity>("verbosity"));
     sum_evaluator_options.set<vector<shared_ptr<Evaluator>>>(
         "evals", vector<shared_ptr<Evaluator>>({g_eval, w_h_eval}));
+    sum_evaluator_options.set_unparsed_config(
+        "sum([g(), " + w_h_eval->get_description() + "])");
     return make_shared<SumEval>(sum_evaluator_options);
 }
 
@@ -114,6 +119,7 @@ shared_ptr<OpenListFactory> create_wastar_open_list_factory(
     Options g_evaluator_options;
     g_evaluator_options.set<utils::Verbosity>(
         "verbosity", options.get<utils::Verbosity>("verbosity"));
+    g_evaluator_options.set_unparsed_config("g()");
     shared_ptr<GEval> g_eval = make_shared<GEval>(g_evaluator_options);
     vector<shared_ptr<Evaluator>> f_evals;
     f_evals.reserve(base_evals.size());
@@ -131,6 +137,7 @@ create_astar_open_list_factory_and_f_eval(const Options &opts) {
     Options g_evaluator_options;
     g_evaluator_options.set<utils::Verbosity>(
         "verbosity", opts.get<utils::Verbosity>("verbosity"));
+    g_evaluator_options.set_unparsed_config("g()");
     shared_ptr<GEval> g = make_shared<GEval>(g_evaluator_options);
     shared_ptr<Evaluator> h = opts.get<shared_ptr<Evaluator>>("eval");
     Options f_evaluator_options;
@@ -138,6 +145,8 @@ create_astar_open_list_factory_and_f_eval(const Options &opts) {
         "verbosity", opts.get<utils::Verbosity>("verbosity"));
     f_evaluator_options.set<vector<shared_ptr<Evaluator>>>(
         "evals", vector<shared_ptr<Evaluator>>({g, h}));
+    f_evaluator_options.set_unparsed_config(
+        "sum([g(), " + h->get_description() + "])");
     shared_ptr<Evaluator> f = make_shared<SumEval>(f_evaluator_options);
     vector<shared_ptr<Evaluator>> evals = {f, h};
 
@@ -0,0 +1,378 @@
+#include "state_space_dump.h"
+
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+using utils::ExitCode;
+
+namespace state_space_dump {
+static const char MAGIC[] = {'\0', 'S', 'S', 'D'};
+static const size_t BLOCK_SIZE = 1 << 20;
+static const size_t MAX_PENDING_BLOCKS = 64;
+static const int MIN_MATCH_LENGTH = 4;
+static const int HASH_BITS = 14;
+
+enum RecordType {
+    FACT = 0,
+    NON_GOAL_STATE = 1,
+    GOAL_STATE = 2
+};
+
+static void write_varint(uint64_t value, vector<uint8_t> &bytes) {
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<uint8_t>(value));
+}
+
+static void exit_with_corrupted_file() {
+    cerr << "Corrupted state space file." << endl;
+    utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+}
+
+static uint64_t read_varint(const uint8_t *&pos, const uint8_t *end) {
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        if (pos == end || shift > 63) {
+            exit_with_corrupted_file();
+        }
+        uint8_t byte = *pos++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+}
+
+static uint32_t read_uint32(const uint8_t *pos) {
+    uint32_t value;
+    memcpy(&value, pos, sizeof(value));
+    return value;
+}
+
+/*
+  The compressed data is a sequence of literal runs and back-references:
+  the length of a run of literals, the literals, and (unless the end of
+  the block has been reached) the length of a match minus
+  MIN_MATCH_LENGTH and its distance. We find matches by hashing four
+  bytes at every position that is not part of a match.
+*/
+static void compress_block(const vector<uint8_t> &input, vector<uint8_t> &output) {
+    output.clear();
+    vector<int> last_position(1 << HASH_BITS, -1);
+    const uint8_t *data = input.data();
+    int size = input.size();
+    int anchor = 0;
+    int pos = 0;
+    while (pos + MIN_MATCH_LENGTH <= size) {
+        uint32_t sequence = read_uint32(data + pos);
+        uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+        int candidate = last_position[hash];
+        last_position[hash] = pos;
+        if (candidate >= 0 && read_uint32(data + candidate) == sequence) {
+            int length = MIN_MATCH_LENGTH;
+            while (pos + length < size && data[candidate + length] == data[pos + length]) {
+                ++length;
+            }
+            write_varint(pos - anchor, output);
+            output.insert(output.end(), data + anchor, data + pos);
+            write_varint(length - MIN_MATCH_LENGTH, output);
+            write_varint(pos - candidate, output);
+            pos += length;
+            anchor = pos;
+        } else {
+            ++pos;
+        }
+    }
+    write_varint(size - anchor, output);
+    output.insert(output.end(), data + anchor, data + size);
+}
+
+static void decompress_block(
+    const vector<uint8_t> &input, size_t size, vector<uint8_t> &output) {
+    output.clear();
+    output.reserve(size);
+    const uint8_t *pos = input.data();
+    const uint8_t *end = pos + input.size();
+    while (true) {
+        uint64_t num_literals = read_varint(pos, end);
+        if (num_literals > static_cast<uint64_t>(end - pos) ||
+            output.size() + num_literals > size) {
+            exit_with_corrupted_file();
+        }
+        output.insert(output.end(), pos, pos + num_literals);
+        pos += num_literals;
+        if (output.size() == size)
+            break;
+        uint64_t length = read_varint(pos, end) + MIN_MATCH_LENGTH;
+        uint64_t distance = read_varint(pos, end);
+        if (distance == 0 || distance > output.size() ||
+            output.size() + length > size) {
+            exit_with_corrupted_file();
+        }
+        // Copy byte by byte since the match may overlap the output.
+        size_t from = output.size() - distance;
+        for (uint64_t i = 0; i < length; ++i) {
+            output.push_back(output[from + i]);
+        }
+    }
+    if (pos != end) {
+        exit_with_corrupted_file();
+    }
+}
+
+
+StateSpaceWriter::StateSpaceWriter(const string &filename, bool compress)
+    : file(filename, ios::binary),
+      compress(compress),
+      num_states(0),
+      finished(false),
+      uncompressed_bytes(0),
+      written_bytes(0) {
+    if (!file) {
+        cerr << "Could not open " << filename << " for writing." << endl;
+        utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    vector<uint8_t> header(MAGIC, MAGIC + sizeof(MAGIC));
+    write_varint(FORMAT_VERSION, header);
+    file.write(reinterpret_cast<const char *>(header.data()), header.size());
+    written_bytes += header.size();
+    io_thread = thread(&StateSpaceWriter::write_blocks, this);
+}
+
+StateSpaceWriter::~StateSpaceWriter() {
+    if (io_thread.joinable()) {
+        finish();
+    }
+}
+
+void StateSpaceWriter::start_block_if_full() {
+    if (block.size() < BLOCK_SIZE) {
+        return;
+    }
+    unique_lock<mutex> lock(queue_mutex);
+    block_written.wait(lock, [this]() {
+                           return pending_blocks.size() < MAX_PENDING_BLOCKS;
+                       });
+    pending_blocks.push_back(move(block));
+    block.clear();
+    if (!free_blocks.empty()) {
+        block = move(free_blocks.back());
+        free_blocks.pop_back();
+    }
+    lock.unlock();
+    block_pending.notify_one();
+}
+
+void StateSpaceWriter::write_block(const vector<uint8_t> &data) {
+    const vector<uint8_t> *stored = &data;
+    if (compress) {
+        compress_block(data, compressed_block);
+        if (compressed_block.size() < data.size()) {
+            stored = &compressed_block;
+        }
+    }
+    vector<uint8_t> header;
+    write_varint(data.size(), header);
+    write_varint(stored->size(), header);
+    file.write(reinterpret_cast<const char *>(header.data()), header.size());
+    file.write(reinterpret_cast<const char *>(stored->data()), stored->size());
+    if (!file) {
+        cerr << "Failed to write state space file." << endl;
+        utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    uncompressed_bytes += data.size();
+    written_bytes += header.size() + stored->size();
+}
+
+void StateSpaceWriter::write_blocks() {
+    vector<uint8_t> data;
+    while (true) {
+        {
+            unique_lock<mutex> lock(queue_mutex);
+            block_pending.wait(lock, [this]() {
+                                   return !pending_blocks.empty() || finished;
+                               });
+            if (pending_blocks.empty()) {
+                return;
+            }
+            data = move(pending_blocks.front());
+            pending_blocks.pop_front();
+        }
+        write_block(data);
+        data.clear();
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            free_blocks.push_back(move(data));
+        }
+        block_written.notify_one();
+    }
+}
+
+void StateSpaceWriter::add_fact(int fact_id, const string &name) {
+    write_varint(FACT, block);
+    write_varint(fact_id, block);
+    write_varint(name.size(), block);
+    block.insert(block.end(), name.begin(), name.end());
+    start_block_if_full();
+}
+
+void StateSpaceWriter::add_state(
+    bool is_goal, const vector<int> &fact_ids, const vector<int> &successor_ids) {
+    write_varint(is_goal ? GOAL_STATE : NON_GOAL_STATE, block);
+    write_varint(fact_ids.size(), block);
+    int previous_fact = 0;
+    for (int fact : fact_ids) {
+        assert(fact >= previous_fact);
+        write_varint(fact - previous_fact, block);
+        previous_fact = fact;
+    }
+    write_varint(successor_ids.size(), block);
+    for (int succ_id : successor_ids) {
+        int64_t diff = static_cast<int64_t>(succ_id) - num_states;
+        write_varint((static_cast<uint64_t>(diff) << 1) ^ (diff >> 63), block);
+    }
+    ++num_states;
+    start_block_if_full();
+}
+
+void StateSpaceWriter::finish() {
+    if (!block.empty()) {
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            pending_blocks.push_back(move(block));
+        }
+        block.clear();
+    }
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        finished = true;
+    }
+    block_pending.notify_one();
+    io_thread.join();
+
+    // The block with size 0 marks the end of the file.
+    vector<uint8_t> end_marker;
+    write_varint(0, end_marker);
+    write_varint(0, end_marker);
+    file.write(reinterpret_cast<const char *>(end_marker.data()), end_marker.size());
+    written_bytes += end_marker.size();
+    file.close();
+    if (!file) {
+        cerr << "Failed to write state space file." << endl;
+        utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+}
+
+
+StateSpaceReader::StateSpaceReader(const string &filename)
+    : file(filename, ios::binary),
+      position(0),
+      end_of_file(false),
+      fact_record(false),
+      fact_id(-1),
+      state_id(-1),
+      goal(false) {
+    if (!file) {
+        cerr << "Could not open " << filename << " for reading." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    char magic[sizeof(MAGIC)];
+    file.read(magic, sizeof(magic));
+    if (!file || !equal(magic, magic + sizeof(magic), MAGIC)) {
+        cerr << filename << " is not a state space file." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    if (read_file_varint() != FORMAT_VERSION) {
+        cerr << "Unsupported version of state space file." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+uint64_t StateSpaceReader::read_file_varint() {
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        int byte = file.get();
+        if (byte == EOF || shift > 63) {
+            exit_with_corrupted_file();
+        }
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+}
+
+bool StateSpaceReader::read_block() {
+    uint64_t size = read_file_varint();
+    uint64_t stored_size = read_file_varint();
+    if (size == 0) {
+        end_of_file = true;
+        return false;
+    }
+    if (stored_size > size) {
+        exit_with_corrupted_file();
+    }
+    stored_block.resize(stored_size);
+    file.read(reinterpret_cast<char *>(stored_block.data()), stored_size);
+    if (!file) {
+        exit_with_corrupted_file();
+    }
+    if (stored_size == size) {
+        block.swap(stored_block);
+    } else {
+        decompress_block(stored_block, size, block);
+    }
+    position = 0;
+    return true;
+}
+
+uint64_t StateSpaceReader::read_varint() {
+    const uint8_t *pos = block.data() + position;
+    uint64_t value = state_space_dump::read_varint(pos, block.data() + block.size());
+    position = pos - block.data();
+    return value;
+}
+
+bool StateSpaceReader::read_next() {
+    while (position == block.size()) {
+        if (end_of_file || !read_block()) {
+            return false;
+        }
+    }
+    uint64_t type = read_varint();
+    if (type == FACT) {
+        fact_record = true;
+        fact_id = read_varint();
+        uint64_t length = read_varint();
+        if (length > block.size() - position) {
+            exit_with_corrupted_file();
+        }
+        fact_name.assign(block.begin() + position, block.begin() + position + length);
+        position += length;
+    } else if (type == NON_GOAL_STATE || type == GOAL_STATE) {
+        fact_record = false;
+        ++state_id;
+        goal = (type == GOAL_STATE);
+        fact_ids.resize(read_varint());
+        int fact = 0;
+        for (int &id : fact_ids) {
+            fact += read_varint();
+            id = fact;
+        }
+        successor_ids.resize(read_varint());
+        for (int &succ_id : successor_ids) {
+            uint64_t value = read_varint();
+            int64_t diff = static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+            succ_id = state_id + diff;
+        }
+    } else {
+        exit_with_corrupted_file();
+    }
+    return true;
+}
+}
@@ -0,0 +1,155 @@
+#ifndef SEARCH_ENGINES_STATE_SPACE_DUMP_H
+#define SEARCH_ENGINES_STATE_SPACE_DUMP_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace state_space_dump {
+/*
+  Binary format for dumping a state space (see ExhaustiveSearch).
+
+  A file starts with the bytes "\0SSD" followed by the format version.
+  The rest of the file is a sequence of blocks, each consisting of its
+  uncompressed size, its stored size and the stored bytes. A block with
+  uncompressed size 0 ends the file. If the stored size is smaller than
+  the uncompressed size, the block is compressed with a simple LZ77
+  scheme (literal runs and back-references, similar to LZ4).
+
+  The uncompressed blocks hold records that never span block
+  boundaries. All integers are base-128 varints.
+
+    fact:  0, fact ID, length of name, characters of name
+    state: 1 (non-goal state) or 2 (goal state), number of facts,
+           fact IDs in increasing order as gaps to the previous ID,
+           number of successors, zigzag-encoded differences between
+           successor IDs and the state ID
+
+  States are stored in the order of their IDs (0, 1, 2, ...), so their
+  IDs are implicit and the successor lists form the rows of the
+  transition matrix in compressed sparse row format.
+*/
+const int FORMAT_VERSION = 1;
+
+/*
+  Write a state space to a file. Records are collected in blocks which
+  are compressed and written by a dedicated I/O thread, so that the
+  caller only blocks if the disk falls behind by more than a fixed number
+  of blocks.
+*/
+class StateSpaceWriter {
+    std::ofstream file;
+    const bool compress;
+    int num_states;
+
+    std::vector<std::uint8_t> block;
+    std::vector<std::uint8_t> compressed_block;
+    std::deque<std::vector<std::uint8_t>> pending_blocks;
+    std::vector<std::vector<std::uint8_t>> free_blocks;
+    bool finished;
+    std::mutex queue_mutex;
+    std::condition_variable block_pending;
+    std::condition_variable block_written;
+    std::thread io_thread;
+
+    // Only accessed by the I/O thread until it is joined.
+    std::uint64_t uncompressed_bytes;
+    std::uint64_t written_bytes;
+
+    void start_block_if_full();
+    void write_block(const std::vector<std::uint8_t> &data);
+    void write_blocks();
+public:
+    StateSpaceWriter(const std::string &filename, bool compress);
+    ~StateSpaceWriter();
+
+    void add_fact(int fact_id, const std::string &name);
+    /*
+      Add the next state. fact_ids must be sorted. The successors may
+      include states that have not been added yet.
+    */
+    void add_state(
+        bool is_goal, const std::vector<int> &fact_ids,
+        const std::vector<int> &successor_ids);
+
+    // Write the remaining records and wait for the I/O thread.
+    void finish();
+
+    int get_num_states() const {
+        return num_states;
+    }
+    // Only valid after finish().
+    std::uint64_t get_uncompressed_bytes() const {
+        return uncompressed_bytes;
+    }
+    std::uint64_t get_written_bytes() const {
+        return written_bytes;
+    }
+};
+
+/*
+  Read a file written by StateSpaceWriter record by record:
+
+    StateSpaceReader reader(filename);
+    while (reader.read_next()) {
+        if (reader.is_fact()) ... else ...
+    }
+*/
+class StateSpaceReader {
+    std::ifstream file;
+    std::vector<std::uint8_t> block;
+    std::vector<std::uint8_t> stored_block;
+    std::size_t position;
+    bool end_of_file;
+
+    bool fact_record;
+    int fact_id;
+    std::string fact_name;
+    int state_id;
+    bool goal;
+    std::vector<int> fact_ids;
+    std::vector<int> successor_ids;
+
+    std::uint64_t read_file_varint();
+    bool read_block();
+    std::uint64_t read_varint();
+public:
+    explicit StateSpaceReader(const std::string &filename);
+
+    // Read the next record. Return false at the end of the file.
+    bool read_next();
+
+    bool is_fact() const {
+        return fact_record;
+    }
+
+    // Data of fact records.
+    int get_fact_id() const {
+        return fact_id;
+    }
+    const std::string &get_fact_name() const {
+        return fact_name;
+    }
+
+    // Data of state records.
+    int get_state_id() const {
+        return state_id;
+    }
+    bool is_goal() const {
+        return goal;
+    }
+    const std::vector<int> &get_fact_ids() const {
+        return fact_ids;
+    }
+    const std::vector<int> &get_successor_ids() const {
+        return successor_ids;
+    }
+};
+}
+
+#endif
@@ -0,0 +1,153 @@
+#include "successor_generator_benchmark.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/sampling.h"
+#include "../task_utils/successor_generator.h"
+#include "../utils/logging.h"
+#include "../utils/rng.h"
+#include "../utils/rng_options.h"
+#include "../utils/system.h"
+#include "../utils/timer.h"
+
+using namespace std;
+
+namespace successor_generator_benchmark {
+SuccessorGeneratorBenchmark::SuccessorGeneratorBenchmark(const Options &opts)
+    : SearchEngine(opts),
+      num_states(opts.get<int>("num_states")),
+      max_walk_length(opts.get<int>("max_walk_length")),
+      repetitions(opts.get<int>("repetitions")),
+      rng(utils::parse_rng_from_options(opts)) {
+}
+
+void SuccessorGeneratorBenchmark::initialize() {
+    record_states();
+}
+
+void SuccessorGeneratorBenchmark::record_states() {
+    utils::Timer timer;
+    int num_generated = 0;
+    recorded_states = sampling::record_random_walk_states(
+        state_registry, successor_generator, num_states, max_walk_length,
+        *rng, num_generated);
+    statistics.inc_generated(num_generated);
+    utils::g_log << "Recorded " << recorded_states.size() << " states ("
+                 << state_registry.size() << " distinct) in " << timer
+                 << endl;
+}
+
+template<typename Generate>
+static void time_queries(
+    const string &name, const vector<StateID> &states, int repetitions,
+    const Generate &generate) {
+    vector<OperatorID> applicable_ops;
+    long long num_applicable_ops = 0;
+    utils::Timer timer;
+    for (int rep = 0; rep < repetitions; ++rep) {
+        for (StateID id : states) {
+            applicable_ops.clear();
+            generate(id, applicable_ops);
+            num_applicable_ops += applicable_ops.size();
+        }
+    }
+    double time = timer();
+    long long num_queries = static_cast<long long>(repetitions) * states.size();
+    utils::g_log << name << ": " << num_queries << " queries in " << time
+                 << "s (" << num_queries / max(time, 1e-9)
+                 << " queries/s), " << num_applicable_ops / repetitions
+                 << " applicable operators" << endl;
+}
+
+SearchStatus SuccessorGeneratorBenchmark::step() {
+    utils::g_log << "Compiled program size: "
+                 << successor_generator.get_program_size() << endl;
+
+    // Make sure that all variants produce the same operators in the same order.
+    vector<OperatorID> expected_ops;
+    vector<OperatorID> ops;
+    for (StateID id : recorded_states) {
+        State state = state_registry.lookup_state(id);
+        state.unpack();
+        expected_ops.clear();
+        successor_generator.generate_applicable_ops(
+            state.get_unpacked_values(), expected_ops);
+        ops.clear();
+        successor_generator.generate_applicable_ops_with_program(
+            state.get_unpacked_values(), ops);
+        bool unpacked_ok = (ops == expected_ops);
+        ops.clear();
+        successor_generator.generate_applicable_ops(state.get_buffer(), ops);
+        if (!unpacked_ok || ops != expected_ops) {
+            cerr << "Compiled successor generator differs from the decision "
+                 << "tree in state " << id << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+    }
+
+    time_queries(
+        "Decision tree (unpacked)", recorded_states, repetitions,
+        [this](StateID id, vector<OperatorID> &applicable_ops) {
+            State state = state_registry.lookup_state(id);
+            state.unpack();
+            successor_generator.generate_applicable_ops(
+                state.get_unpacked_values(), applicable_ops);
+        });
+    time_queries(
+        "Compiled program (unpacked)", recorded_states, repetitions,
+        [this](StateID id, vector<OperatorID> &applicable_ops) {
+            State state = state_registry.lookup_state(id);
+            state.unpack();
+            successor_generator.generate_applicable_ops_with_program(
+                state.get_unpacked_values(), applicable_ops);
+        });
+    time_queries(
+        "Compiled program (packed)", recorded_states, repetitions,
+        [this](StateID id, vector<OperatorID> &applicable_ops) {
+            State state = state_registry.lookup_state(id);
+            successor_generator.generate_applicable_ops(
+                state.get_buffer(), applicable_ops);
+        });
+    return FAILED;
+}
+
+void SuccessorGeneratorBenchmark::print_statistics() const {
+    statistics.print_detailed_statistics();
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Successor generator benchmark",
+        "Record states with random walks from the initial state and "
+        "measure the applicable operator queries per second of the "
+        "decision tree successor generator and of the compiled successor "
+        "generator on unpacked and packed states. All variants must "
+        "produce the same operators. The search never finds a plan.");
+    parser.add_option<int>(
+        "num_states",
+        "number of states to record",
+        "10000",
+        Bounds("1", "infinity"));
+    parser.add_option<int>(
+        "max_walk_length",
+        "restart random walks from the initial state after this many steps",
+        "100",
+        Bounds("0", "infinity"));
+    parser.add_option<int>(
+        "repetitions",
+        "number of times each state is queried",
+        "10",
+        Bounds("1", "infinity"));
+    utils::add_rng_options(parser);
+    SearchEngine::add_options_to_parser(parser);
+
+    Options opts = parser.parse();
+    if (parser.dry_run()) {
+        return nullptr;
+    }
+    return make_shared<SuccessorGeneratorBenchmark>(opts);
+}
+
+static Plugin<SearchEngine> _plugin("benchmark_successor_generator", _parse);
+}
@@ -0,0 +1,44 @@
+#ifndef SEARCH_ENGINES_SUCCESSOR_GENERATOR_BENCHMARK_H
+#define SEARCH_ENGINES_SUCCESSOR_GENERATOR_BENCHMARK_H
+
+#include "../search_engine.h"
+
+#include <memory>
+#include <vector>
+
+namespace options {
+class Options;
+}
+
+namespace utils {
+class RandomNumberGenerator;
+}
+
+namespace successor_generator_benchmark {
+/*
+  Record states with random walks and measure how many applicable
+  operator queries per second the decision tree and the compiled
+  successor generator answer for unpacked and packed states.
+*/
+class SuccessorGeneratorBenchmark : public SearchEngine {
+    const int num_states;
+    const int max_walk_length;
+    const int repetitions;
+    std::shared_ptr<utils::RandomNumberGenerator> rng;
+
+    std::vector<StateID> recorded_states;
+
+    void record_states();
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit SuccessorGeneratorBenchmark(const options::Options &opts);
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -7,18 +7,34 @@
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 
+/*
+  The creating operator and the real g value of a node are not part of
+  SearchNodeInfo because compact search spaces don't store them (see
+  SearchSpace). The default layout stores them in FullSearchNodeInfo.
+*/
 struct SearchNodeInfo {
     enum NodeStatus {NEW = 0, OPEN = 1, CLOSED = 2, DEAD_END = 3};
 
     unsigned int status : 2;
     int g : 30;
     StateID parent_state_id;
+
+    SearchNodeInfo()
+        : status(NEW), g(-1), parent_state_id(StateID::no_state) {
+    }
+};
+
+/*
+  Keep all fields of a node together, so that the default layout only
+  needs a single per-state lookup for each node.
+*/
+struct FullSearchNodeInfo {
+    SearchNodeInfo info;
     OperatorID creating_operator;
     int real_g;
 
-    SearchNodeInfo()
-        : status(NEW), g(-1), parent_state_id(StateID::no_state),
-          creating_operator(-1), real_g(-1) {
+    FullSearchNodeInfo()
+        : creating_operator(OperatorID::no_operator), real_g(-1) {
     }
 };
 
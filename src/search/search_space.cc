@@ -7,11 +7,14 @@
 #include "utils/logging.h"
 
 #include <cassert>
+#include <limits>
 
 using namespace std;
 
-SearchNode::SearchNode(const State &state, SearchNodeInfo &info)
-    : state(state), info(info) {
+SearchNode::SearchNode(const State &state, SearchNodeInfo &info,
+                       OperatorID *creating_operator, int *real_g)
+    : state(state), info(info), creating_operator(creating_operator),
+      real_g(real_g) {
     assert(state.get_id() != StateID::no_state);
 }
 
@@ -41,16 +44,43 @@ int SearchNode::get_g() const {
 }
 
 int SearchNode::get_real_g() const {
-    return info.real_g;
+    // Without stored real g values, the real costs equal the adjusted costs.
+    return real_g ? *real_g : info.g;
+}
+
+StateID SearchNode::get_parent_state_id() const {
+    return info.parent_state_id;
+}
+
+OperatorID SearchNode::get_creating_operator() const {
+    assert(creating_operator);
+    return *creating_operator;
+}
+
+void SearchNode::set_parent(const SearchNode &parent_node,
+                            const OperatorProxy &parent_op,
+                            int adjusted_cost) {
+    info.g = parent_node.info.g + adjusted_cost;
+    if (real_g) {
+        *real_g = parent_node.get_real_g() + parent_op.get_cost();
+    }
+    info.parent_state_id = parent_node.get_state().get_id();
+    if (creating_operator) {
+        *creating_operator = OperatorID(parent_op.get_id());
+    }
 }
 
 void SearchNode::open_initial() {
     assert(info.status == SearchNodeInfo::NEW);
     info.status = SearchNodeInfo::OPEN;
     info.g = 0;
-    info.real_g = 0;
+    if (real_g) {
+        *real_g = 0;
+    }
     info.parent_state_id = StateID::no_state;
-    info.creating_operator = OperatorID::no_operator;
+    if (creating_operator) {
+        *creating_operator = OperatorID::no_operator;
+    }
 }
 
 void SearchNode::open(const SearchNode &parent_node,
@@ -58,10 +88,7 @@ void SearchNode::open(const SearchNode &parent_node,
                       int adjusted_cost) {
     assert(info.status == SearchNodeInfo::NEW);
     info.status = SearchNodeInfo::OPEN;
-    info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
-    info.parent_state_id = parent_node.get_state().get_id();
-    info.creating_operator = OperatorID(parent_op.get_id());
+    set_parent(parent_node, parent_op, adjusted_cost);
 }
 
 void SearchNode::reopen(const SearchNode &parent_node,
@@ -73,10 +100,7 @@ void SearchNode::reopen(const SearchNode &parent_node,
     // The latter possibility is for inconsistent heuristics, which
     // may require reopening closed nodes.
     info.status = SearchNodeInfo::OPEN;
-    info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
-    info.parent_state_id = parent_node.get_state().get_id();
-    info.creating_operator = OperatorID(parent_op.get_id());
+    set_parent(parent_node, parent_op, adjusted_cost);
 }
 
 // like reopen, except doesn't change status
@@ -87,10 +111,7 @@ void SearchNode::update_parent(const SearchNode &parent_node,
            info.status == SearchNodeInfo::CLOSED);
     // The latter possibility is for inconsistent heuristics, which
     // may require reopening closed nodes.
-    info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
-    info.parent_state_id = parent_node.get_state().get_id();
-    info.creating_operator = OperatorID(parent_op.get_id());
+    set_parent(parent_node, parent_op, adjusted_cost);
 }
 
 void SearchNode::close() {
@@ -106,23 +127,78 @@ void SearchNode::dump(const TaskProxy &task_proxy, utils::LogProxy &log) const {
     if (log.is_at_least_debug()) {
         log << state.get_id() << ": ";
         task_properties::dump_fdr(state);
-        if (info.creating_operator != OperatorID::no_operator) {
+        if (info.parent_state_id == StateID::no_state) {
+            log << " no parent" << endl;
+        } else if (creating_operator) {
             OperatorsProxy operators = task_proxy.get_operators();
-            OperatorProxy op = operators[info.creating_operator.get_index()];
+            OperatorProxy op = operators[creating_operator->get_index()];
             log << " created by " << op.get_name()
                 << " from " << info.parent_state_id << endl;
         } else {
-            log << " no parent" << endl;
+            log << " reached from " << info.parent_state_id << endl;
         }
     }
 }
 
-SearchSpace::SearchSpace(StateRegistry &state_registry, utils::LogProxy &log)
-    : state_registry(state_registry), log(log) {
+static bool has_adjusted_costs(const TaskProxy &task_proxy, OperatorCost cost_type) {
+    bool is_unit_cost = task_properties::is_unit_cost(task_proxy);
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        if (get_adjusted_action_cost(op, cost_type, is_unit_cost) != op.get_cost()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SearchSpace::SearchSpace(
+    StateRegistry &state_registry, const TaskProxy &task_proxy,
+    utils::LogProxy &log, bool compact, OperatorCost cost_type)
+    : real_g_values(-1),
+      state_registry(state_registry),
+      task_proxy(task_proxy),
+      log(log),
+      compact(compact),
+      store_real_g_values(compact && has_adjusted_costs(task_proxy, cost_type)) {
+}
+
+const SearchNodeInfo &SearchSpace::get_search_node_info(const State &state) const {
+    if (compact) {
+        return search_node_infos[state];
+    }
+    return full_search_node_infos[state].info;
 }
 
 SearchNode SearchSpace::get_node(const State &state) {
-    return SearchNode(state, search_node_infos[state]);
+    if (!compact) {
+        FullSearchNodeInfo &full_info = full_search_node_infos[state];
+        return SearchNode(state, full_info.info, &full_info.creating_operator,
+                          &full_info.real_g);
+    }
+    return SearchNode(
+        state, search_node_infos[state], nullptr,
+        store_real_g_values ? &real_g_values[state] : nullptr);
+}
+
+OperatorID SearchSpace::get_creating_operator(
+    const State &state, const State &parent_state) const {
+    if (!compact) {
+        return full_search_node_infos[state].creating_operator;
+    }
+    OperatorID best_op = OperatorID::no_operator;
+    int best_cost = numeric_limits<int>::max();
+    state.unpack();
+    parent_state.unpack();
+    const vector<int> &values = state.get_unpacked_values();
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        if (op.get_cost() < best_cost &&
+            task_properties::is_applicable(op, parent_state) &&
+            parent_state.get_unregistered_successor(op).get_unpacked_values() == values) {
+            best_op = OperatorID(op.get_id());
+            best_cost = op.get_cost();
+        }
+    }
+    assert(best_op != OperatorID::no_operator);
+    return best_op;
 }
 
 void SearchSpace::trace_path(const State &goal_state,
@@ -131,13 +207,13 @@ void SearchSpace::trace_path(const State &goal_state,
     assert(current_state.get_registry() == &state_registry);
     assert(path.empty());
     for (;;) {
-        const SearchNodeInfo &info = search_node_infos[current_state];
-        if (info.creating_operator == OperatorID::no_operator) {
-            assert(info.parent_state_id == StateID::no_state);
+        const SearchNodeInfo &info = get_search_node_info(current_state);
+        if (info.parent_state_id == StateID::no_state) {
             break;
         }
-        path.push_back(info.creating_operator);
-        current_state = state_registry.lookup_state(info.parent_state_id);
+        State parent_state = state_registry.lookup_state(info.parent_state_id);
+        path.push_back(get_creating_operator(current_state, parent_state));
+        current_state = move(parent_state);
     }
     reverse(path.begin(), path.end());
 }
@@ -148,12 +224,13 @@ void SearchSpace::dump(const TaskProxy &task_proxy) const {
         /* The body duplicates SearchNode::dump() but we cannot create
            a search node without discarding the const qualifier. */
         State state = state_registry.lookup_state(id);
-        const SearchNodeInfo &node_info = search_node_infos[state];
+        const SearchNodeInfo &node_info = get_search_node_info(state);
         log << id << ": ";
         task_properties::dump_fdr(state);
-        if (node_info.creating_operator != OperatorID::no_operator &&
-            node_info.parent_state_id != StateID::no_state) {
-            OperatorProxy op = operators[node_info.creating_operator.get_index()];
+        if (node_info.parent_state_id != StateID::no_state) {
+            State parent_state = state_registry.lookup_state(node_info.parent_state_id);
+            OperatorID op_id = get_creating_operator(state, parent_state);
+            OperatorProxy op = operators[op_id.get_index()];
             log << " created by " << op.get_name()
                 << " from " << node_info.parent_state_id << endl;
         } else {
@@ -164,4 +241,14 @@ void SearchSpace::dump(const TaskProxy &task_proxy) const {
 
 void SearchSpace::print_statistics() const {
     state_registry.print_statistics(log);
+    int node_bytes;
+    if (compact) {
+        node_bytes = sizeof(SearchNodeInfo);
+        if (store_real_g_values) {
+            node_bytes += sizeof(int);
+        }
+    } else {
+        node_bytes = sizeof(FullSearchNodeInfo);
+    }
+    log << "Bytes per search node: " << node_bytes << endl;
 }
@@ -2,15 +2,13 @@
 #define SEARCH_SPACE_H
 
 #include "operator_cost.h"
+#include "operator_id.h"
 #include "per_state_information.h"
 #include "search_node_info.h"
+#include "task_proxy.h"
 
 #include <vector>
 
-class OperatorProxy;
-class State;
-class TaskProxy;
-
 namespace utils {
 class LogProxy;
 }
@@ -18,8 +16,16 @@ class LogProxy;
 class SearchNode {
     State state;
     SearchNodeInfo &info;
+    // Null if the search space doesn't store the value (see SearchSpace).
+    OperatorID *creating_operator;
+    int *real_g;
+
+    void set_parent(const SearchNode &parent_node,
+                    const OperatorProxy &parent_op,
+                    int adjusted_cost);
 public:
-    SearchNode(const State &state, SearchNodeInfo &info);
+    SearchNode(const State &state, SearchNodeInfo &info,
+               OperatorID *creating_operator, int *real_g);
 
     const State &get_state() const;
 
@@ -30,6 +36,9 @@ public:
 
     int get_g() const;
     int get_real_g() const;
+    StateID get_parent_state_id() const;
+    // Only available if the search space stores creating operators.
+    OperatorID get_creating_operator() const;
 
     void open_initial();
     void open(const SearchNode &parent_node,
@@ -48,13 +57,36 @@ public:
 };
 
 
+/*
+  By default, the search space stores a FullSearchNodeInfo (16 bytes) for
+  each state. With compact=true, it only stores SearchNodeInfo (8 bytes):
+
+  - The creating operators are not stored. When tracing a path, we use the
+    cheapest operator that leads from the parent to the state. This is
+    never more expensive than the operator that created the state.
+  - The real g values are only stored if they can differ from the g
+    values, i.e., if some operator has an adjusted cost that differs from
+    its real cost (e.g., for cost_type=one on tasks with non-unit costs).
+*/
 class SearchSpace {
+    // Only used for the default layout.
+    PerStateInformation<FullSearchNodeInfo> full_search_node_infos;
+    // Only used for the compact layout.
     PerStateInformation<SearchNodeInfo> search_node_infos;
+    PerStateInformation<int> real_g_values;
 
     StateRegistry &state_registry;
+    const TaskProxy task_proxy;
     utils::LogProxy &log;
+    const bool compact;
+    const bool store_real_g_values;
+
+    const SearchNodeInfo &get_search_node_info(const State &state) const;
+    OperatorID get_creating_operator(
+        const State &state, const State &parent_state) const;
 public:
-    SearchSpace(StateRegistry &state_registry, utils::LogProxy &log);
+    SearchSpace(StateRegistry &state_registry, const TaskProxy &task_proxy,
+                utils::LogProxy &log, bool compact, OperatorCost cost_type);
 
     SearchNode get_node(const State &state);
     void trace_path(const State &goal_state,
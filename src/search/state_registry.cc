@@ -17,7 +17,8 @@ StateRegistry::StateRegistry(const TaskProxy &task_proxy)
       registered_states(
           0,
           StateIDSemanticHash(state_data_pool, get_bins_per_state()),
-          StateIDSemanticEqual(state_data_pool, get_bins_per_state())) {
+          StateIDSemanticEqual(state_data_pool, get_bins_per_state())),
+      shared(false) {
 }
 
 StateID StateRegistry::insert_id_or_pop_state() {
@@ -78,7 +79,8 @@ State StateRegistry::get_successor_state(const State &predecessor, const Operato
                 new_values[effect_pair.var] = effect_pair.value;
             }
         }
-        axiom_evaluator.evaluate(new_values);
+        axiom_evaluator.evaluate_incrementally(
+            predecessor.get_unpacked_values(), new_values);
         for (size_t i = 0; i < new_values.size(); ++i) {
             state_packer.set(buffer, i, new_values[i]);
         }
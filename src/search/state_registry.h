@@ -171,6 +171,7 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     StateIDSet registered_states;
 
     std::unique_ptr<State> cached_initial_state;
+    bool shared;
 
     StateID insert_id_or_pop_state();
     int get_bins_per_state() const;
@@ -185,6 +186,15 @@ public:
         return num_variables;
     }
 
+    // Mark the registry as shared by several search engines (see SharedStateRegistryScope).
+    void mark_as_shared() {
+        shared = true;
+    }
+
+    bool is_shared() const {
+        return shared;
+    }
+
     const int_packer::IntPacker &get_state_packer() const {
         return state_packer;
     }
@@ -0,0 +1,220 @@
+#include "applicable_operators_cache.h"
+
+#include "successor_generator.h"
+#include "task_properties.h"
+
+#include "../state_registry.h"
+
+#include "../options/option_parser.h"
+
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace applicable_operators_cache {
+static const int CHUNK_SIZE_BITS = 20;
+static const int CHUNK_SIZE = 1 << CHUNK_SIZE_BITS;
+
+static void encode_varint(unsigned int value, vector<uint8_t> &bytes) {
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<uint8_t>(value));
+}
+
+static unsigned int decode_varint(const uint8_t *&pos) {
+    unsigned int value = 0;
+    int shift = 0;
+    while (*pos & 0x80) {
+        value |= static_cast<unsigned int>(*pos & 0x7f) << shift;
+        shift += 7;
+        ++pos;
+    }
+    value |= static_cast<unsigned int>(*pos) << shift;
+    ++pos;
+    return value;
+}
+
+ApplicableOperatorsCache::ApplicableOperatorsCache(
+    const TaskProxy &task_proxy, StateRegistry &state_registry,
+    int max_memory_in_mb)
+    : incremental_generator(task_proxy),
+      successor_generator(
+          successor_generator::g_successor_generators[task_proxy]),
+      state_registry(state_registry),
+      positions(-1),
+      chunks(max_memory_in_mb),
+      current_chunk(0),
+      num_incremental(0),
+      num_full(0),
+      num_evicted_states(0),
+      memory_releaser(
+          "applicable operators cache",
+          [this]() {return get_memory_usage();},
+          [this]() {release_memory();}) {
+    assert(is_supported(task_proxy));
+    // Positions must fit into an int.
+    assert(max_memory_in_mb < (1 << (31 - CHUNK_SIZE_BITS)));
+    chunks[current_chunk].data.reserve(CHUNK_SIZE);
+}
+
+void ApplicableOperatorsCache::clear_chunk(Chunk &chunk) {
+    for (StateID id : chunk.states) {
+        positions[state_registry.lookup_state(id)] = -1;
+    }
+    num_evicted_states += chunk.states.size();
+    chunk.states.clear();
+    chunk.data.clear();
+}
+
+size_t ApplicableOperatorsCache::get_memory_usage() const {
+    size_t memory = 0;
+    for (const Chunk &chunk : chunks) {
+        memory += chunk.data.capacity() +
+            chunk.states.capacity() * sizeof(StateID);
+    }
+    return memory;
+}
+
+void ApplicableOperatorsCache::release_memory() {
+    for (Chunk &chunk : chunks) {
+        clear_chunk(chunk);
+        vector<uint8_t>().swap(chunk.data);
+        vector<StateID>().swap(chunk.states);
+    }
+    chunks.resize(max<size_t>(1, chunks.size() / 2));
+    current_chunk = 0;
+    chunks[current_chunk].data.reserve(CHUNK_SIZE);
+}
+
+void ApplicableOperatorsCache::store(const State &state, const vector<int> &ops) {
+    if (positions[state] != -1) {
+        // The state has been expanded before (e.g., after reopening it).
+        return;
+    }
+    encoded_operators.clear();
+    encode_varint(ops.size(), encoded_operators);
+    int previous_op = 0;
+    for (int op : ops) {
+        assert(op >= previous_op);
+        encode_varint(op - previous_op, encoded_operators);
+        previous_op = op;
+    }
+    if (encoded_operators.size() > CHUNK_SIZE) {
+        return;
+    }
+    Chunk *chunk = &chunks[current_chunk];
+    if (chunk->data.size() + encoded_operators.size() > CHUNK_SIZE) {
+        current_chunk = (current_chunk + 1) % chunks.size();
+        chunk = &chunks[current_chunk];
+        clear_chunk(*chunk);
+        chunk->data.reserve(CHUNK_SIZE);
+    }
+    positions[state] = (current_chunk << CHUNK_SIZE_BITS) + chunk->data.size();
+    chunk->data.insert(
+        chunk->data.end(), encoded_operators.begin(), encoded_operators.end());
+    chunk->states.push_back(state.get_id());
+}
+
+void ApplicableOperatorsCache::load(int position, vector<int> &ops) const {
+    const Chunk &chunk = chunks[position >> CHUNK_SIZE_BITS];
+    const uint8_t *pos = chunk.data.data() + (position & (CHUNK_SIZE - 1));
+    int num_ops = decode_varint(pos);
+    ops.resize(num_ops);
+    int op = 0;
+    for (int i = 0; i < num_ops; ++i) {
+        op += decode_varint(pos);
+        ops[i] = op;
+    }
+}
+
+void ApplicableOperatorsCache::generate_applicable_ops(
+    const State &state, StateID parent_id, OperatorID creating_operator,
+    vector<OperatorID> &applicable_ops) {
+    int parent_position = -1;
+    State parent_state = state;
+    if (parent_id != StateID::no_state) {
+        parent_state = state_registry.lookup_state(parent_id);
+        parent_position = positions[parent_state];
+    }
+    if (parent_position != -1) {
+        load(parent_position, parent_operators);
+        incremental_generator.generate_successor_operators(
+            parent_state, creating_operator.get_index(), state,
+            parent_operators, operators);
+        ++num_incremental;
+    } else {
+        applicable_ops.clear();
+        successor_generator.generate_applicable_ops(state, applicable_ops);
+        operators.clear();
+        for (OperatorID op_id : applicable_ops) {
+            operators.push_back(op_id.get_index());
+        }
+        sort(operators.begin(), operators.end());
+        ++num_full;
+    }
+    store(state, operators);
+    applicable_ops.clear();
+    applicable_ops.reserve(operators.size());
+    for (int op : operators) {
+        applicable_ops.emplace_back(op);
+    }
+}
+
+void ApplicableOperatorsCache::print_statistics(utils::LogProxy &log) const {
+    if (log.is_at_least_normal()) {
+        log << "Applicable operators derived from parent: " << num_incremental
+            << endl;
+        log << "Applicable operators computed from scratch: " << num_full
+            << endl;
+        log << "Applicable operators evicted from cache: "
+            << num_evicted_states << endl;
+        log << "Applicable operators cache memory: "
+            << get_memory_usage() / 1024 << " KB" << endl;
+    }
+}
+
+bool ApplicableOperatorsCache::is_supported(const TaskProxy &task_proxy) {
+    return !task_properties::has_axioms(task_proxy) &&
+           !task_properties::has_conditional_effects(task_proxy);
+}
+
+unique_ptr<ApplicableOperatorsCache> create_applicable_operators_cache(
+    const TaskProxy &task_proxy, StateRegistry &state_registry,
+    int max_memory_in_mb, utils::LogProxy &log) {
+    if (!ApplicableOperatorsCache::is_supported(task_proxy)) {
+        if (log.is_warning()) {
+            log << "Warning: incremental successor generation does not "
+                << "support axioms and conditional effects. Using the "
+                << "successor generator instead." << endl;
+        }
+        return nullptr;
+    }
+    return utils::make_unique_ptr<ApplicableOperatorsCache>(
+        task_proxy, state_registry, max_memory_in_mb);
+}
+
+void add_options_to_parser(options::OptionParser &parser) {
+    parser.add_option<bool>(
+        "incremental_successors",
+        "derive the applicable operators of each expanded state from the "
+        "cached applicable operators of its parent instead of querying the "
+        "successor generator. Operators are then generated in the order "
+        "of their IDs. Tasks with axioms or conditional effects always "
+        "use the successor generator.",
+        "false");
+    parser.add_option<int>(
+        "max_successor_cache_memory",
+        "maximum memory in MiB for caching the applicable operators of "
+        "expanded states if incremental_successors=true. When the limit "
+        "is reached, the operators of the states expanded first are "
+        "discarded.",
+        "100",
+        options::Bounds("1", "2047"));
+}
+}
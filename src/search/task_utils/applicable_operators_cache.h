@@ -0,0 +1,121 @@
+#ifndef TASK_UTILS_APPLICABLE_OPERATORS_CACHE_H
+#define TASK_UTILS_APPLICABLE_OPERATORS_CACHE_H
+
+#include "incremental_successor_generator.h"
+
+#include "../operator_id.h"
+#include "../per_state_information.h"
+
+#include "../utils/memory.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class StateRegistry;
+class TaskProxy;
+
+namespace options {
+class OptionParser;
+}
+
+namespace successor_generator {
+class SuccessorGenerator;
+}
+
+namespace utils {
+class LogProxy;
+}
+
+namespace applicable_operators_cache {
+/*
+  Derive the applicable operators of a state from the applicable
+  operators of its parent by patching them with the effects of the
+  creating operator (see
+  IncrementalSuccessorGenerator::generate_successor_operators). For this,
+  we cache the applicable operators of each state for which they are
+  generated, i.e., of each expanded state.
+
+  The operators of a state are stored as their number followed by the
+  varint-encoded gaps between increasing operator IDs, which typically
+  needs one byte per operator. The encoded lists are appended to chunks
+  of 1 MiB. When all chunks are in use, we drop the oldest chunk and
+  reuse it, i.e., we forget the operators of the states that were
+  expanded first. Under memory pressure (see utils::MemoryReleaser), we
+  forget all operators and halve the number of chunks.
+
+  Unlike the successor generator, the cache returns the operators
+  ordered by ID, so the order in which successors are generated differs
+  from searches without the cache. All states have to belong to the
+  given state registry. The cache only supports tasks without axioms and
+  conditional effects (see is_supported).
+*/
+class ApplicableOperatorsCache {
+    struct Chunk {
+        std::vector<std::uint8_t> data;
+        // States whose operators are stored in this chunk.
+        std::vector<StateID> states;
+    };
+
+    incremental_successor_generator::IncrementalSuccessorGenerator
+        incremental_generator;
+    const successor_generator::SuccessorGenerator &successor_generator;
+    StateRegistry &state_registry;
+
+    /*
+      Position of the encoded operators of each state, or -1 if they are
+      not cached. The position is the chunk index times the chunk size
+      plus the offset in the chunk.
+    */
+    PerStateInformation<int> positions;
+    std::vector<Chunk> chunks;
+    int current_chunk;
+
+    std::vector<std::uint8_t> encoded_operators;
+    std::vector<int> parent_operators;
+    std::vector<int> operators;
+
+    long long num_incremental;
+    long long num_full;
+    long long num_evicted_states;
+    utils::MemoryReleaser memory_releaser;
+
+    void clear_chunk(Chunk &chunk);
+    void store(const State &state, const std::vector<int> &ops);
+    void load(int position, std::vector<int> &ops) const;
+    std::size_t get_memory_usage() const;
+    void release_memory();
+
+public:
+    ApplicableOperatorsCache(
+        const TaskProxy &task_proxy, StateRegistry &state_registry,
+        int max_memory_in_mb);
+
+    /*
+      Generate the applicable operators of the given registered state.
+      If the parent state has cached operators, patch them with the
+      effects of creating_operator, otherwise use the successor
+      generator.
+    */
+    void generate_applicable_ops(
+        const State &state, StateID parent_id, OperatorID creating_operator,
+        std::vector<OperatorID> &applicable_ops);
+
+    void print_statistics(utils::LogProxy &log) const;
+
+    static bool is_supported(const TaskProxy &task_proxy);
+};
+
+/*
+  Return a cache for the given task and registry, or nullptr (with a
+  warning) if the task is not supported.
+*/
+extern std::unique_ptr<ApplicableOperatorsCache> create_applicable_operators_cache(
+    const TaskProxy &task_proxy, StateRegistry &state_registry,
+    int max_memory_in_mb, utils::LogProxy &log);
+
+// Add the options incremental_successors and max_successor_cache_memory.
+extern void add_options_to_parser(options::OptionParser &parser);
+}
+
+#endif
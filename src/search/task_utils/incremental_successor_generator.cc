@@ -4,9 +4,33 @@
 
 #include "../utils/logging.h"
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
 using namespace std;
 
 namespace incremental_successor_generator {
+static inline int get_packed_value(
+    const int_packer::IntPacker::Bin *buffer,
+    const int_packer::IntPacker::VariableLocation &location) {
+    return (buffer[location.bin_index] & location.read_mask) >> location.shift;
+}
+
+static array_pool_template::ArrayPool<FactPair> get_preconditions_by_operator(
+    const OperatorsProxy &ops) {
+    array_pool_template::ArrayPool<FactPair> preconditions_by_operator;
+    for (OperatorProxy op : ops) {
+        vector<FactPair> preconditions;
+        preconditions.reserve(op.get_preconditions().size());
+        for (FactProxy precondition : op.get_preconditions()) {
+            preconditions.push_back(precondition.get_pair());
+        }
+        preconditions_by_operator.push_back(move(preconditions));
+    }
+    return preconditions_by_operator;
+}
+
 static array_pool_template::ArrayPool<FactPair> get_effects_by_operator(
     const OperatorsProxy &ops) {
     array_pool_template::ArrayPool<FactPair> effects_by_operator;
@@ -28,7 +52,10 @@ static array_pool_template::ArrayPool<FactPair> get_effects_by_operator(
 }
 
 IncrementalSuccessorGenerator::IncrementalSuccessorGenerator(const TaskProxy &task_proxy)
-    : effects_by_operator(get_effects_by_operator(task_proxy.get_operators())) {
+    : effects_by_operator(get_effects_by_operator(task_proxy.get_operators())),
+      preconditions_by_operator(
+          get_preconditions_by_operator(task_proxy.get_operators())),
+      current_mark(0) {
     utils::Timer init_timer;
     int num_operators = task_proxy.get_operators().size();
     int num_facts = 0;
@@ -38,6 +65,12 @@ IncrementalSuccessorGenerator::IncrementalSuccessorGenerator(const TaskProxy &ta
     }
 
     num_unsatisfied_preconditions.resize(num_operators, 0);
+    removal_marks.resize(num_operators, 0);
+    const int_packer::IntPacker &state_packer =
+        task_properties::g_state_packers[task_proxy];
+    for (VariableProxy var : task_proxy.get_variables()) {
+        variable_locations.push_back(state_packer.get_location(var.get_id()));
+    }
     num_preconditions.reserve(num_operators);
 
     vector<vector<int>> precondition_of(num_facts);
@@ -136,6 +169,65 @@ const vector<int> &IncrementalSuccessorGenerator::get_applicable_operators() {
     return applicable_operators;
 }
 
+void IncrementalSuccessorGenerator::generate_successor_operators(
+    const State &src, int op_id, const State &succ,
+    const vector<int> &src_ops, vector<int> &succ_ops) {
+    if (current_mark == numeric_limits<int>::max()) {
+        fill(removal_marks.begin(), removal_marks.end(), 0);
+        current_mark = 0;
+    }
+    ++current_mark;
+    added_operators.clear();
+    const int_packer::IntPacker::Bin *src_buffer = src.get_buffer();
+    const int_packer::IntPacker::Bin *succ_buffer = succ.get_buffer();
+    for (FactPair new_fact : effects_by_operator[op_id]) {
+        FactPair old_fact(
+            new_fact.var,
+            get_packed_value(src_buffer, variable_locations[new_fact.var]));
+        if (old_fact == new_fact) {
+            continue;
+        }
+        for (int op : operators_by_precondition[get_fact_id(old_fact)]) {
+            removal_marks[op] = current_mark;
+        }
+        /*
+          Operators with a precondition on new_fact were not applicable
+          in src. They are applicable in succ if all their other
+          preconditions hold there, too.
+        */
+        for (int op : operators_by_precondition[get_fact_id(new_fact)]) {
+            bool applicable = true;
+            for (FactPair precondition : preconditions_by_operator[op]) {
+                if (get_packed_value(
+                        succ_buffer, variable_locations[precondition.var])
+                    != precondition.value) {
+                    applicable = false;
+                    break;
+                }
+            }
+            if (applicable) {
+                added_operators.push_back(op);
+            }
+        }
+    }
+    // Operators with preconditions on several changed facts occur repeatedly.
+    sort(added_operators.begin(), added_operators.end());
+    added_operators.erase(
+        unique(added_operators.begin(), added_operators.end()),
+        added_operators.end());
+
+    kept_operators.clear();
+    for (int op : src_ops) {
+        if (removal_marks[op] != current_mark) {
+            kept_operators.push_back(op);
+        }
+    }
+    succ_ops.clear();
+    merge(kept_operators.begin(), kept_operators.end(),
+          added_operators.begin(), added_operators.end(),
+          back_inserter(succ_ops));
+}
+
 int IncrementalSuccessorGenerator::get_fact_id(FactPair fact) const {
     return fact_id_offset[fact.var] + fact.value;
 }
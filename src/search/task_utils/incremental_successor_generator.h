@@ -2,6 +2,7 @@
 #define TASK_UTILS_INCREMENTAL_SUCCESSOR_GENERATOR_H
 
 #include "../algorithms/array_pool.h"
+#include "../algorithms/int_packer.h"
 
 #include <vector>
 
@@ -13,6 +14,7 @@ namespace incremental_successor_generator {
 class IncrementalSuccessorGenerator {
     // These members are logically const.
     array_pool_template::ArrayPool<FactPair> effects_by_operator;
+    array_pool_template::ArrayPool<FactPair> preconditions_by_operator;
     std::vector<int> fact_id_offset;
     array_pool_template::ArrayPool<int> operators_by_precondition;
     std::vector<int> num_preconditions;
@@ -23,6 +25,13 @@ class IncrementalSuccessorGenerator {
     std::vector<int> applicable_operators_position;
     std::vector<int> applicable_operators;
 
+    // Data for generate_successor_operators.
+    std::vector<int_packer::IntPacker::VariableLocation> variable_locations;
+    std::vector<int> removal_marks;
+    int current_mark;
+    std::vector<int> added_operators;
+    std::vector<int> kept_operators;
+
     int get_fact_id(FactPair fact) const;
     void switch_facts(FactPair old_fact, FactPair new_fact);
     void mark_operator_applicable(int op);
@@ -35,6 +44,20 @@ public:
     void push_transition(const State &src, int op_id);
     void pop_transition(const State &src, int op_id);
     const std::vector<int> &get_applicable_operators();
+
+    /*
+      Compute the operators applicable in the successor of src under
+      op_id from the operators src_ops applicable in src. Both src_ops
+      and succ_ops are sorted by ID. Only operators with a precondition
+      on a fact changed by op_id need to be considered. This ignores
+      effect conditions and axioms, so the task must not have them.
+      Both states must be registered since we read their packed values.
+      Unlike push_transition and pop_transition, this does not touch the
+      state set with reset_to_state.
+    */
+    void generate_successor_operators(
+        const State &src, int op_id, const State &succ,
+        const std::vector<int> &src_ops, std::vector<int> &succ_ops);
 };
 }
 
@@ -2,6 +2,7 @@
 
 #include "successor_generator.h"
 
+#include "../state_registry.h"
 #include "../task_proxy.h"
 
 #include "../task_utils/task_properties.h"
@@ -98,4 +99,33 @@ State RandomWalkSampler::sample_state(
         rng,
         is_dead_end);
 }
+
+vector<StateID> record_random_walk_states(
+    StateRegistry &state_registry,
+    const successor_generator::SuccessorGenerator &successor_generator,
+    int num_states, int max_walk_length, utils::RandomNumberGenerator &rng,
+    int &num_generated) {
+    OperatorsProxy operators = state_registry.get_task_proxy().get_operators();
+    State initial_state = state_registry.get_initial_state();
+    State state = initial_state;
+    vector<OperatorID> applicable_ops;
+    int walk_length = 0;
+    vector<StateID> recorded_states;
+    recorded_states.reserve(num_states);
+    while (static_cast<int>(recorded_states.size()) < num_states) {
+        recorded_states.push_back(state.get_id());
+        applicable_ops.clear();
+        successor_generator.generate_applicable_ops(state, applicable_ops);
+        if (applicable_ops.empty() || walk_length == max_walk_length) {
+            state = initial_state;
+            walk_length = 0;
+        } else {
+            OperatorID op_id = *rng.choose(applicable_ops);
+            state = state_registry.get_successor_state(state, operators[op_id]);
+            ++num_generated;
+            ++walk_length;
+        }
+    }
+    return recorded_states;
+}
 }
@@ -5,8 +5,10 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 class State;
+class StateRegistry;
 
 namespace successor_generator {
 class SuccessorGenerator;
@@ -50,6 +52,20 @@ public:
         int init_h,
         const DeadEndDetector &is_dead_end = [](const State &) {return false;}) const;
 };
+
+/*
+  Register num_states states visited by random walks from the initial
+  state and return their IDs in the order of the walks. Walks restart
+  from the initial state after max_walk_length steps and in states
+  without applicable operators. Duplicate states are recorded multiple
+  times. The number of generated successor states is added to
+  num_generated.
+*/
+extern std::vector<StateID> record_random_walk_states(
+    StateRegistry &state_registry,
+    const successor_generator::SuccessorGenerator &successor_generator,
+    int num_states, int max_walk_length, utils::RandomNumberGenerator &rng,
+    int &num_generated);
 }
 
 #endif
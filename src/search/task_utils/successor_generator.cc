@@ -2,22 +2,136 @@
 
 #include "successor_generator_factory.h"
 #include "successor_generator_internals.h"
+#include "task_properties.h"
 
 #include "../abstract_task.h"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace successor_generator {
+/*
+  Run the program starting at position pc. ValueGetter maps a variable
+  to its value in the state, which lets us use the same loop for
+  unpacked and packed states. The stack holds the positions at which
+  to continue after the targets of switches (see Instruction). If a
+  switch is the last instruction of a subprogram, there is nothing to
+  push. The stack is thread-local so that several threads can share
+  the successor generator.
+*/
+template<typename ValueGetter>
+static void run_program(
+    const int *program, int pc, const ValueGetter &get_value,
+    vector<OperatorID> &applicable_ops) {
+    static thread_local vector<int> stack;
+    stack.clear();
+    while (true) {
+        if (pc == END) {
+            if (stack.empty())
+                return;
+            pc = stack.back();
+            stack.pop_back();
+            continue;
+        }
+        const int *instruction = program + pc;
+        switch (instruction[0]) {
+        case VECTOR_SWITCH:
+            if (instruction[2] != END)
+                stack.push_back(instruction[2]);
+            pc = instruction[3 + get_value(instruction[1])];
+            break;
+        case SORTED_SWITCH: {
+            int value = get_value(instruction[1]);
+            int num_values = instruction[2];
+            const int *values = instruction + 4;
+            const int *values_end = values + num_values;
+            const int *pos = values;
+            // Most switches are small, so only use binary search for larger ones.
+            if (num_values > 8) {
+                pos = lower_bound(values, values_end, value);
+            } else {
+                while (pos != values_end && *pos < value) {
+                    ++pos;
+                }
+            }
+            if (pos != values_end && *pos == value) {
+                if (instruction[3] != END)
+                    stack.push_back(instruction[3]);
+                pc = pos[num_values];
+            } else {
+                pc = instruction[3];
+            }
+            break;
+        }
+        case SINGLE_SWITCH:
+            pc = get_value(instruction[1]) == instruction[2] ?
+                instruction[3] : instruction[4];
+            break;
+        case LEAF: {
+            int num_ops = instruction[1];
+            for (int i = 0; i < num_ops; ++i) {
+                applicable_ops.emplace_back(instruction[3 + i]);
+            }
+            pc = instruction[2];
+            break;
+        }
+        }
+    }
+}
+
 SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy)
     : root(SuccessorGeneratorFactory(task_proxy).create()) {
+    entry_point = root->compile(program, END);
+    program.shrink_to_fit();
+
+    const int_packer::IntPacker &state_packer =
+        task_properties::g_state_packers[task_proxy];
+    int num_variables = task_proxy.get_variables().size();
+    variable_locations.reserve(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        variable_locations.push_back(state_packer.get_location(var));
+    }
 }
 
-SuccessorGenerator::~SuccessorGenerator() = default;
+SuccessorGenerator::~SuccessorGenerator() {
+}
 
 void SuccessorGenerator::generate_applicable_ops(
     const State &state, vector<OperatorID> &applicable_ops) const {
-    state.unpack();
-    root->generate_applicable_ops(state.get_unpacked_values(), applicable_ops);
+    if (state.get_registry()) {
+        generate_applicable_ops(state.get_buffer(), applicable_ops);
+    } else {
+        generate_applicable_ops(state.get_unpacked_values(), applicable_ops);
+    }
+}
+
+void SuccessorGenerator::generate_applicable_ops(
+    const vector<int> &state_values, vector<OperatorID> &applicable_ops) const {
+    root->generate_applicable_ops(state_values, applicable_ops);
+}
+
+void SuccessorGenerator::generate_applicable_ops_with_program(
+    const vector<int> &state_values, vector<OperatorID> &applicable_ops) const {
+    const int *values = state_values.data();
+    run_program(
+        program.data(), entry_point,
+        [values](int var) {return values[var];},
+        applicable_ops);
+}
+
+void SuccessorGenerator::generate_applicable_ops(
+    const int_packer::IntPacker::Bin *buffer,
+    vector<OperatorID> &applicable_ops) const {
+    const int_packer::IntPacker::VariableLocation *locations =
+        variable_locations.data();
+    run_program(
+        program.data(), entry_point,
+        [buffer, locations](int var) {
+            const int_packer::IntPacker::VariableLocation &loc = locations[var];
+            return static_cast<int>((buffer[loc.bin_index] & loc.read_mask) >> loc.shift);
+        },
+        applicable_ops);
 }
 
 PerTaskInformation<SuccessorGenerator> g_successor_generators;
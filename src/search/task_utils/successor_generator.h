@@ -2,6 +2,7 @@
 #define TASK_UTILS_SUCCESSOR_GENERATOR_H
 
 #include "../per_task_information.h"
+#include "../algorithms/int_packer.h"
 
 #include <memory>
 #include <vector>
@@ -13,20 +14,44 @@ class TaskProxy;
 namespace successor_generator {
 class GeneratorBase;
 
+/*
+  The successor generator is built as a decision tree over the operator
+  preconditions (see SuccessorGeneratorFactory), which is additionally
+  compiled into a flat program of ints (see Instruction in
+  successor_generator_internals.h). A tight loop interprets the program
+  without virtual calls or recursion. Registered states are read by the
+  program in packed form, so they don't need to be unpacked. For
+  unpacked states, the program is slower than the tree (see
+  benchmark_successor_generator), so we use the tree for them.
+*/
 class SuccessorGenerator {
     std::unique_ptr<GeneratorBase> root;
+    std::vector<int> program;
+    int entry_point;
+    std::vector<int_packer::IntPacker::VariableLocation> variable_locations;
 
 public:
     explicit SuccessorGenerator(const TaskProxy &task_proxy);
-    /*
-      We cannot use the default destructor (implicitly or explicitly)
-      here because GeneratorBase is a forward declaration and the
-      incomplete type cannot be destroyed.
-    */
     ~SuccessorGenerator();
 
     void generate_applicable_ops(
         const State &state, std::vector<OperatorID> &applicable_ops) const;
+
+    void generate_applicable_ops(
+        const std::vector<int> &state_values,
+        std::vector<OperatorID> &applicable_ops) const;
+    void generate_applicable_ops(
+        const int_packer::IntPacker::Bin *buffer,
+        std::vector<OperatorID> &applicable_ops) const;
+
+    // Run the compiled program on unpacked values (only for benchmarking).
+    void generate_applicable_ops_with_program(
+        const std::vector<int> &state_values,
+        std::vector<OperatorID> &applicable_ops) const;
+
+    int get_program_size() const {
+        return program.size();
+    }
 };
 
 extern PerTaskInformation<SuccessorGenerator> g_successor_generators;
@@ -2,6 +2,7 @@
 
 #include "../task_proxy.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
@@ -37,6 +38,12 @@ using namespace std;
     - single leaf: [SINGLE_LEAF, op_id]
     - vector leaf: [VECTOR_LEAF, n, op_id_1, ..., op_id_n]
 
+    SuccessorGenerator now uses a variant of this representation in
+    which instructions store their continuation instead of forks
+    listing their children (see Instruction in the header) for packed
+    states. It keeps the tree nodes for unpacked states, since they
+    are faster there, so we pay for both representations in memory.
+
     We could compact this further by permitting to use operator IDs
     directly wherever child nodes are used, by using e.g. negative
     numbers for operatorIDs and positive numbers for node IDs,
@@ -86,6 +93,10 @@ void GeneratorForkBinary::generate_applicable_ops(
     generator2->generate_applicable_ops(state, applicable_ops);
 }
 
+int GeneratorForkBinary::compile(vector<int> &program, int next) const {
+    return generator1->compile(program, generator2->compile(program, next));
+}
+
 GeneratorForkMulti::GeneratorForkMulti(vector<unique_ptr<GeneratorBase>> children)
     : children(move(children)) {
     /* Note that we permit 0-ary forks as a way to define empty
@@ -101,6 +112,14 @@ void GeneratorForkMulti::generate_applicable_ops(
         generator->generate_applicable_ops(state, applicable_ops);
 }
 
+int GeneratorForkMulti::compile(vector<int> &program, int next) const {
+    // Chain the children back to front. Empty forks just continue at next.
+    for (auto it = children.rbegin(); it != children.rend(); ++it) {
+        next = (*it)->compile(program, next);
+    }
+    return next;
+}
+
 GeneratorSwitchVector::GeneratorSwitchVector(
     int switch_var_id, vector<unique_ptr<GeneratorBase>> &&generator_for_value)
     : switch_var_id(switch_var_id),
@@ -116,6 +135,20 @@ void GeneratorSwitchVector::generate_applicable_ops(
     }
 }
 
+int GeneratorSwitchVector::compile(vector<int> &program, int next) const {
+    vector<int> targets;
+    targets.reserve(generator_for_value.size());
+    for (const unique_ptr<GeneratorBase> &generator : generator_for_value) {
+        targets.push_back(generator ? generator->compile(program, END) : END);
+    }
+    int start = program.size();
+    program.push_back(VECTOR_SWITCH);
+    program.push_back(switch_var_id);
+    program.push_back(next);
+    program.insert(program.end(), targets.begin(), targets.end());
+    return start;
+}
+
 GeneratorSwitchHash::GeneratorSwitchHash(
     int switch_var_id,
     unordered_map<int, unique_ptr<GeneratorBase>> &&generator_for_value)
@@ -133,6 +166,29 @@ void GeneratorSwitchHash::generate_applicable_ops(
     }
 }
 
+int GeneratorSwitchHash::compile(vector<int> &program, int next) const {
+    vector<pair<int, int>> targets;
+    targets.reserve(generator_for_value.size());
+    for (const auto &value_and_generator : generator_for_value) {
+        targets.emplace_back(
+            value_and_generator.first,
+            value_and_generator.second->compile(program, END));
+    }
+    sort(targets.begin(), targets.end());
+    int start = program.size();
+    program.push_back(SORTED_SWITCH);
+    program.push_back(switch_var_id);
+    program.push_back(targets.size());
+    program.push_back(next);
+    for (const pair<int, int> &target : targets) {
+        program.push_back(target.first);
+    }
+    for (const pair<int, int> &target : targets) {
+        program.push_back(target.second);
+    }
+    return start;
+}
+
 GeneratorSwitchSingle::GeneratorSwitchSingle(
     int switch_var_id, int value, unique_ptr<GeneratorBase> generator_for_value)
     : switch_var_id(switch_var_id),
@@ -147,6 +203,17 @@ void GeneratorSwitchSingle::generate_applicable_ops(
     }
 }
 
+int GeneratorSwitchSingle::compile(vector<int> &program, int next) const {
+    int target = generator_for_value->compile(program, next);
+    int start = program.size();
+    program.push_back(SINGLE_SWITCH);
+    program.push_back(switch_var_id);
+    program.push_back(value);
+    program.push_back(target);
+    program.push_back(next);
+    return start;
+}
+
 GeneratorLeafVector::GeneratorLeafVector(vector<OperatorID> &&applicable_operators)
     : applicable_operators(move(applicable_operators)) {
 }
@@ -165,6 +232,17 @@ void GeneratorLeafVector::generate_applicable_ops(
     }
 }
 
+int GeneratorLeafVector::compile(vector<int> &program, int next) const {
+    int start = program.size();
+    program.push_back(LEAF);
+    program.push_back(applicable_operators.size());
+    program.push_back(next);
+    for (OperatorID id : applicable_operators) {
+        program.push_back(id.get_index());
+    }
+    return start;
+}
+
 GeneratorLeafSingle::GeneratorLeafSingle(OperatorID applicable_operator)
     : applicable_operator(applicable_operator) {
 }
@@ -173,4 +251,13 @@ void GeneratorLeafSingle::generate_applicable_ops(
     const vector<int> &, vector<OperatorID> &applicable_ops) const {
     applicable_ops.push_back(applicable_operator);
 }
+
+int GeneratorLeafSingle::compile(vector<int> &program, int next) const {
+    int start = program.size();
+    program.push_back(LEAF);
+    program.push_back(1);
+    program.push_back(next);
+    program.push_back(applicable_operator.get_index());
+    return start;
+}
 }
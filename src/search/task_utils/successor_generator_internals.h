@@ -10,12 +10,51 @@
 class State;
 
 namespace successor_generator {
+/*
+  Instructions of the compiled successor generator (see
+  SuccessorGenerator). Every instruction stores the position of the
+  instruction that is executed after it ("next"). Forks are compiled
+  away by chaining their children through these positions. END ends the
+  current subprogram.
+
+  VECTOR_SWITCH: [VECTOR_SWITCH, var, next, target_0, ..., target_{k-1}]
+  SORTED_SWITCH: [SORTED_SWITCH, var, n, next, value_1, ..., value_n,
+                  target_1, ..., target_n] with increasing values
+  SINGLE_SWITCH: [SINGLE_SWITCH, var, value, target, next]
+  LEAF:          [LEAF, n, next, op_1, ..., op_n]
+
+  The targets of VECTOR_SWITCH and SORTED_SWITCH are subprograms that end
+  with END. Before jumping to a target, the interpreter pushes next on a
+  stack and continues there when reaching END. This way, the position
+  of the next instruction never depends on the value of the switch
+  variable, which lets the processor overlap the evaluation of
+  consecutive switches. (Chaining the targets to next directly turned
+  out to be considerably slower.) Values without target map to END. The
+  target of SINGLE_SWITCH is known in advance, so it continues at next
+  directly.
+*/
+enum Instruction {
+    VECTOR_SWITCH,
+    SORTED_SWITCH,
+    SINGLE_SWITCH,
+    LEAF
+};
+
+const int END = -1;
+
 class GeneratorBase {
 public:
     virtual ~GeneratorBase() {}
 
     virtual void generate_applicable_ops(
         const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const = 0;
+
+    /*
+      Append the instructions for this generator to the program and
+      return the position at which they start. After the generator has
+      produced its operators, execution continues at position next.
+    */
+    virtual int compile(std::vector<int> &program, int next) const = 0;
 };
 
 class GeneratorForkBinary : public GeneratorBase {
@@ -27,6 +66,7 @@ public:
         std::unique_ptr<GeneratorBase> generator2);
     virtual void generate_applicable_ops(
         const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
+    virtual int compile(std::vector<int> &program, int next) const override;
 };
 
 class GeneratorForkMulti : public GeneratorBase {
@@ -35,6 +75,7 @@ public:
     GeneratorForkMulti(std::vector<std::unique_ptr<GeneratorBase>> children);
     virtual void generate_applicable_ops(
         const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
+    virtual int compile(std::vector<int> &program, int next) const override;
 };
 
 class GeneratorSwitchVector : public GeneratorBase {
@@ -46,6 +87,7 @@ public:
         std::vector<std::unique_ptr<GeneratorBase>> &&generator_for_value);
     virtual void generate_applicable_ops(
         const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
+    virtual int compile(std::vector<int> &program, int next) const override;
 };
 
 class GeneratorSwitchHash : public GeneratorBase {
@@ -57,6 +99,7 @@ public:
         std::unordered_map<int, std::unique_ptr<GeneratorBase>> &&generator_for_value);
     virtual void generate_applicable_ops(
         const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
+    virtual int compile(std::vector<int> &program, int next) const override;
 };
 
 class GeneratorSwitchSingle : public GeneratorBase {
@@ -69,6 +112,7 @@ public:
         std::unique_ptr<GeneratorBase> generator_for_value);
     virtual void generate_applicable_ops(
         const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
+    virtual int compile(std::vector<int> &program, int next) const override;
 };
 
 class GeneratorLeafVector : public GeneratorBase {
@@ -77,6 +121,7 @@ public:
     GeneratorLeafVector(std::vector<OperatorID> &&applicable_operators);
     virtual void generate_applicable_ops(
         const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
+    virtual int compile(std::vector<int> &program, int next) const override;
 };
 
 class GeneratorLeafSingle : public GeneratorBase {
@@ -85,6 +130,7 @@ public:
     GeneratorLeafSingle(OperatorID applicable_operator);
     virtual void generate_applicable_ops(
         const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
+    virtual int compile(std::vector<int> &program, int next) const override;
 };
 }
 
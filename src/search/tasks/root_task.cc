@@ -22,6 +22,31 @@ namespace tasks {
 static const int PRE_FILE_VERSION = 3;
 shared_ptr<AbstractTask> g_root_task = nullptr;
 
+/*
+  Reads translator output files in the textual format or in the binary
+  format written by the translator with --binary-sas (and by
+  preprocess-h2, see src/preprocess_h2/sas_io.h). A binary file starts with
+  the bytes "\0SAS" and contains the same sequence of values as the textual
+  format without the magic words. Integers are zigzag-encoded base-128
+  varints and strings are stored as their length followed by the
+  characters.
+*/
+class TaskInput {
+    istream &in;
+    bool binary;
+
+    int read_varint();
+public:
+    explicit TaskInput(istream &in);
+
+    void check_magic(const string &magic);
+    int read_int();
+    // Read a whitespace-free word.
+    string read_word();
+    // Read the rest of the line (skipping leading whitespace).
+    string read_line();
+};
+
 struct ExplicitVariable {
     int domain_size;
     string name;
@@ -29,7 +54,7 @@ struct ExplicitVariable {
     int axiom_layer;
     int axiom_default_value;
 
-    explicit ExplicitVariable(istream &in);
+    explicit ExplicitVariable(TaskInput &in);
 };
 
 
@@ -48,8 +73,8 @@ struct ExplicitOperator {
     string name;
     bool is_an_axiom;
 
-    void read_pre_post(istream &in);
-    ExplicitOperator(istream &in, bool is_an_axiom, bool use_metric);
+    void read_pre_post(TaskInput &in);
+    ExplicitOperator(TaskInput &in, bool is_an_axiom, bool use_metric);
 };
 
 
@@ -67,7 +92,7 @@ class RootTask : public AbstractTask {
     const ExplicitOperator &get_operator_or_axiom(int index, bool is_axiom) const;
 
 public:
-    explicit RootTask(istream &in);
+    explicit RootTask(TaskInput &in);
 
     virtual int get_num_variables() const override;
     virtual string get_variable_name(int var) const override;
@@ -136,7 +161,68 @@ static void check_facts(const ExplicitOperator &action, const vector<ExplicitVar
     }
 }
 
-void check_magic(istream &in, const string &magic) {
+TaskInput::TaskInput(istream &in)
+    : in(in),
+      binary(in.peek() == '\0') {
+    if (binary) {
+        char magic[4];
+        in.read(magic, 4);
+        if (!in || string(magic, 4) != string("\0SAS", 4)) {
+            cerr << "Failed to read binary translator output file header." << endl;
+            utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+        }
+    }
+}
+
+int TaskInput::read_varint() {
+    unsigned int value = 0;
+    for (int shift = 0;; shift += 7) {
+        int byte = in.get();
+        if (byte == EOF || shift > 28) {
+            cerr << "Unexpected end of binary translator output file." << endl;
+            utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+        }
+        value |= static_cast<unsigned int>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            break;
+    }
+    // Undo the zigzag encoding.
+    return static_cast<int>(value >> 1) ^ -static_cast<int>(value & 1);
+}
+
+int TaskInput::read_int() {
+    if (binary)
+        return read_varint();
+    int value;
+    in >> value;
+    return value;
+}
+
+string TaskInput::read_word() {
+    if (binary)
+        return read_line();
+    string word;
+    in >> word;
+    return word;
+}
+
+string TaskInput::read_line() {
+    string line;
+    if (binary) {
+        int length = read_varint();
+        line.resize(length);
+        if (length > 0)
+            in.read(&line[0], length);
+    } else {
+        in >> ws;
+        getline(in, line);
+    }
+    return line;
+}
+
+void TaskInput::check_magic(const string &magic) {
+    if (binary)
+        return;
     string word;
     in >> word;
     if (word != magic) {
@@ -151,29 +237,27 @@ void check_magic(istream &in, const string &magic) {
     }
 }
 
-vector<FactPair> read_facts(istream &in) {
-    int count;
-    in >> count;
+vector<FactPair> read_facts(TaskInput &in) {
+    int count = in.read_int();
     vector<FactPair> conditions;
     conditions.reserve(count);
     for (int i = 0; i < count; ++i) {
-        FactPair condition = FactPair::no_fact;
-        in >> condition.var >> condition.value;
-        conditions.push_back(condition);
+        int var = in.read_int();
+        int value = in.read_int();
+        conditions.emplace_back(var, value);
     }
     return conditions;
 }
 
-ExplicitVariable::ExplicitVariable(istream &in) {
-    check_magic(in, "begin_variable");
-    in >> name;
-    in >> axiom_layer;
-    in >> domain_size;
-    in >> ws;
+ExplicitVariable::ExplicitVariable(TaskInput &in) {
+    in.check_magic("begin_variable");
+    name = in.read_word();
+    axiom_layer = in.read_int();
+    domain_size = in.read_int();
     fact_names.resize(domain_size);
     for (int i = 0; i < domain_size; ++i)
-        getline(in, fact_names[i]);
-    check_magic(in, "end_variable");
+        fact_names[i] = in.read_line();
+    in.check_magic("end_variable");
 }
 
 
@@ -183,49 +267,46 @@ ExplicitEffect::ExplicitEffect(
 }
 
 
-void ExplicitOperator::read_pre_post(istream &in) {
+void ExplicitOperator::read_pre_post(TaskInput &in) {
     vector<FactPair> conditions = read_facts(in);
-    int var, value_pre, value_post;
-    in >> var >> value_pre >> value_post;
+    int var = in.read_int();
+    int value_pre = in.read_int();
+    int value_post = in.read_int();
     if (value_pre != -1) {
         preconditions.emplace_back(var, value_pre);
     }
     effects.emplace_back(var, value_post, move(conditions));
 }
 
-ExplicitOperator::ExplicitOperator(istream &in, bool is_an_axiom, bool use_metric)
+ExplicitOperator::ExplicitOperator(TaskInput &in, bool is_an_axiom, bool use_metric)
     : is_an_axiom(is_an_axiom) {
     if (!is_an_axiom) {
-        check_magic(in, "begin_operator");
-        in >> ws;
-        getline(in, name);
+        in.check_magic("begin_operator");
+        name = in.read_line();
         preconditions = read_facts(in);
-        int count;
-        in >> count;
+        int count = in.read_int();
         effects.reserve(count);
         for (int i = 0; i < count; ++i) {
             read_pre_post(in);
         }
 
-        int op_cost;
-        in >> op_cost;
+        int op_cost = in.read_int();
         cost = use_metric ? op_cost : 1;
-        check_magic(in, "end_operator");
+        in.check_magic("end_operator");
     } else {
         name = "<axiom>";
         cost = 0;
-        check_magic(in, "begin_rule");
+        in.check_magic("begin_rule");
         read_pre_post(in);
-        check_magic(in, "end_rule");
+        in.check_magic("end_rule");
     }
     assert(cost >= 0);
 }
 
-void read_and_verify_version(istream &in) {
-    int version;
-    check_magic(in, "begin_version");
-    in >> version;
-    check_magic(in, "end_version");
+void read_and_verify_version(TaskInput &in) {
+    in.check_magic("begin_version");
+    int version = in.read_int();
+    in.check_magic("end_version");
     if (version != PRE_FILE_VERSION) {
         cerr << "Expected translator output file version " << PRE_FILE_VERSION
              << ", got " << version << "." << endl
@@ -234,17 +315,15 @@ void read_and_verify_version(istream &in) {
     }
 }
 
-bool read_metric(istream &in) {
-    bool use_metric;
-    check_magic(in, "begin_metric");
-    in >> use_metric;
-    check_magic(in, "end_metric");
+bool read_metric(TaskInput &in) {
+    in.check_magic("begin_metric");
+    bool use_metric = in.read_int();
+    in.check_magic("end_metric");
     return use_metric;
 }
 
-vector<ExplicitVariable> read_variables(istream &in) {
-    int count;
-    in >> count;
+vector<ExplicitVariable> read_variables(TaskInput &in) {
+    int count = in.read_int();
     vector<ExplicitVariable> variables;
     variables.reserve(count);
     for (int i = 0; i < count; ++i) {
@@ -253,13 +332,12 @@ vector<ExplicitVariable> read_variables(istream &in) {
     return variables;
 }
 
-vector<vector<set<FactPair>>> read_mutexes(istream &in, const vector<ExplicitVariable> &variables) {
+vector<vector<set<FactPair>>> read_mutexes(TaskInput &in, const vector<ExplicitVariable> &variables) {
     vector<vector<set<FactPair>>> inconsistent_facts(variables.size());
     for (size_t i = 0; i < variables.size(); ++i)
         inconsistent_facts[i].resize(variables[i].domain_size);
 
-    int num_mutex_groups;
-    in >> num_mutex_groups;
+    int num_mutex_groups = in.read_int();
 
     /*
       NOTE: Mutex groups can overlap, in which case the same mutex
@@ -269,18 +347,9 @@ vector<vector<set<FactPair>>> read_mutexes(istream &in, const vector<ExplicitVar
       aware of.
     */
     for (int i = 0; i < num_mutex_groups; ++i) {
-        check_magic(in, "begin_mutex_group");
-        int num_facts;
-        in >> num_facts;
-        vector<FactPair> invariant_group;
-        invariant_group.reserve(num_facts);
-        for (int j = 0; j < num_facts; ++j) {
-            int var;
-            int value;
-            in >> var >> value;
-            invariant_group.emplace_back(var, value);
-        }
-        check_magic(in, "end_mutex_group");
+        in.check_magic("begin_mutex_group");
+        vector<FactPair> invariant_group = read_facts(in);
+        in.check_magic("end_mutex_group");
         for (const FactPair &fact1 : invariant_group) {
             for (const FactPair &fact2 : invariant_group) {
                 if (fact1.var != fact2.var) {
@@ -302,10 +371,10 @@ vector<vector<set<FactPair>>> read_mutexes(istream &in, const vector<ExplicitVar
     return inconsistent_facts;
 }
 
-vector<FactPair> read_goal(istream &in) {
-    check_magic(in, "begin_goal");
+vector<FactPair> read_goal(TaskInput &in) {
+    in.check_magic("begin_goal");
     vector<FactPair> goals = read_facts(in);
-    check_magic(in, "end_goal");
+    in.check_magic("end_goal");
     if (goals.empty()) {
         cerr << "Task has no goal condition!" << endl;
         utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
@@ -314,10 +383,9 @@ vector<FactPair> read_goal(istream &in) {
 }
 
 vector<ExplicitOperator> read_actions(
-    istream &in, bool is_axiom, bool use_metric,
+    TaskInput &in, bool is_axiom, bool use_metric,
     const vector<ExplicitVariable> &variables) {
-    int count;
-    in >> count;
+    int count = in.read_int();
     vector<ExplicitOperator> actions;
     actions.reserve(count);
     for (int i = 0; i < count; ++i) {
@@ -327,7 +395,7 @@ vector<ExplicitOperator> read_actions(
     return actions;
 }
 
-RootTask::RootTask(istream &in) {
+RootTask::RootTask(TaskInput &in) {
     read_and_verify_version(in);
     bool use_metric = read_metric(in);
     variables = read_variables(in);
@@ -336,11 +404,11 @@ RootTask::RootTask(istream &in) {
     mutexes = read_mutexes(in, variables);
 
     initial_state_values.resize(num_variables);
-    check_magic(in, "begin_state");
+    in.check_magic("begin_state");
     for (int i = 0; i < num_variables; ++i) {
-        in >> initial_state_values[i];
+        initial_state_values[i] = in.read_int();
     }
-    check_magic(in, "end_state");
+    in.check_magic("end_state");
 
     for (int i = 0; i < num_variables; ++i) {
         variables[i].axiom_default_value = initial_state_values[i];
@@ -505,7 +573,8 @@ bool RootTask::does_convert_ancestor_state_values(
 
 void read_root_task(istream &in) {
     assert(!g_root_task);
-    g_root_task = make_shared<RootTask>(in);
+    TaskInput task_input(in);
+    g_root_task = make_shared<RootTask>(task_input);
 }
 
 static shared_ptr<AbstractTask> _parse(OptionParser &parser) {
@@ -1,9 +1,13 @@
 #include "memory.h"
 
-#include "../utils/logging.h"
+#include "logging.h"
+#include "system.h"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -35,4 +39,88 @@ void release_extra_memory_padding() {
 bool extra_memory_padding_is_reserved() {
     return extra_memory_padding;
 }
+
+static const double MEMORY_PRESSURE_THRESHOLD = 0.9;
+// Read the memory usage at most every 128 calls and every 0.1 seconds.
+static const int CHECK_INTERVAL_CALLS = 128;
+static const double CHECK_INTERVAL_SECONDS = 0.1;
+
+static vector<const MemoryReleaser *> memory_releasers;
+static bool memory_limit_initialized = false;
+static long long memory_limit_in_kb = -1;
+static long long memory_pressure_threshold_in_kb = -1;
+static int num_calls_since_check = 0;
+static chrono::steady_clock::time_point last_check_time;
+
+static void set_memory_limit_in_kb(long long limit_in_kb) {
+    memory_limit_initialized = true;
+    memory_limit_in_kb = limit_in_kb;
+    memory_pressure_threshold_in_kb = -1;
+    if (memory_limit_in_kb != -1) {
+        memory_pressure_threshold_in_kb =
+            memory_limit_in_kb * MEMORY_PRESSURE_THRESHOLD;
+    }
+}
+
+MemoryReleaser::MemoryReleaser(
+    const string &name,
+    const function<size_t()> &get_memory_usage,
+    const function<void()> &release_memory)
+    : name(name),
+      get_memory_usage_func(get_memory_usage),
+      release_memory_func(release_memory) {
+    memory_releasers.push_back(this);
+}
+
+MemoryReleaser::~MemoryReleaser() {
+    memory_releasers.erase(
+        remove(memory_releasers.begin(), memory_releasers.end(), this),
+        memory_releasers.end());
+}
+
+static void release_memory(long long memory_in_kb) {
+    g_log << "Memory pressure: using " << memory_in_kb << " KB of "
+          << memory_limit_in_kb << " KB." << endl;
+    vector<pair<size_t, const MemoryReleaser *>> releasers;
+    for (const MemoryReleaser *releaser : memory_releasers) {
+        releasers.emplace_back(releaser->get_memory_usage(), releaser);
+    }
+    sort(releasers.begin(), releasers.end(),
+         [](const pair<size_t, const MemoryReleaser *> &lhs,
+            const pair<size_t, const MemoryReleaser *> &rhs) {
+             return lhs.first > rhs.first;
+         });
+    for (const auto &entry : releasers) {
+        const MemoryReleaser *releaser = entry.second;
+        releaser->release_memory();
+        g_log << "Released memory of " << releaser->get_name() << ": "
+              << entry.first / 1024 << " KB -> "
+              << releaser->get_memory_usage() / 1024 << " KB" << endl;
+    }
+    memory_pressure_threshold_in_kb =
+        memory_in_kb + (memory_limit_in_kb - memory_in_kb) / 2;
+}
+
+void check_memory_pressure() {
+    if (memory_releasers.empty() || ++num_calls_since_check < CHECK_INTERVAL_CALLS) {
+        return;
+    }
+    num_calls_since_check = 0;
+    if (!memory_limit_initialized) {
+        set_memory_limit_in_kb(get_address_space_limit_in_kb());
+    }
+    if (memory_limit_in_kb == -1) {
+        return;
+    }
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    if (chrono::duration<double>(now - last_check_time).count() <
+        CHECK_INTERVAL_SECONDS) {
+        return;
+    }
+    last_check_time = now;
+    long long memory_in_kb = get_address_space_in_kb();
+    if (memory_in_kb >= memory_pressure_threshold_in_kb) {
+        release_memory(memory_in_kb);
+    }
+}
 }
@@ -1,7 +1,10 @@
 #ifndef UTILS_MEMORY_H
 #define UTILS_MEMORY_H
 
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <string>
 #include <utility>
 
 namespace utils {
@@ -28,6 +31,48 @@ std::unique_ptr<T> make_unique_ptr(Args && ... args) {
 extern void reserve_extra_memory_padding(int memory_in_mb);
 extern void release_extra_memory_padding();
 extern bool extra_memory_padding_is_reserved();
+
+/*
+  Memory pressure service: subsystems that hold memory which they can
+  give back without affecting correctness (e.g., caches) create a
+  MemoryReleaser, which reports their memory usage and frees memory on
+  request. The releaser is unregistered when it is destroyed.
+
+  The search calls check_memory_pressure() after each step. Once the
+  address space of the process exceeds 90% of the memory limit, we call
+  the release functions of all releasers, starting with the one using the
+  most memory. Afterwards, we only react again when the process reaches
+  half of the remaining distance to the limit. The service is not
+  thread-safe and does nothing without a memory limit.
+*/
+class MemoryReleaser {
+    const std::string name;
+    const std::function<std::size_t()> get_memory_usage_func;
+    const std::function<void()> release_memory_func;
+public:
+    MemoryReleaser(const std::string &name,
+                   const std::function<std::size_t()> &get_memory_usage,
+                   const std::function<void()> &release_memory);
+    ~MemoryReleaser();
+
+    MemoryReleaser(const MemoryReleaser &) = delete;
+    MemoryReleaser &operator=(const MemoryReleaser &) = delete;
+
+    const std::string &get_name() const {
+        return name;
+    }
+
+    // Return the number of bytes that release_memory() can free.
+    std::size_t get_memory_usage() const {
+        return get_memory_usage_func();
+    }
+
+    void release_memory() const {
+        release_memory_func();
+    }
+};
+
+extern void check_memory_pressure();
 }
 
 #endif
@@ -0,0 +1,60 @@
+#include "parallel.h"
+
+#include "../options/option_parser.h"
+
+#include <cassert>
+#include <thread>
+
+using namespace std;
+
+namespace utils {
+void parallel_for(
+    int num_threads, int begin, int end,
+    const function<void(int, int, int)> &func) {
+    assert(num_threads >= 1);
+    int size = end - begin;
+    if (size <= 0) {
+        return;
+    }
+    num_threads = min(num_threads, size);
+    if (num_threads == 1) {
+        func(0, begin, end);
+        return;
+    }
+    auto chunk_begin = [&](int thread_id) {
+            return begin + static_cast<int>(
+                static_cast<long long>(size) * thread_id / num_threads);
+        };
+    vector<thread> workers;
+    workers.reserve(num_threads - 1);
+    for (int thread_id = 1; thread_id < num_threads; ++thread_id) {
+        workers.emplace_back(
+            func, thread_id, chunk_begin(thread_id), chunk_begin(thread_id + 1));
+    }
+    func(0, chunk_begin(0), chunk_begin(1));
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+int get_num_hardware_threads() {
+    return max(1u, thread::hardware_concurrency());
+}
+
+void add_threads_option(options::OptionParser &parser) {
+    parser.add_option<int>(
+        "threads",
+        "number of threads. Use 1 for the sequential algorithm and 0 for "
+        "using all available hardware threads.",
+        "1",
+        options::Bounds("0", "infinity"));
+}
+
+int parse_num_threads(const options::Options &opts) {
+    int threads = opts.get<int>("threads");
+    if (threads == 0) {
+        return get_num_hardware_threads();
+    }
+    return threads;
+}
+}
@@ -0,0 +1,99 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace utils {
+/*
+  Split the range [begin, end) into at most num_threads contiguous chunks of
+  (almost) equal size and call func(thread_id, chunk_begin, chunk_end) for
+  each chunk. Chunk 0 is processed by the calling thread, all other chunks
+  by freshly spawned worker threads. The function returns after all chunks
+  have been processed.
+
+  Chunks are assigned deterministically, so callers that write their
+  results into thread-local buffers indexed by thread_id and combine them
+  in order of increasing thread_id obtain results that don't depend on the
+  scheduling of the threads.
+
+  With num_threads == 1 (or small ranges) no threads are spawned.
+*/
+extern void parallel_for(
+    int num_threads, int begin, int end,
+    const std::function<void(int, int, int)> &func);
+
+/*
+  Sort the given vector with up to num_threads threads: each thread sorts a
+  contiguous chunk, then neighbouring chunks are merged pairwise in
+  parallel. For a strict weak order that is total on the elements (i.e., no
+  two distinct elements compare equal) the result equals that of std::sort.
+*/
+template<typename T, typename Compare>
+void parallel_sort(std::vector<T> &vec, int num_threads, Compare comp) {
+    int size = vec.size();
+    num_threads = std::max(1, std::min(num_threads, size));
+    if (num_threads == 1) {
+        std::sort(vec.begin(), vec.end(), comp);
+        return;
+    }
+    std::vector<int> bounds(num_threads + 1);
+    for (int i = 0; i <= num_threads; ++i) {
+        bounds[i] = static_cast<long long>(size) * i / num_threads;
+    }
+    parallel_for(num_threads, 0, num_threads,
+                 [&](int, int first, int last) {
+                     for (int chunk = first; chunk < last; ++chunk) {
+                         std::sort(vec.begin() + bounds[chunk],
+                                   vec.begin() + bounds[chunk + 1], comp);
+                     }
+                 });
+    while (bounds.size() > 2) {
+        int num_pairs = (bounds.size() - 1) / 2;
+        parallel_for(num_pairs, 0, num_pairs,
+                     [&](int, int first, int last) {
+                         for (int pair = first; pair < last; ++pair) {
+                             std::inplace_merge(
+                                 vec.begin() + bounds[2 * pair],
+                                 vec.begin() + bounds[2 * pair + 1],
+                                 vec.begin() + bounds[2 * pair + 2], comp);
+                         }
+                     });
+        std::vector<int> merged_bounds;
+        for (size_t i = 0; i < bounds.size(); i += 2) {
+            merged_bounds.push_back(bounds[i]);
+        }
+        if (merged_bounds.back() != bounds.back()) {
+            merged_bounds.push_back(bounds.back());
+        }
+        bounds.swap(merged_bounds);
+    }
+}
+
+template<typename T>
+void parallel_sort(std::vector<T> &vec, int num_threads) {
+    parallel_sort(vec, num_threads, std::less<T>());
+}
+
+/*
+  Return the number of hardware threads, or 1 if it cannot be determined.
+*/
+extern int get_num_hardware_threads();
+
+// Add "threads" option to parser. Only use together with parse_num_threads().
+extern void add_threads_option(options::OptionParser &parser);
+
+/*
+  Return the number of threads requested by the user: 1 (the default) keeps
+  the sequential behavior, 0 stands for all hardware threads.
+*/
+extern int parse_num_threads(const options::Options &opts);
+}
+
+#endif
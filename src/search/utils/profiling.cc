@@ -0,0 +1,172 @@
+#include "profiling.h"
+
+#include "logging.h"
+#include "memory.h"
+#include "strings.h"
+#include "system.h"
+#include "timer.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+using namespace std;
+
+namespace utils {
+bool g_profiling_enabled = false;
+
+// Check whether a snapshot is due at most every 128 calls.
+static const int SNAPSHOT_CHECK_INTERVAL_CALLS = 128;
+
+static string profile_filename;
+static int snapshot_interval_in_seconds = 0;
+static int num_calls_since_snapshot_check = 0;
+static chrono::steady_clock::time_point last_snapshot_time;
+static chrono::steady_clock::time_point start_time;
+static uint64_t start_ticks = 0;
+static int num_snapshots = 0;
+
+static map<pair<string, string>, unique_ptr<ProfileEntry>> &get_profile_entries() {
+    static map<pair<string, string>, unique_ptr<ProfileEntry>> entries;
+    return entries;
+}
+
+// Remove the keyword of plugins passed as keyword arguments ("h = ff").
+static string strip_keyword(const string &plugin) {
+    size_t pos = plugin.find(" = ");
+    if (pos != string::npos && plugin.find('(') > pos) {
+        return plugin.substr(pos + 3);
+    }
+    return plugin;
+}
+
+ProfileEntry *register_profile_entry(const string &plugin_, const string &name) {
+    string plugin = strip_keyword(plugin_);
+    unique_ptr<ProfileEntry> &entry = get_profile_entries()[make_pair(plugin, name)];
+    if (!entry) {
+        entry = make_unique_ptr<ProfileEntry>(plugin, name);
+    }
+    return entry.get();
+}
+
+void enable_profiling(const string &filename, int interval_in_seconds) {
+    g_profiling_enabled = true;
+    profile_filename = filename;
+    snapshot_interval_in_seconds = interval_in_seconds;
+    start_time = chrono::steady_clock::now();
+    last_snapshot_time = start_time;
+    start_ticks = read_time_stamp_counter();
+}
+
+static double get_ticks_per_second() {
+    double seconds = chrono::duration<double>(
+        chrono::steady_clock::now() - start_time).count();
+    uint64_t ticks = read_time_stamp_counter() - start_ticks;
+    return (seconds > 0 && ticks > 0) ? ticks / seconds : 1e9;
+}
+
+static string escape_json(const string &s) {
+    string result;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            result += ' ';
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+static string escape_csv(const string &s) {
+    string result = "\"";
+    for (char c : s) {
+        if (c == '"') {
+            result += '"';
+        }
+        result += c;
+    }
+    return result + "\"";
+}
+
+static void write_json(ostream &out, bool is_final, double ticks_per_second) {
+    out << "{" << endl;
+    out << "  \"final\": " << (is_final ? "true" : "false") << "," << endl;
+    out << "  \"time\": " << static_cast<double>(g_timer()) << "," << endl;
+    out << "  \"ticks_per_second\": " << ticks_per_second << "," << endl;
+    out << "  \"entries\": [";
+    bool first = true;
+    for (const auto &item : get_profile_entries()) {
+        const ProfileEntry &entry = *item.second;
+        out << (first ? "" : ",") << endl;
+        out << "    {\"plugin\": \"" << escape_json(entry.plugin)
+            << "\", \"name\": \"" << escape_json(entry.name)
+            << "\", \"count\": " << entry.count
+            << ", \"seconds\": " << entry.ticks / ticks_per_second << "}";
+        first = false;
+    }
+    out << endl << "  ]" << endl << "}" << endl;
+}
+
+static void write_csv(ostream &out, double ticks_per_second) {
+    out << "plugin,name,count,seconds" << endl;
+    for (const auto &item : get_profile_entries()) {
+        const ProfileEntry &entry = *item.second;
+        out << escape_csv(entry.plugin) << "," << escape_csv(entry.name) << ","
+            << entry.count << "," << entry.ticks / ticks_per_second << endl;
+    }
+}
+
+static void write_report(bool is_final) {
+    /*
+      Write to a temporary file and rename it, so that the report file
+      is always complete, even if the planner is killed while writing.
+    */
+    string tmp_filename = profile_filename + ".tmp";
+    {
+        ofstream out(tmp_filename);
+        if (!out) {
+            cerr << "Could not open profile file " << tmp_filename << endl;
+            utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        out << setprecision(9);
+        double ticks_per_second = get_ticks_per_second();
+        if (endswith(profile_filename, ".csv")) {
+            write_csv(out, ticks_per_second);
+        } else {
+            write_json(out, is_final, ticks_per_second);
+        }
+    }
+    if (rename(tmp_filename.c_str(), profile_filename.c_str()) != 0) {
+        cerr << "Could not write profile file " << profile_filename << endl;
+        utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+}
+
+void write_profile_snapshot_if_due() {
+    if (!g_profiling_enabled || snapshot_interval_in_seconds <= 0 ||
+        ++num_calls_since_snapshot_check < SNAPSHOT_CHECK_INTERVAL_CALLS) {
+        return;
+    }
+    num_calls_since_snapshot_check = 0;
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    if (now - last_snapshot_time < chrono::seconds(snapshot_interval_in_seconds)) {
+        return;
+    }
+    last_snapshot_time = now;
+    write_report(false);
+    ++num_snapshots;
+}
+
+void write_profile() {
+    if (g_profiling_enabled) {
+        write_report(true);
+        g_log << "Wrote profile to " << profile_filename << " ("
+              << num_snapshots << " snapshot(s) before)." << endl;
+    }
+}
+}
@@ -0,0 +1,103 @@
+#ifndef UTILS_PROFILING_H
+#define UTILS_PROFILING_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define UTILS_HAS_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define UTILS_HAS_TSC
+#endif
+
+/*
+  Built-in instrumentation for hot code paths. Plugins register profile
+  entries under their configuration string from the command line (e.g.,
+  "ff()") and a name for the measured code (e.g., "compute_result").
+  Entries with the same plugin and name are shared, so all instances of
+  a plugin with the same configuration are accumulated.
+
+  A ScopedProfileTimer adds the time stamp counter (TSC) ticks of its
+  scope and increments the count of its entry. add_profile_count() only
+  increments the count. Profiling is disabled by default, in which case
+  both only cost a test of g_profiling_enabled. It is enabled with the
+  command line option --profile FILENAME, which writes a report when the
+  search ends and, with --profile-interval SECONDS, snapshots during the
+  search. Filenames ending in ".csv" yield CSV files, all others JSON
+  files. TSC ticks are converted to seconds with the TSC frequency
+  measured while profiling is enabled. Timers are inclusive, e.g., the
+  time for inserting a state into an open list contains the time for
+  evaluating it.
+
+  Entries are not synchronized, so the results for code that is executed
+  by multiple threads concurrently are unreliable.
+*/
+
+namespace utils {
+struct ProfileEntry {
+    const std::string plugin;
+    const std::string name;
+    std::uint64_t count;
+    std::uint64_t ticks;
+
+    ProfileEntry(const std::string &plugin, const std::string &name)
+        : plugin(plugin), name(name), count(0), ticks(0) {
+    }
+};
+
+extern bool g_profiling_enabled;
+
+inline std::uint64_t read_time_stamp_counter() {
+#ifdef UTILS_HAS_TSC
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// The returned entry lives until the end of the program.
+extern ProfileEntry *register_profile_entry(
+    const std::string &plugin, const std::string &name);
+
+class ScopedProfileTimer {
+    ProfileEntry *entry;
+    std::uint64_t start_ticks;
+public:
+    explicit ScopedProfileTimer(ProfileEntry *entry_)
+        : entry(g_profiling_enabled ? entry_ : nullptr),
+          start_ticks(entry ? read_time_stamp_counter() : 0) {
+    }
+
+    ~ScopedProfileTimer() {
+        if (entry) {
+            entry->ticks += read_time_stamp_counter() - start_ticks;
+            ++entry->count;
+        }
+    }
+
+    ScopedProfileTimer(const ScopedProfileTimer &) = delete;
+    ScopedProfileTimer &operator=(const ScopedProfileTimer &) = delete;
+};
+
+inline void add_profile_count(ProfileEntry *entry, std::uint64_t count = 1) {
+    if (g_profiling_enabled) {
+        entry->count += count;
+    }
+}
+
+/*
+  Write reports to the given file. With interval_in_seconds > 0,
+  write_profile_snapshot_if_due() writes a report at most every
+  interval_in_seconds seconds.
+*/
+extern void enable_profiling(const std::string &filename, int interval_in_seconds);
+// Called by the search engines after each step.
+extern void write_profile_snapshot_if_due();
+extern void write_profile();
+}
+
+#endif
@@ -0,0 +1,294 @@
+#include "segment_allocator.h"
+
+#include "logging.h"
+#include "memory.h"
+#include "system.h"
+
+#include "../options/option_parser.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#if OPERATING_SYSTEM != WINDOWS
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if OPERATING_SYSTEM == LINUX
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace std;
+
+namespace utils {
+static const size_t SEGMENT_ALIGNMENT = 64;
+static const size_t MIN_CHUNK_BYTES = 2 << 20;
+static const size_t MAX_CHUNK_BYTES = 1 << 30;
+
+static size_t round_up(size_t num_bytes, size_t alignment) {
+    return (num_bytes + alignment - 1) / alignment * alignment;
+}
+
+SegmentMemory::SegmentMemory()
+    : num_segments(0),
+      num_segment_bytes(0) {
+}
+
+void *SegmentMemory::allocate(size_t num_bytes) {
+    void *segment = allocate_segment(num_bytes);
+    ++num_segments;
+    num_segment_bytes += num_bytes;
+    return segment;
+}
+
+void SegmentMemory::deallocate(void *segment, size_t num_bytes) {
+    deallocate_segment(segment, num_bytes);
+    --num_segments;
+    num_segment_bytes -= num_bytes;
+}
+
+void SegmentMemory::print_details(LogProxy &) const {
+}
+
+void SegmentMemory::print_statistics(LogProxy &log) const {
+    log << "Segments: " << num_segments << " ("
+        << num_segment_bytes / 1024 << " KB)" << endl;
+    print_details(log);
+    log << "Resident memory: " << get_current_memory_in_kb() << " KB" << endl;
+}
+
+
+void *StandardSegmentMemory::allocate_segment(size_t num_bytes) {
+    return ::operator new(num_bytes);
+}
+
+void StandardSegmentMemory::deallocate_segment(void *segment, size_t) {
+    ::operator delete(segment);
+}
+
+
+struct MappedSegmentMemory::Impl {
+    const HugePages huge_pages;
+    const bool prefault;
+    const bool numa_local;
+
+    mutex chunk_mutex;
+    vector<pair<char *, size_t>> chunks;
+    char *current;
+    size_t remaining;
+    size_t next_chunk_bytes;
+    size_t mapped_bytes;
+    int num_huge_page_chunks;
+    bool explicit_huge_pages_failed;
+    bool numa_policy_failed;
+    unordered_map<size_t, vector<void *>> free_segments;
+
+    Impl(HugePages huge_pages, bool prefault, bool numa_local)
+        : huge_pages(huge_pages),
+          prefault(prefault),
+          numa_local(numa_local),
+          current(nullptr),
+          remaining(0),
+          next_chunk_bytes(MIN_CHUNK_BYTES),
+          mapped_bytes(0),
+          num_huge_page_chunks(0),
+          explicit_huge_pages_failed(false),
+          numa_policy_failed(false) {
+    }
+
+    ~Impl() {
+        for (const auto &chunk : chunks) {
+            unmap_chunk(chunk.first, chunk.second);
+        }
+    }
+
+    char *map_chunk(size_t num_bytes);
+    void unmap_chunk(char *chunk, size_t num_bytes);
+    void add_chunk(size_t min_bytes);
+};
+
+char *MappedSegmentMemory::Impl::map_chunk(size_t num_bytes) {
+#if OPERATING_SYSTEM == WINDOWS
+    return static_cast<char *>(::operator new(num_bytes));
+#else
+    const int protection = PROT_READ | PROT_WRITE;
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    void *chunk = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (huge_pages == HugePages::EXPLICIT && !explicit_huge_pages_failed) {
+        chunk = mmap(nullptr, num_bytes, protection, flags | MAP_HUGETLB, -1, 0);
+        if (chunk == MAP_FAILED) {
+            g_log << "Warning: could not map explicit huge pages, "
+                  << "falling back to transparent huge pages." << endl;
+            explicit_huge_pages_failed = true;
+        } else {
+            ++num_huge_page_chunks;
+        }
+    }
+#endif
+    const bool use_explicit_huge_pages = (chunk != MAP_FAILED);
+    while (chunk == MAP_FAILED) {
+        chunk = mmap(nullptr, num_bytes, protection, flags, -1, 0);
+        if (chunk == MAP_FAILED) {
+            // Behave like operator new, which lets the new handler react.
+            new_handler handler = get_new_handler();
+            if (!handler) {
+                throw bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    if (!use_explicit_huge_pages) {
+#if defined(MADV_HUGEPAGE) && defined(MADV_NOHUGEPAGE)
+        int advice = (huge_pages == HugePages::NONE) ? MADV_NOHUGEPAGE : MADV_HUGEPAGE;
+        if (madvise(chunk, num_bytes, advice) == 0 && huge_pages != HugePages::NONE) {
+            ++num_huge_page_chunks;
+        }
+#endif
+    }
+
+#if OPERATING_SYSTEM == LINUX && defined(SYS_mbind)
+    if (numa_local && !numa_policy_failed) {
+        if (syscall(SYS_mbind, chunk, num_bytes, MPOL_LOCAL, nullptr, 0, 0) != 0) {
+            g_log << "Warning: could not set NUMA policy for segment memory."
+                  << endl;
+            numa_policy_failed = true;
+        }
+    }
+#endif
+
+    if (prefault) {
+        const size_t page_size = sysconf(_SC_PAGESIZE);
+        volatile char *bytes = static_cast<char *>(chunk);
+        for (size_t offset = 0; offset < num_bytes; offset += page_size) {
+            bytes[offset] = 0;
+        }
+    }
+    return static_cast<char *>(chunk);
+#endif
+}
+
+void MappedSegmentMemory::Impl::unmap_chunk(char *chunk, size_t num_bytes) {
+#if OPERATING_SYSTEM == WINDOWS
+    utils::unused_variable(num_bytes);
+    ::operator delete(chunk);
+#else
+    munmap(chunk, num_bytes);
+#endif
+}
+
+void MappedSegmentMemory::Impl::add_chunk(size_t min_bytes) {
+    size_t num_bytes = max(next_chunk_bytes, round_up(min_bytes, MIN_CHUNK_BYTES));
+    current = map_chunk(num_bytes);
+    remaining = num_bytes;
+    chunks.emplace_back(current, num_bytes);
+    mapped_bytes += num_bytes;
+    next_chunk_bytes = min(2 * next_chunk_bytes, MAX_CHUNK_BYTES);
+}
+
+MappedSegmentMemory::MappedSegmentMemory(
+    HugePages huge_pages, bool prefault, bool numa_local)
+    : impl(make_unique_ptr<Impl>(huge_pages, prefault, numa_local)) {
+}
+
+MappedSegmentMemory::~MappedSegmentMemory() {
+}
+
+void *MappedSegmentMemory::allocate_segment(size_t num_bytes) {
+    num_bytes = round_up(num_bytes, SEGMENT_ALIGNMENT);
+    lock_guard<mutex> lock(impl->chunk_mutex);
+    auto it = impl->free_segments.find(num_bytes);
+    if (it != impl->free_segments.end() && !it->second.empty()) {
+        void *segment = it->second.back();
+        it->second.pop_back();
+        return segment;
+    }
+    if (impl->remaining < num_bytes) {
+        // The rest of the current chunk is wasted, but it's small.
+        impl->add_chunk(num_bytes);
+    }
+    void *segment = impl->current;
+    impl->current += num_bytes;
+    impl->remaining -= num_bytes;
+    return segment;
+}
+
+void MappedSegmentMemory::deallocate_segment(void *segment, size_t num_bytes) {
+    num_bytes = round_up(num_bytes, SEGMENT_ALIGNMENT);
+    lock_guard<mutex> lock(impl->chunk_mutex);
+    impl->free_segments[num_bytes].push_back(segment);
+}
+
+void MappedSegmentMemory::print_details(LogProxy &log) const {
+    lock_guard<mutex> lock(impl->chunk_mutex);
+    size_t free_bytes = 0;
+    for (const auto &entry : impl->free_segments) {
+        free_bytes += entry.first * entry.second.size();
+    }
+    log << "Mapped segment memory: " << impl->mapped_bytes / 1024 << " KB in "
+        << impl->chunks.size() << " chunk(s), "
+        << impl->num_huge_page_chunks << " with huge pages requested" << endl;
+    log << "Free segment memory: " << free_bytes / 1024 << " KB" << endl;
+}
+
+
+static shared_ptr<SegmentMemory> &get_default_segment_memory_reference() {
+    static shared_ptr<SegmentMemory> memory = make_shared<StandardSegmentMemory>();
+    return memory;
+}
+
+static mutex default_segment_memory_mutex;
+
+shared_ptr<SegmentMemory> get_default_segment_memory() {
+    lock_guard<mutex> lock(default_segment_memory_mutex);
+    return get_default_segment_memory_reference();
+}
+
+void set_default_segment_memory(const shared_ptr<SegmentMemory> &memory) {
+    lock_guard<mutex> lock(default_segment_memory_mutex);
+    get_default_segment_memory_reference() = memory;
+}
+
+void add_segment_memory_options_to_parser(options::OptionParser &parser) {
+    parser.add_option<bool>(
+        "mapped_segments",
+        "store states and per-state information in large memory-mapped "
+        "chunks instead of allocating each segment separately. The chunks "
+        "grow up to 1 GiB and count fully toward the memory limit of the "
+        "driver (which limits the address space) once they are mapped",
+        "false");
+    parser.add_enum_option<HugePages>(
+        "huge_pages",
+        {"NONE", "TRANSPARENT", "EXPLICIT"},
+        "huge pages for mapped segments (only used with mapped_segments=true)",
+        "TRANSPARENT",
+        {"use regular pages",
+         "advise the kernel to use transparent huge pages",
+         "use explicitly reserved huge pages (see /proc/sys/vm/nr_hugepages) "
+         "and fall back to transparent huge pages if none are available"});
+    parser.add_option<bool>(
+        "prefault_segments",
+        "touch the pages of mapped chunks when creating them (only used "
+        "with mapped_segments=true)",
+        "false");
+    parser.add_option<bool>(
+        "numa_local_segments",
+        "place mapped chunks on the NUMA node of the allocating thread "
+        "(only used with mapped_segments=true)",
+        "false");
+}
+
+shared_ptr<SegmentMemory> parse_segment_memory(const options::Options &opts) {
+    if (opts.get<bool>("mapped_segments")) {
+        return make_shared<MappedSegmentMemory>(
+            opts.get<HugePages>("huge_pages"),
+            opts.get<bool>("prefault_segments"),
+            opts.get<bool>("numa_local_segments"));
+    }
+    return make_shared<StandardSegmentMemory>();
+}
+}
@@ -0,0 +1,167 @@
+#ifndef UTILS_SEGMENT_ALLOCATOR_H
+#define UTILS_SEGMENT_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace utils {
+class LogProxy;
+
+/*
+  Source of the memory for the segments of SegmentedVector and
+  SegmentedArrayVector, which store the states of the state registry and
+  all per-state information. Implementations must be thread-safe.
+*/
+class SegmentMemory {
+    std::atomic<long long> num_segments;
+    std::atomic<long long> num_segment_bytes;
+
+    virtual void *allocate_segment(std::size_t num_bytes) = 0;
+    virtual void deallocate_segment(void *segment, std::size_t num_bytes) = 0;
+    virtual void print_details(LogProxy &log) const;
+public:
+    SegmentMemory();
+    virtual ~SegmentMemory() = default;
+
+    void *allocate(std::size_t num_bytes);
+    void deallocate(void *segment, std::size_t num_bytes);
+
+    // Print the live segments and the resident set size of the process.
+    void print_statistics(LogProxy &log) const;
+};
+
+// Allocate segments individually with operator new.
+class StandardSegmentMemory : public SegmentMemory {
+    virtual void *allocate_segment(std::size_t num_bytes) override;
+    virtual void deallocate_segment(void *segment, std::size_t num_bytes) override;
+};
+
+enum class HugePages {
+    NONE,
+    TRANSPARENT,
+    EXPLICIT
+};
+
+/*
+  Carve segments out of large chunks obtained with mmap. Chunks are
+  multiples of the huge page size and grow geometrically, so that the
+  kernel can back them with transparent huge pages (madvise) or explicit
+  huge pages (MAP_HUGETLB, which requires reserved huge pages and falls
+  back to transparent huge pages otherwise). This reduces TLB misses for
+  large state registries.
+
+  With prefault=true, we touch all pages of a chunk when mapping it,
+  which moves the page faults out of the search loop. With
+  numa_local=true, we ask the kernel to place the chunks on the NUMA node
+  of the allocating thread regardless of the process-wide policy.
+
+  Freed segments are kept in free lists by size and reused. Chunks are
+  only returned to the operating system when the object is destroyed.
+
+  Chunks grow up to 1 GiB and the whole chunk counts toward the address
+  space limit (RLIMIT_AS) set by the driver's memory limit as soon as it
+  is mapped, even if most of its pages have never been touched. Under a
+  tight limit, the search can therefore run out of memory earlier than
+  with StandardSegmentMemory.
+  On systems without mmap, this class behaves like StandardSegmentMemory.
+*/
+class MappedSegmentMemory : public SegmentMemory {
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+
+    virtual void *allocate_segment(std::size_t num_bytes) override;
+    virtual void deallocate_segment(void *segment, std::size_t num_bytes) override;
+    virtual void print_details(LogProxy &log) const override;
+public:
+    MappedSegmentMemory(HugePages huge_pages, bool prefault, bool numa_local);
+    virtual ~MappedSegmentMemory() override;
+};
+
+/*
+  The segment memory used by segment allocators that are created without
+  an explicit SegmentMemory. Containers keep the memory they were created
+  with, so changing it only affects containers created afterwards.
+*/
+extern std::shared_ptr<SegmentMemory> get_default_segment_memory();
+extern void set_default_segment_memory(const std::shared_ptr<SegmentMemory> &memory);
+
+/*
+  Allocator that gets its memory from a SegmentMemory object. It is the
+  default allocator of SegmentedVector and SegmentedArrayVector.
+*/
+template<typename T>
+class SegmentAllocator {
+    std::shared_ptr<SegmentMemory> memory;
+
+    template<typename U>
+    friend class SegmentAllocator;
+public:
+    using value_type = T;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using reference = T &;
+    using const_reference = const T &;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    template<typename U>
+    struct rebind {
+        using other = SegmentAllocator<U>;
+    };
+
+    SegmentAllocator()
+        : memory(get_default_segment_memory()) {
+    }
+
+    explicit SegmentAllocator(const std::shared_ptr<SegmentMemory> &memory)
+        : memory(memory) {
+    }
+
+    template<typename U>
+    SegmentAllocator(const SegmentAllocator<U> &other)
+        : memory(other.memory) {
+    }
+
+    T *allocate(std::size_t n) {
+        return static_cast<T *>(memory->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n) {
+        memory->deallocate(p, n * sizeof(T));
+    }
+
+    template<typename U, typename ... Args>
+    void construct(U *p, Args && ... args) {
+        ::new(static_cast<void *>(p))U(std::forward<Args>(args) ...);
+    }
+
+    template<typename U>
+    void destroy(U *p) {
+        p->~U();
+    }
+
+    template<typename U>
+    bool operator==(const SegmentAllocator<U> &other) const {
+        return memory == other.memory;
+    }
+
+    template<typename U>
+    bool operator!=(const SegmentAllocator<U> &other) const {
+        return memory != other.memory;
+    }
+};
+
+extern void add_segment_memory_options_to_parser(options::OptionParser &parser);
+extern std::shared_ptr<SegmentMemory> parse_segment_memory(
+    const options::Options &opts);
+}
+
+#endif
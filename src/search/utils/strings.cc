@@ -36,6 +36,11 @@ bool startswith(const string &s, const string &prefix) {
     return s.compare(0, prefix.size(), prefix) == 0;
 }
 
+bool endswith(const string &s, const string &suffix) {
+    return s.size() >= suffix.size() &&
+           s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
 pair<string, string> split(const string &s, const string &separator) {
     int split_pos = s.find(separator);
     if (split_pos == -1) {
@@ -27,6 +27,7 @@ extern std::pair<std::string, std::string> split(
     const std::string &s, const std::string &separator);
 
 extern bool startswith(const std::string &s, const std::string &prefix);
+extern bool endswith(const std::string &s, const std::string &suffix);
 
 template<typename Collection>
 std::string join(const Collection &collection, const std::string &delimiter) {
@@ -1,10 +1,23 @@
 #include "system.h"
 
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+
+#if OPERATING_SYSTEM != WINDOWS
+#include <unistd.h>
+#endif
 
 using namespace std;
 
 namespace utils {
+/*
+  Signal handlers may only read the table, so we use a fixed-size array of
+  C strings instead of a container that reallocates.
+*/
+static const int MAX_TEMPORARY_FILES = 1024;
+static char *temporary_files[MAX_TEMPORARY_FILES] = {};
+
 const char *get_exit_code_message_reentrant(ExitCode exitcode) {
     switch (exitcode) {
     case ExitCode::SUCCESS:
@@ -44,7 +57,47 @@ bool is_exit_code_error_reentrant(ExitCode exitcode) {
     }
 }
 
+void register_temporary_file(const string &filename) {
+    for (char *&slot : temporary_files) {
+        if (!slot) {
+            char *copy = static_cast<char *>(malloc(filename.size() + 1));
+            if (!copy) {
+                exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+            }
+            memcpy(copy, filename.c_str(), filename.size() + 1);
+            slot = copy;
+            return;
+        }
+    }
+    cerr << "Too many temporary files." << endl;
+    exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+}
+
+void unregister_temporary_file(const string &filename) {
+    for (char *&slot : temporary_files) {
+        if (slot && filename == slot) {
+            char *old_slot = slot;
+            slot = nullptr;
+            free(old_slot);
+            return;
+        }
+    }
+}
+
+void remove_temporary_files_reentrant() {
+    for (char *filename : temporary_files) {
+        if (filename) {
+#if OPERATING_SYSTEM == WINDOWS
+            remove(filename);
+#else
+            unlink(filename);
+#endif
+        }
+    }
+}
+
 void exit_with(ExitCode exitcode) {
+    remove_temporary_files_reentrant();
     report_exit_code_reentrant(exitcode);
     exit(static_cast<int>(exitcode));
 }
@@ -54,6 +107,7 @@ void exit_after_receiving_signal(ExitCode exitcode) {
       In signal handlers, we have to use the "safe function" _Exit() rather
       than the unsafe function exit().
     */
+    remove_temporary_files_reentrant();
     report_exit_code_reentrant(exitcode);
     _Exit(static_cast<int>(exitcode));
 }
@@ -20,6 +20,7 @@
 
 #include <iostream>
 #include <stdlib.h>
+#include <string>
 
 #define ABORT(msg) \
     ( \
@@ -57,11 +58,27 @@ NO_RETURN extern void exit_with(ExitCode returncode);
 NO_RETURN extern void exit_after_receiving_signal(ExitCode returncode);
 
 int get_peak_memory_in_kb();
+// Resident set size of the process.
+int get_current_memory_in_kb();
+// Address space of the process, which the driver limits.
+int get_address_space_in_kb();
+// Limit of the address space, or -1 if it is unlimited.
+long long get_address_space_limit_in_kb();
 const char *get_exit_code_message_reentrant(ExitCode exitcode);
 bool is_exit_code_error_reentrant(ExitCode exitcode);
 void register_event_handlers();
 void report_exit_code_reentrant(ExitCode exitcode);
 int get_process_id();
+
+/*
+  Registered temporary files are removed when the planner terminates with
+  exit_with() or because of a signal (e.g., when hitting the time limit),
+  where the destructors of their owners don't run. Owners still have to
+  remove their files in the regular case and unregister them afterwards.
+*/
+void register_temporary_file(const std::string &filename);
+void unregister_temporary_file(const std::string &filename);
+void remove_temporary_files_reentrant();
 }
 
 #endif
@@ -33,6 +33,7 @@
 #include <limits>
 #include <new>
 #include <stdlib.h>
+#include <sys/resource.h>
 #include <unistd.h>
 
 #if OPERATING_SYSTEM == OSX
@@ -171,6 +172,7 @@ void signal_handler(int signal_number) {
     write_reentrant_str(STDOUT_FILENO, "caught signal ");
     write_reentrant_int(STDOUT_FILENO, signal_number);
     write_reentrant_str(STDOUT_FILENO, " -- exiting\n");
+    remove_temporary_files_reentrant();
     if (signal_number == SIGXCPU) {
         exit_after_receiving_signal(ExitCode::SEARCH_OUT_OF_TIME);
     }
@@ -183,6 +185,25 @@ void signal_handler(int signal_number) {
         print_peak_memory_in_kb_reentrant() is used in signal handlers.
         The latter is slower but guarantees reentrancy.
 */
+static int read_memory_field_in_kb(const string &field) {
+    int memory_in_kb = -1;
+    ifstream procfile;
+    procfile.open("/proc/self/status");
+    string word;
+    while (procfile.good()) {
+        procfile >> word;
+        if (word == field) {
+            procfile >> memory_in_kb;
+            break;
+        }
+        // Skip to end of line.
+        procfile.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    if (procfile.fail())
+        memory_in_kb = -1;
+    return memory_in_kb;
+}
+
 int get_peak_memory_in_kb() {
     // On error, produces a warning on cerr and returns -1.
     int memory_in_kb = -1;
@@ -198,20 +219,7 @@ int get_peak_memory_in_kb() {
         memory_in_kb = t_info.virtual_size / 1024;
     }
 #else
-    ifstream procfile;
-    procfile.open("/proc/self/status");
-    string word;
-    while (procfile.good()) {
-        procfile >> word;
-        if (word == "VmPeak:") {
-            procfile >> memory_in_kb;
-            break;
-        }
-        // Skip to end of line.
-        procfile.ignore(numeric_limits<streamsize>::max(), '\n');
-    }
-    if (procfile.fail())
-        memory_in_kb = -1;
+    memory_in_kb = read_memory_field_in_kb("VmPeak:");
 #endif
 
     if (memory_in_kb == -1)
@@ -219,6 +227,58 @@ int get_peak_memory_in_kb() {
     return memory_in_kb;
 }
 
+int get_current_memory_in_kb() {
+    // On error, produces a warning on cerr and returns -1.
+    int memory_in_kb = -1;
+
+#if OPERATING_SYSTEM == OSX
+    task_basic_info t_info;
+    mach_msg_type_number_t t_info_count = TASK_BASIC_INFO_COUNT;
+
+    if (task_info(mach_task_self(), TASK_BASIC_INFO,
+                  reinterpret_cast<task_info_t>(&t_info),
+                  &t_info_count) == KERN_SUCCESS) {
+        memory_in_kb = t_info.resident_size / 1024;
+    }
+#else
+    memory_in_kb = read_memory_field_in_kb("VmRSS:");
+#endif
+
+    if (memory_in_kb == -1)
+        cerr << "warning: could not determine resident memory" << endl;
+    return memory_in_kb;
+}
+
+int get_address_space_in_kb() {
+    // On error, produces a warning on cerr and returns -1.
+    int memory_in_kb = -1;
+
+#if OPERATING_SYSTEM == OSX
+    task_basic_info t_info;
+    mach_msg_type_number_t t_info_count = TASK_BASIC_INFO_COUNT;
+
+    if (task_info(mach_task_self(), TASK_BASIC_INFO,
+                  reinterpret_cast<task_info_t>(&t_info),
+                  &t_info_count) == KERN_SUCCESS) {
+        memory_in_kb = t_info.virtual_size / 1024;
+    }
+#else
+    memory_in_kb = read_memory_field_in_kb("VmSize:");
+#endif
+
+    if (memory_in_kb == -1)
+        cerr << "warning: could not determine address space" << endl;
+    return memory_in_kb;
+}
+
+long long get_address_space_limit_in_kb() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_AS, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY) {
+        return -1;
+    }
+    return static_cast<long long>(limit.rlim_cur / 1024);
+}
+
 void register_event_handlers() {
     // Terminate when running out of memory.
     set_new_handler(out_of_memory_handler);
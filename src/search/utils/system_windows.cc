@@ -23,6 +23,7 @@ void signal_handler(int signal_number) {
          << get_peak_memory_in_kb() << " KB" << endl;
     cout << "caught signal " << signal_number
          << " -- exiting" << endl;
+    remove_temporary_files_reentrant();
     raise(signal_number);
 }
 
@@ -39,6 +40,37 @@ int get_peak_memory_in_kb() {
     return pmc.PeakPagefileUsage / 1024;
 }
 
+int get_current_memory_in_kb() {
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    bool success = GetProcessMemoryInfo(
+        GetCurrentProcess(),
+        reinterpret_cast<PROCESS_MEMORY_COUNTERS *>(&pmc),
+        sizeof(pmc));
+    if (!success) {
+        cerr << "warning: could not determine resident memory" << endl;
+        return -1;
+    }
+    return pmc.WorkingSetSize / 1024;
+}
+
+int get_address_space_in_kb() {
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    bool success = GetProcessMemoryInfo(
+        GetCurrentProcess(),
+        reinterpret_cast<PROCESS_MEMORY_COUNTERS *>(&pmc),
+        sizeof(pmc));
+    if (!success) {
+        cerr << "warning: could not determine address space" << endl;
+        return -1;
+    }
+    return pmc.PagefileUsage / 1024;
+}
+
+long long get_address_space_limit_in_kb() {
+    // The driver doesn't limit the memory on Windows.
+    return -1;
+}
+
 void register_event_handlers() {
     // Terminate when running out of memory.
     set_new_handler(out_of_memory_handler);
@@ -28,6 +28,11 @@ def parse_args():
     argparser.add_argument(
         "--sas-file", default="output.sas",
         help="path to the SAS output file (default: %(default)s)")
+    argparser.add_argument(
+        "--binary-sas", action="store_true",
+        help="write the SAS output file in a compact binary format, which "
+        "preprocess-h2 and the search component read faster than the "
+        "textual format")
     argparser.add_argument(
         "--invariant-generation-max-time", default=300, type=int,
         help="max time for invariant generation (default: %(default)ds)")
@@ -1,4 +1,5 @@
 SAS_FILE_VERSION = 3
+BINARY_SAS_MAGIC = b"\0SAS"
 
 DEBUG = False
 
@@ -95,6 +96,46 @@ class SASTask:
         for axiom in self.axioms:
             axiom.output(stream)
 
+    def output_binary(self, stream):
+        """Write the task in the binary format read by preprocess-h2 and
+        the search component: after BINARY_SAS_MAGIC, the file contains the
+        same sequence of values as the textual format without the magic
+        words. Integers are zigzag-encoded base-128 varints and strings
+        are stored as their length followed by their UTF-8 bytes."""
+        writer = BinaryWriter(stream)
+        stream.write(BINARY_SAS_MAGIC)
+        writer.write_int(SAS_FILE_VERSION)
+        writer.write_int(int(self.metric))
+        variables = self.variables
+        writer.write_int(len(variables.ranges))
+        for var, (rang, axiom_layer, values) in enumerate(zip(
+                variables.ranges, variables.axiom_layers,
+                variables.value_names)):
+            writer.write_string("var%d" % var)
+            writer.write_ints([axiom_layer, rang])
+            for value in values:
+                writer.write_string(value)
+        writer.write_int(len(self.mutexes))
+        for mutex in self.mutexes:
+            writer.write_facts(mutex.facts)
+        writer.write_ints(self.init.values)
+        writer.write_facts(self.goal.pairs)
+        writer.write_int(len(self.operators))
+        for op in self.operators:
+            writer.write_string(op.name[1:-1])
+            writer.write_facts(op.prevail)
+            writer.write_int(len(op.pre_post))
+            for var, pre, post, cond in op.pre_post:
+                writer.write_facts(cond)
+                writer.write_ints([var, pre, post])
+            writer.write_int(op.cost)
+        writer.write_int(len(self.axioms))
+        for axiom in self.axioms:
+            writer.write_facts(axiom.condition)
+            var, val = axiom.effect
+            writer.write_ints([var, 1 - val, val])
+        writer.flush()
+
     def get_encoding_size(self):
         task_size = 0
         task_size += self.variables.get_encoding_size()
@@ -108,6 +149,40 @@ class SASTask:
         return task_size
 
 
+class BinaryWriter:
+    def __init__(self, stream):
+        self.stream = stream
+        self.buffer = bytearray()
+
+    def write_int(self, value):
+        code = (value << 1) ^ (value >> 63)  # zigzag encoding
+        while code >= 0x80:
+            self.buffer.append((code & 0x7f) | 0x80)
+            code >>= 7
+        self.buffer.append(code)
+        if len(self.buffer) >= 1 << 16:
+            self.flush()
+
+    def write_ints(self, values):
+        for value in values:
+            self.write_int(value)
+
+    def write_facts(self, facts):
+        self.write_int(len(facts))
+        for var, val in facts:
+            self.write_int(var)
+            self.write_int(val)
+
+    def write_string(self, string):
+        data = string.encode("utf-8")
+        self.write_int(len(data))
+        self.buffer.extend(data)
+
+    def flush(self):
+        self.stream.write(self.buffer)
+        self.buffer = bytearray()
+
+
 class SASVariables:
     def __init__(self, ranges, axiom_layers, value_names):
         self.ranges = ranges